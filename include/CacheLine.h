@@ -0,0 +1,17 @@
+#ifndef CACHE_LINE_H
+#define CACHE_LINE_H
+
+#include <cstddef>
+
+/**
+ * @brief Size (bytes) of a cache line.  Fields written by different threads
+ *        are aligned to it so a write by one thread does not invalidate the
+ *        line another thread is working on (false sharing).
+ *
+ *        std::hardware_destructive_interference_size is not used, its value
+ *        may differ between compilers and it warns when used in headers.
+ *
+ */
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+#endif
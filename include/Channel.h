@@ -0,0 +1,156 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <coroutine>
+#include <deque>
+#include <optional>
+#include <utility>
+
+#include "Executor.h"
+
+/**
+ * @brief Unbounded FIFO between processes of an Executor, the coroutine
+ *        counterpart of TLockedQueue.  A process awaiting Pop() on an empty
+ *        channel is suspended until an item is pushed, and receives items in
+ *        the order the processes started waiting.  Single threaded, needs
+ *        no lock.
+ *
+ * @tparam T Item type.
+ */
+template <typename T>
+class Channel
+{
+public:
+
+    /**
+     * @brief Awaitable that takes the front item, suspending the awaiting
+     *        process until there is one.
+     *
+     */
+    struct Receive
+    {
+        Channel&         channel;
+        std::optional<T> item;
+
+        bool await_ready()
+        {
+            if(channel._items.empty())
+                return false;
+            item = std::move(channel._items.front());
+            channel._items.pop_front();
+            return true;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) { channel._receivers.push_back({ handle, &item }); }
+        T await_resume() { return std::move(*item); }
+    };
+
+    /**
+     * @brief Construct a new Channel object.
+     *
+     * @param executor Executor of the processes using the channel.
+     */
+    explicit Channel(Executor& executor) : _executor(executor) { }
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    Channel(const Channel &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return Channel&
+     */
+    Channel &operator=(const Channel &) = delete;
+
+    /**
+     * @brief Destroy the Channel object.
+     *
+     */
+    virtual ~Channel() = default;
+
+    /**
+     * @brief Pushes an item, handing it straight to the first waiting
+     *        process (woken at the current time) when there is one.
+     *
+     * @param item Item to push.
+     */
+    void Push(T item);
+
+    /**
+     * @brief Takes the front item.  Use as co_await channel.Pop().
+     *
+     * @return Receive Awaitable returning the item.
+     */
+    Receive Pop() { return Receive{ *this, std::nullopt }; }
+
+    /**
+     * @brief Number of items waiting for a process.
+     *
+     * @return size_t Number of items.
+     */
+    size_t Size() const { return _items.size(); }
+
+    /**
+     * @brief Number of processes waiting for an item.
+     *
+     * @return size_t Number of processes.
+     */
+    size_t Receivers() const { return _receivers.size(); }
+
+private:
+
+    /**
+     * @brief Process waiting for an item and where the item goes.
+     *
+     */
+    struct Receiver
+    {
+        std::coroutine_handle<> handle;
+        std::optional<T>*       item;
+    };
+
+    /**
+     * @brief Executor of the processes using the channel.
+     *
+     */
+    Executor& _executor;
+
+    /**
+     * @brief Items waiting for a process.
+     *
+     */
+    std::deque<T> _items;
+
+    /**
+     * @brief Processes waiting for an item, first come first served.
+     *
+     */
+    std::deque<Receiver> _receivers;
+};
+
+/**
+ * @brief Pushes an item, handing it straight to the first waiting
+ *        process (woken at the current time) when there is one.
+ *
+ * @tparam T Item type.
+ * @param item Item to push.
+ */
+template <typename T>
+inline void Channel<T>::Push(T item)
+{
+    if(_receivers.empty())
+    {
+        _items.push_back(std::move(item));
+        return;
+    }
+
+    Receiver receiver = _receivers.front();
+    _receivers.pop_front();
+    *receiver.item = std::move(item);
+    _executor.Wake(receiver.handle);
+}
+
+#endif
@@ -1,11 +1,29 @@
 #ifndef CHARGER_H
 #define CHARGER_H
 
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iterator>
 #include <memory>
+#include <random>
 
+#include "Histogram.h"
 #include "Vehicle.h"
 #include "SimulationObject.h"
 
+/**
+ * @brief Period a charger is out of service, in simulation time since the
+ *        charger started.
+ * 
+ */
+struct ChargerOutage
+{
+    int64_t start_mins;     //!< Start of the outage (mins).
+    int64_t duration_mins;  //!< Length of the outage (mins).
+    bool    random;         //!< Drawn by EnableFailures(), the next failure is drawn when it ends.
+};
+
 /**
  * @brief Simulates a charger (consumer) running in a thread.
  * 
@@ -22,10 +40,12 @@ public:
      * @brief Construct a new Charger object
      * 
      * @param id Charger identification.
-     * @param charging_q Vehicle charging queue.
+     * @param site Site the charger is installed at.
+     * @param context State shared by all objects of the simulation.
      */
-    Charger(uint16_t   id, 
-            ChargingQ& charging_q);
+    Charger(uint16_t           id, 
+            Site&              site,
+            SimulationContext& context);
 
     /**
      * @brief Default Constructor (disabled).
@@ -52,6 +72,121 @@ public:
      */
     virtual ~Charger() = default;
 
+    //
+    // Charger
+    //
+
+    /**
+     * @brief Charges the current vehicle for the remainder of its RechargeTime().
+     * 
+     */
+    void ChargeAction();
+
+    /**
+     * @brief Takes the charger out of service for its next outage.  The
+     *        queue is redistributed when no charger of the site is left.
+     * 
+     * @return true  Simulation ended during the outage.
+     * @return false Charger is back in service.
+     */
+    bool OutageAction();
+
+    /**
+     * @brief Schedules an outage.  Must be called before the charger is
+     *        started.
+     * 
+     * @param start_mins Start of the outage (mins since the charger started).
+     * @param duration_mins Length of the outage (mins).
+     */
+    void ScheduleOutage(const int64_t start_mins, const int64_t duration_mins);
+
+    /**
+     * @brief Fails the charger at random, with exponentially distributed
+     *        times between failures and times to repair.  Must be called
+     *        before the charger is started.
+     * 
+     * @param mtbf_mins Mean time (mins) in service between failures.
+     * @param mttr_mins Mean time (mins) to repair.
+     * @param seed Seed of the charger's random number generator.
+     */
+    void EnableFailures(const double mtbf_mins, const double mttr_mins, const uint32_t seed);
+
+    /**
+     * @brief Checks to see if this charger is out of service.  Safe to 
+     *        call from any thread.
+     * 
+     * @return true  Charger is out of service.
+     * @return false Charger is in service.
+     */
+    bool Down() const { return _down.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of charges cut short by an outage.
+     * 
+     * @return uint64_t Number of charges.
+     */
+    uint64_t Interrupted() const { return _interrupted.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Vehicle currently being charged.
+     * 
+     * @return std::shared_ptr<Vehicle> Vehicle being charged, nullptr when idle.
+     */
+    std::shared_ptr<Vehicle> ChargingVehicle() const { return _vehicle; }
+
+    /**
+     * @brief Checks to see if this charger is charging a vehicle.  Safe to 
+     *        call from any thread.
+     * 
+     * @return true  Charger is charging a vehicle.
+     * @return false Charger is idle.
+     */
+    bool Busy() const { return _busy.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Id of this charger.
+     * 
+     * @return uint16_t Id of this charger.
+     */
+    uint16_t ID() const { return _id; }
+
+    /**
+     * @brief Site the charger is installed at.
+     * 
+     * @return Site& Site of this charger.
+     */
+    Site& Location() const { return _site; }
+
+    /**
+     * @brief Restores the state of this charger from a snapshot.  Must be
+     *        called before the charger is started.
+     * 
+     * @param vehicle Vehicle being charged, nullptr when idle.
+     */
+    void Restore(std::shared_ptr<Vehicle> vehicle);
+
+    //
+    // Properties
+    //
+
+    /**
+     * @brief Duration (ms) of each completed charge by this charger.
+     * 
+     */
+    Histogram ChargingLaps;
+
+    /**
+     * @brief Duration (ms) vehicles charged by this charger waited in the queue.
+     * 
+     */
+    Histogram QingLaps;
+
+    /**
+     * @brief Duration (ms) of each outage of this charger.
+     * 
+     */
+    Histogram OutageLaps;
+
     //
     // SimulationObject overrides
     //
@@ -84,6 +219,37 @@ protected:
      * @return const std::string Header used to uniquely identify charger.
      */
     virtual const std::string Header() override;
+
+    /**
+     * @brief Time (ms) until the next outage starts, 0 when it is due.
+     * 
+     * @return std::chrono::milliseconds Time until the outage, max() when none.
+     */
+    std::chrono::milliseconds UntilOutage() const;
+
+    /**
+     * @brief Draws the next random failure after a time.
+     * 
+     * @param after_mins Time (mins) the charger is back in service.
+     */
+    void DrawFailure(const int64_t after_mins);
+
+    /**
+     * @brief Adds an outage to those to come, after those starting at the 
+     *        same time.
+     * 
+     * @param outage Outage.
+     */
+    void AddOutage(const ChargerOutage& outage);
+
+    /**
+     * @brief Moves the vehicles waiting at this charger's site to the 
+     *        nearest site with a charger in service, in one lock of each
+     *        queue, as many as its queue has room for.  The rest wait here
+     *        for the repair.  Called with the FreezeLock held.
+     * 
+     */
+    void Redistribute();
     
     /**
      * @brief Header of this object.
@@ -98,10 +264,64 @@ protected:
     const uint16_t _id;
 
     /**
-     * @brief Vehicle charging queue.
+     * @brief Site the charger is installed at (its charging queue).
+     * 
+     */
+    Site& _site;
+
+    /**
+     * @brief Vehicle currently being charged (nullptr when idle).
+     * 
+     */
+    std::shared_ptr<Vehicle> _vehicle;
+
+    /**
+     * @brief Charger is charging a vehicle.
+     * 
+     */
+    std::atomic<bool> _busy;
+
+    /**
+     * @brief Charger is out of service.
+     * 
+     */
+    std::atomic<bool> _down;
+
+    /**
+     * @brief Number of charges cut short by an outage.
+     * 
+     */
+    std::atomic<uint64_t> _interrupted;
+
+    /**
+     * @brief Outages to come, ordered by start.
+     * 
+     */
+    std::deque<ChargerOutage> _outages;
+
+    /**
+     * @brief Mean time (mins) between random failures, 0 when disabled.
+     * 
+     */
+    double _mtbf_mins;
+
+    /**
+     * @brief Mean time (mins) to repair a random failure.
+     * 
+     */
+    double _mttr_mins;
+
+    /**
+     * @brief Random number generator of the failures.
+     * 
+     */
+    std::mt19937 _gen;
+
+    /**
+     * @brief Time the charger started, the outages are timed from.
      * 
      */
-    ChargingQ& _charging_q;
+    std::chrono::steady_clock::time_point _started;
 };
 
 #endif
\ No newline at end of file
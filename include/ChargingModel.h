@@ -0,0 +1,149 @@
+#ifndef CHARGING_MODEL_H
+#define CHARGING_MODEL_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Vehicle.h"
+
+/**
+ * @brief Predicted performance of one vehicle class.
+ *
+ */
+struct ClassEstimate
+{
+    std::string name;           //!< Name of vehicle class.
+    uint16_t    population;     //!< Number of vehicles of this class.
+    double      qing_mins;      //!< Mean time (mins) queued for a charger per charge.
+    double      cycle_mins;     //!< Mean time (mins) of one cruise, queue and charge cycle.
+    double      throughput;     //!< Charges per minute for the class.
+};
+
+/**
+ * @brief Predicted performance of a charger configuration.
+ *
+ */
+struct ChargingEstimate
+{
+    uint16_t                   num_chargers;    //!< Number of chargers.
+    double                     utilization;     //!< Fraction of time chargers are busy (0 - 1).
+    double                     queue_length;    //!< Mean number of vehicles queued for a charger.
+    unsigned                   iterations;      //!< Iterations until the solution converged.
+    std::vector<ClassEstimate> classes;         //!< Estimate for each vehicle class.
+};
+
+/**
+ * @brief Analytical model of the charging system, used to size chargers
+ *        without running a simulation.  Vehicles form a closed queueing
+ *        network: each vehicle cruises (a delay with no contention) then
+ *        charges at one of a pool of chargers (a multi-server FCFS queue).
+ *
+ *        The network is solved by Bard-Schweitzer approximate Mean Value
+ *        Analysis, with the charger pool replaced by Seidmann's equivalent
+ *        of a single server 1/c as long plus a pure delay of the remainder.
+ *        A solution costs microseconds, so the model is used to prune a
+ *        sweep before simulating the configurations that matter.
+ *
+ */
+class ChargingModel
+{
+public:
+
+    /**
+     * @brief Construct a new ChargingModel object.
+     *
+     * @param num_chargers Number of chargers.
+     * @throws std::invalid_argument No chargers.
+     */
+    explicit ChargingModel(const uint16_t num_chargers);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    ChargingModel() = delete;
+
+    /**
+     * @brief Destroy the ChargingModel object.
+     *
+     */
+    virtual ~ChargingModel() = default;
+
+    /**
+     * @brief Creates a model of a fleet, with one class for each vehicle type.
+     *
+     * @param vehicles Vehicles of the fleet.
+     * @param num_chargers Number of chargers.
+     * @return ChargingModel Model of the fleet.
+     */
+    static ChargingModel FromVehicles(const std::vector<std::shared_ptr<Vehicle>>& vehicles,
+                                      const uint16_t                               num_chargers);
+
+    /**
+     * @brief Adds a class of identical vehicles.
+     *
+     * @param name Name of vehicle class.
+     * @param population Number of vehicles of this class.
+     * @param cruise_mins Time (mins) cruising between charges.
+     * @param charge_mins Time (mins) to charge.
+     */
+    void AddClass(const std::string& name,
+                  const uint16_t     population,
+                  const double       cruise_mins,
+                  const double       charge_mins);
+
+    /**
+     * @brief Copy of this model with a different number of chargers.
+     *
+     * @param num_chargers Number of chargers.
+     * @return ChargingModel Model with num_chargers.
+     */
+    ChargingModel WithChargers(const uint16_t num_chargers) const;
+
+    /**
+     * @brief Solves the model.
+     *
+     * @param tolerance Largest change of any queue length between iterations
+     *                  at which the solution has converged.
+     * @param max_iterations Iterations after which the solution is returned
+     *                       even if it has not converged.
+     * @return ChargingEstimate Predicted performance.
+     */
+    ChargingEstimate Solve(const double tolerance = 1e-9, const unsigned max_iterations = 10000) const;
+
+    /**
+     * @brief Number of chargers.
+     *
+     * @return uint16_t Number of chargers.
+     */
+    uint16_t NumChargers() const { return _num_chargers; }
+
+private:
+
+    /**
+     * @brief Class of identical vehicles.
+     *
+     */
+    struct VehicleClass
+    {
+        std::string name;
+        uint16_t    population;
+        double      cruise_mins;
+        double      charge_mins;
+    };
+
+    /**
+     * @brief Number of chargers.
+     *
+     */
+    uint16_t _num_chargers;
+
+    /**
+     * @brief Vehicle classes.
+     *
+     */
+    std::vector<VehicleClass> _classes;
+};
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef COHORT_ENGINE_H
+#define COHORT_ENGINE_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "Simulation.h"
+#include "SimulationContext.h"
+#include "Topology.h"
+#include "Vehicle.h"
+#include "VehicleCohort.h"
+
+/**
+ * @brief Duration (ms) of a time step of the CohortEngine, 1/100 of a
+ *        simulated minute.
+ *
+ */
+constexpr int32_t COHORT_ENGINE_STEP_MS = 10;
+
+/**
+ * @brief Longest simulation time (ms) of a CohortEngine, the lanes of its
+ *        cohorts hold times in 32 bits (about 24 simulated days).
+ *
+ */
+constexpr int64_t COHORT_ENGINE_MAX_MS = INT32_MAX;
+
+/**
+ * @brief Runs the fleet of a Simulation in fixed time steps, the fleet split
+ *        into a VehicleCohort per thread.  Each step the threads advance
+ *        their cohorts to the end of the step in parallel, then the last
+ *        thread to finish queues the vehicles that landed, in the order they
+ *        landed, and hands them the chargers that are free.  A charge starts
+ *        when its charger freed or its vehicle landed, not at the end of the
+ *        step, so the step only delays when a transition is seen and the
+ *        totals are those of the event driven engines.
+ *        Vehicles fly full battery flights (no trips, unbounded queues), and
+ *        the same seed draws the same fleet as a Simulation.  Times are
+ *        32 bit, a run ends by COHORT_ENGINE_MAX_MS.
+ *
+ */
+class CohortEngine
+{
+public:
+
+    /**
+     * @brief Construct a new CohortEngine object.
+     *
+     * @param num_vehicles Number of vehicles.
+     * @param num_vehicle_types Number of vehicle types.
+     * @param num_chargers Number of chargers.
+     * @param num_sites Number of sites the vehicles and chargers are spread over.
+     * @param num_threads Number of threads (cohorts), 0 for one per core.
+     */
+    CohortEngine(const uint32_t       num_vehicles,
+                 const unsigned short num_vehicle_types,
+                 const unsigned short num_chargers,
+                 const unsigned short num_sites = 1,
+                 const unsigned       num_threads = 0);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    CohortEngine() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    CohortEngine(const CohortEngine &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return CohortEngine&
+     */
+    CohortEngine &operator=(const CohortEngine &) = delete;
+
+    /**
+     * @brief Destroy the CohortEngine object.
+     *
+     */
+    virtual ~CohortEngine() = default;
+
+    /**
+     * @brief Seeds the random number generator, so a run can be repeated.
+     *        Must be called before Create().
+     *
+     * @param seed Seed of the random number generator.
+     */
+    void Seed(const uint32_t seed);
+
+    /**
+     * @brief Creates random vehicles, a lane of a cohort each, and the
+     *        chargers of each site.
+     *
+     * @return size_t Number of vehicles.
+     */
+    size_t Create();
+
+    /**
+     * @brief Runs the simulation for a further sim_time_secs.
+     *
+     * @param sim_time_secs Duration (seconds) to run, one simulated minute each.
+     * @return size_t Number of transitions of the vehicles.
+     * @throws std::invalid_argument The run would end past COHORT_ENGINE_MAX_MS.
+     */
+    size_t Run(const int64_t sim_time_secs);
+
+    /**
+     * @brief Simulation time run so far.
+     *
+     * @return int64_t Simulation time (ms).
+     */
+    int64_t Clock() const { return _clock_ms; }
+
+    /**
+     * @brief Number of threads (cohorts).
+     *
+     * @return unsigned Number of threads.
+     */
+    unsigned Threads() const { return unsigned(_cohorts.size()); }
+
+    /**
+     * @brief Number of vehicles waiting for a charger at every site.
+     *
+     * @return size_t Number of vehicles waiting.
+     */
+    size_t QueueLength() const;
+
+    /**
+     * @brief Calculates the results for each vehicle type (VehicleA,
+     *        VehicleB, ...), the same as Simulation does.
+     *
+     * @param sim_time_secs Duration (seconds) the simulation ran.
+     * @return std::vector<VehicleTypeMetrics> Results of each type, by name.
+     */
+    std::vector<VehicleTypeMetrics> MetricsForEachVehicleType(const int64_t sim_time_secs) const;
+
+private:
+
+    /**
+     * @brief Serial part of a step, run by the last thread to reach the end
+     *        of the step: queues the vehicles that landed at their charging
+     *        site and starts the charges due by the end of the step.
+     *
+     * @param now_ms Simulation time (ms) of the end of the step.
+     */
+    void AssignChargers(const int32_t now_ms);
+
+    /**
+     * @brief Cohort of a vehicle.
+     *
+     * @param id Id of the vehicle.
+     * @return size_t Cohort.
+     */
+    size_t CohortOf(const uint32_t id) const { return id / _lanes_per_cohort; }
+
+    /**
+     * @brief Number of chargers.
+     *
+     */
+    const unsigned short _num_chargers;
+
+    /**
+     * @brief Number of vehicles.
+     *
+     */
+    const uint32_t _num_vehicles;
+
+    /**
+     * @brief Number of vehicle types.
+     *
+     */
+    const unsigned short _num_vehicle_types;
+
+    /**
+     * @brief Number of threads (cohorts).
+     *
+     */
+    const unsigned _num_threads;
+
+    /**
+     * @brief State shared by the prototype vehicles (never started).
+     *
+     */
+    SimulationContext _context;
+
+    /**
+     * @brief Random number generator drawing the vehicle types.
+     *
+     */
+    std::mt19937 _gen;
+
+    /**
+     * @brief Sites and the routes flown between them.
+     *
+     */
+    Topology _topology;
+
+    /**
+     * @brief A vehicle of each type, holding the type's parameters.
+     *
+     */
+    std::vector<std::shared_ptr<Vehicle>> _prototypes;
+
+    /**
+     * @brief Type of each vehicle.
+     *
+     */
+    std::vector<uint16_t> _types;
+
+    /**
+     * @brief Site each vehicle is at, or took off from.
+     *
+     */
+    std::vector<uint16_t> _sites;
+
+    /**
+     * @brief Vehicles of each cohort, consecutive ids (lane = id % _lanes_per_cohort).
+     *
+     */
+    uint32_t _lanes_per_cohort;
+
+    /**
+     * @brief Cohorts, each advanced by a thread of its own.
+     *
+     */
+    std::vector<VehicleCohort> _cohorts;
+
+    /**
+     * @brief Lanes of each cohort that landed during the step.
+     *
+     */
+    std::vector<std::vector<uint32_t>> _landed;
+
+    /**
+     * @brief Transitions applied by each cohort.
+     *
+     */
+    std::vector<size_t> _transitions;
+
+    /**
+     * @brief Vehicles that landed during the step, by id.
+     *
+     */
+    std::vector<uint32_t> _arrivals;
+
+    /**
+     * @brief Vehicles waiting for a charger at each site, by id.
+     *
+     */
+    std::vector<std::deque<uint32_t>> _queues;
+
+    /**
+     * @brief Simulation time (ms) each charger of each site is free from, earliest first.
+     *
+     */
+    std::vector<std::priority_queue<int32_t, std::vector<int32_t>, std::greater<int32_t>>> _free_ms;
+
+    /**
+     * @brief Simulation time (ms) run so far.
+     *
+     */
+    int32_t _clock_ms;
+};
+
+#endif
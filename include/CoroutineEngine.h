@@ -0,0 +1,377 @@
+#ifndef COROUTINE_ENGINE_H
+#define COROUTINE_ENGINE_H
+
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Channel.h"
+#include "Executor.h"
+#include "Process.h"
+#include "Simulation.h"
+#include "SimulationContext.h"
+#include "Topology.h"
+#include "Vehicle.h"
+
+/**
+ * @brief Fleet availability at a point in simulation time.
+ *
+ */
+struct AvailabilitySample
+{
+    int64_t  time_ms;   //!< Simulation time (ms).
+    uint32_t grounded;  //!< Vehicles waiting for or under repair.
+    double   fraction;  //!< Fraction of the fleet not grounded.
+};
+
+/**
+ * @brief Runs the fleet of a Simulation as processes (coroutines) of an
+ *        Executor in simulation time, instead of a thread per vehicle and
+ *        charger in real time.  A vehicle cruises, co_awaits a charger at its
+ *        site and co_awaits the end of its charge, then repeats; a charger
+ *        co_awaits the next vehicle of its site's queue and charges it.  Each
+ *        is a frame of a few hundred bytes, so fleets of millions run on one
+ *        thread, and a run takes as long as its events rather than minutes.
+ *
+ *        Vehicles fly full battery flights (no trips, unbounded queues), and
+ *        the same seed draws the same fleet as a Simulation.
+ *
+ *        With maintenance enabled a vehicle may fault in flight, at its
+ *        type's ProbabilityOfFault().  It lands, then co_awaits a technician
+ *        in a maintenance queue of its own, the same way it awaits a
+ *        charger, before it charges.
+ *
+ */
+class CoroutineEngine
+{
+public:
+
+    /**
+     * @brief Construct a new CoroutineEngine object.
+     *
+     * @param num_vehicles Number of vehicles.
+     * @param num_vehicle_types Number of vehicle types.
+     * @param num_chargers Number of chargers.
+     * @param num_sites Number of sites the vehicles and chargers are spread over.
+     */
+    CoroutineEngine(const uint32_t       num_vehicles,
+                    const unsigned short num_vehicle_types,
+                    const unsigned short num_chargers,
+                    const unsigned short num_sites = 1);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    CoroutineEngine() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    CoroutineEngine(const CoroutineEngine &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return CoroutineEngine&
+     */
+    CoroutineEngine &operator=(const CoroutineEngine &) = delete;
+
+    /**
+     * @brief Destroy the CoroutineEngine object.
+     *
+     */
+    virtual ~CoroutineEngine() = default;
+
+    /**
+     * @brief Seeds the random number generator, so a run can be repeated.
+     *        Must be called before Create().
+     *
+     * @param seed Seed of the random number generator.
+     */
+    void Seed(const uint32_t seed);
+
+    /**
+     * @brief Grounds vehicles that fault in flight until a technician has
+     *        repaired them, with exponentially distributed repair times,
+     *        and samples the fleet's availability.  Must be called before
+     *        Create().
+     *
+     * @param technicians Number of vehicles repaired at the same time.
+     * @param mean_repair_mins Mean time (mins) to repair a vehicle.
+     * @param sample_secs Interval (seconds) availability is sampled at, 0 for none.
+     */
+    void EnableMaintenance(const uint16_t technicians, const double mean_repair_mins, const int64_t sample_secs = 0);
+
+    /**
+     * @brief Creates random vehicles and the chargers, and spawns a process
+     *        for each.
+     *
+     * @return size_t Number of processes.
+     */
+    size_t Create();
+
+    /**
+     * @brief Runs the simulation for a further sim_time_secs.
+     *
+     * @param sim_time_secs Duration (seconds) to run, one simulated minute each.
+     * @return size_t Number of times a process was resumed.
+     */
+    size_t Run(const int64_t sim_time_secs);
+
+    /**
+     * @brief Simulation time run so far.
+     *
+     * @return int64_t Simulation time (ms).
+     */
+    int64_t Clock() const { return _executor.Now(); }
+
+    /**
+     * @brief Number of vehicles waiting for a charger at every site.
+     *
+     * @return size_t Number of vehicles waiting.
+     */
+    size_t QueueLength() const;
+
+    /**
+     * @brief Number of faults so far.
+     *
+     * @return uint64_t Number of faults.
+     */
+    uint64_t Faults() const { return _faults; }
+
+    /**
+     * @brief Number of repairs completed so far.
+     *
+     * @return uint64_t Number of repairs.
+     */
+    uint64_t Repairs() const { return _repairs; }
+
+    /**
+     * @brief Number of vehicles waiting for or under repair.
+     *
+     * @return uint32_t Number of vehicles.
+     */
+    uint32_t Grounded() const { return _grounded; }
+
+    /**
+     * @brief Number of vehicles waiting for a technician.
+     *
+     * @return size_t Number of vehicles waiting.
+     */
+    size_t MaintenanceQueueLength() const { return _maintenance ? _maintenance->Size() : 0; }
+
+    /**
+     * @brief Fleet availability sampled so far.  Requires EnableMaintenance().
+     *
+     * @return const std::vector<AvailabilitySample>& Samples, oldest first.
+     */
+    const std::vector<AvailabilitySample>& Availability() const { return _availability; }
+
+    /**
+     * @brief Prints the faults, repairs and the fleet's availability over
+     *        the run.  Requires EnableMaintenance().
+     *
+     */
+    void PrintMaintenance() const;
+
+    /**
+     * @brief Calculates the results for each vehicle type (VehicleA,
+     *        VehicleB, ...), the same as Simulation does.
+     *
+     * @param sim_time_secs Duration (seconds) the simulation ran.
+     * @return std::vector<VehicleTypeMetrics> Results of each type, by name.
+     */
+    std::vector<VehicleTypeMetrics> MetricsForEachVehicleType(const int64_t sim_time_secs) const;
+
+private:
+
+    /**
+     * @brief A vehicle: its type, where it is and what it has done so far.
+     *
+     */
+    struct CoVehicle
+    {
+        uint32_t                id;
+        uint16_t                type;
+        uint16_t                site;              //!< Site at, or flying to.
+        VehicleStateType        state;
+        int64_t                 since_ms;          //!< Simulation time (ms) state started.
+        int64_t                 cruise_total_ms;
+        int64_t                 charge_total_ms;
+        int64_t                 qing_total_ms;
+        int64_t                 maintenance_total_ms;
+        std::coroutine_handle<> handle;            //!< Resumed when its charge or repair ends.
+    };
+
+    /**
+     * @brief Awaitable that queues a vehicle for a charger (or technician)
+     *        and suspends it until the vehicle has been charged (repaired).
+     *
+     */
+    struct Serve
+    {
+        Channel<CoVehicle*>& queue;
+        CoVehicle&           vehicle;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { vehicle.handle = handle; queue.Push(&vehicle); }
+        void await_resume() const noexcept { }
+    };
+
+    /**
+     * @brief Behavior of a vehicle: cruise, queue, charge, repeat.
+     *
+     * @param vehicle Vehicle.
+     * @return Process Process of the vehicle.
+     */
+    Process VehicleProcess(CoVehicle& vehicle);
+
+    /**
+     * @brief Behavior of a charger: take the next vehicle, charge it, repeat.
+     *
+     * @param queue Charging queue of the charger's site.
+     * @return Process Process of the charger.
+     */
+    Process ChargerProcess(Channel<CoVehicle*>& queue);
+
+    /**
+     * @brief Behavior of a technician: take the next grounded vehicle,
+     *        repair it, repeat.
+     *
+     * @param queue Maintenance queue.
+     * @return Process Process of the technician.
+     */
+    Process TechnicianProcess(Channel<CoVehicle*>& queue);
+
+    /**
+     * @brief Samples the fleet's availability every interval.
+     *
+     * @param interval_ms Sampling interval (ms).
+     * @return Process Process of the sampler.
+     */
+    Process AvailabilityProcess(const int64_t interval_ms);
+
+    /**
+     * @brief Draws whether a flight faults.
+     *
+     * @param vehicle Vehicle flying.
+     * @param cruise_ms Flight time (ms).
+     * @return true  Vehicle faulted and is grounded when it lands.
+     * @return false Vehicle flew without a fault.
+     */
+    bool DrawFault(const CoVehicle& vehicle, const int64_t cruise_ms);
+
+    /**
+     * @brief Number of chargers.
+     *
+     */
+    const unsigned short _num_chargers;
+
+    /**
+     * @brief Number of vehicles.
+     *
+     */
+    const uint32_t _num_vehicles;
+
+    /**
+     * @brief Number of vehicle types.
+     *
+     */
+    const unsigned short _num_vehicle_types;
+
+    /**
+     * @brief State shared by the prototype vehicles (never started).
+     *
+     */
+    SimulationContext _context;
+
+    /**
+     * @brief Random number generator drawing the vehicle types.
+     *
+     */
+    std::mt19937 _gen;
+
+    /**
+     * @brief Sites and the routes flown between them.
+     *
+     */
+    Topology _topology;
+
+    /**
+     * @brief A vehicle of each type, holding the type's parameters.
+     *
+     */
+    std::vector<std::shared_ptr<Vehicle>> _prototypes;
+
+    /**
+     * @brief Vehicles, never reallocated once created.
+     *
+     */
+    std::vector<CoVehicle> _vehicles;
+
+    /**
+     * @brief Charging queue of each site.
+     *
+     */
+    std::vector<std::unique_ptr<Channel<CoVehicle*>>> _queues;
+
+    /**
+     * @brief Number of technicians, 0 when maintenance is disabled.
+     *
+     */
+    uint16_t _technicians;
+
+    /**
+     * @brief Mean time (mins) to repair a vehicle.
+     *
+     */
+    double _mean_repair_mins;
+
+    /**
+     * @brief Interval (seconds) availability is sampled at, 0 for none.
+     *
+     */
+    int64_t _sample_secs;
+
+    /**
+     * @brief Queue of vehicles waiting for a technician.
+     *
+     */
+    std::unique_ptr<Channel<CoVehicle*>> _maintenance;
+
+    /**
+     * @brief Number of faults so far.
+     *
+     */
+    uint64_t _faults;
+
+    /**
+     * @brief Number of repairs completed so far.
+     *
+     */
+    uint64_t _repairs;
+
+    /**
+     * @brief Number of vehicles waiting for or under repair.
+     *
+     */
+    uint32_t _grounded;
+
+    /**
+     * @brief Fleet availability sampled so far.
+     *
+     */
+    std::vector<AvailabilitySample> _availability;
+
+    /**
+     * @brief Executor of the processes, destroyed (with the frames) first.
+     *
+     */
+    Executor _executor;
+};
+
+#endif
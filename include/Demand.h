@@ -0,0 +1,120 @@
+#ifndef DEMAND_H
+#define DEMAND_H
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Topology.h"
+
+/**
+ * @brief A passenger's request to fly from one site to another.
+ *
+ */
+struct TripRequest
+{
+    uint32_t id;                //!< Request identification.
+    uint16_t origin;            //!< Site the passenger departs from.
+    uint16_t destination;       //!< Site the passenger flies to.
+    int64_t  requested_ms;      //!< Simulation time (ms) of the request.
+};
+
+/**
+ * @brief Number of hours in the time of day profile.
+ *
+ */
+constexpr size_t DEMAND_HOURS = 24;
+
+/**
+ * @brief Generates passenger trip requests between the sites of a topology.
+ *        Requests arrive as a Poisson process whose rate follows a time of
+ *        day profile; the origin and destination of each request are drawn
+ *        uniformly from the sites.
+ *
+ */
+class Demand
+{
+public:
+
+    /**
+     * @brief Construct a new Demand object.
+     *
+     * @param topology Sites requests are made between.
+     * @param trips_per_min Mean number of requests per minute over a day.
+     * @param seed Seed of the random number generator.
+     */
+    Demand(const Topology& topology, const double trips_per_min, const uint32_t seed);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    Demand() = delete;
+
+    /**
+     * @brief Destroy the Demand object.
+     *
+     */
+    virtual ~Demand() = default;
+
+    /**
+     * @brief Replaces the time of day profile.  The profile is normalized so
+     *        its mean is 1, i.e. it shapes the demand but keeps trips_per_min.
+     *
+     * @param hourly Relative demand of each hour of the day, from midnight.
+     */
+    void SetProfile(const std::array<double, DEMAND_HOURS>& hourly);
+
+    /**
+     * @brief Request rate at a point in time.
+     *
+     * @param clock_ms Simulation time (ms), 0 is midnight.
+     * @return double Requests per minute.
+     */
+    double Rate(const int64_t clock_ms) const;
+
+    /**
+     * @brief Generates the requests made in a window of time.
+     *
+     * @param from_ms Start of window (ms simulation time).
+     * @param to_ms End of window (ms simulation time).
+     * @param requests Requests are appended to requests.
+     * @return size_t Number of requests generated.
+     */
+    size_t Generate(const int64_t from_ms, const int64_t to_ms, std::vector<TripRequest>& requests);
+
+private:
+
+    /**
+     * @brief Sites requests are made between.
+     *
+     */
+    const Topology& _topology;
+
+    /**
+     * @brief Mean number of requests per minute over a day.
+     *
+     */
+    const double _trips_per_min;
+
+    /**
+     * @brief Relative demand of each hour of the day (mean of 1).
+     *
+     */
+    std::array<double, DEMAND_HOURS> _profile;
+
+    /**
+     * @brief Random number generator.
+     *
+     */
+    std::mt19937 _gen;
+
+    /**
+     * @brief Id of the next request.
+     *
+     */
+    uint32_t _next_id;
+};
+
+#endif
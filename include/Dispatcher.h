@@ -0,0 +1,245 @@
+#ifndef DISPATCHER_H
+#define DISPATCHER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Demand.h"
+#include "Histogram.h"
+#include "SimulationObject.h"
+#include "SpatialIndex.h"
+#include "Topology.h"
+#include "Vehicle.h"
+
+/**
+ * @brief Width (miles) of a cell of the index of idle vehicles.
+ *
+ */
+constexpr float DISPATCH_CELL_MILES = 10.0f;
+
+/**
+ * @brief Assigns passenger trip requests to idle vehicles.  Runs in its own
+ *        thread and dispatches in batches: each tick, every request made
+ *        since the previous tick is matched against the nearest idle vehicle
+ *        to the request's origin, found with a grid index of idle vehicle
+ *        positions.  Requests that can not be matched wait for a later tick
+ *        until they expire.
+ *
+ */
+class Dispatcher : public SimulationObject
+{
+public:
+
+    /**
+     * @brief Construct a new Dispatcher object.
+     *
+     * @param demand Generates the trip requests.
+     * @param vehicles Vehicles flying trips.
+     * @param topology Sites requests are made between.
+     * @param max_wait_mins Duration (mins) a request waits before it is lost.
+     * @param context State shared by all objects of the simulation.
+     */
+    Dispatcher(Demand&                                      demand,
+               const std::vector<std::shared_ptr<Vehicle>>& vehicles,
+               const Topology&                              topology,
+               const int64_t                                max_wait_mins,
+               SimulationContext&                           context);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    Dispatcher() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    Dispatcher(const Dispatcher &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return Dispatcher&
+     */
+    Dispatcher &operator=(const Dispatcher &) = delete;
+
+    /**
+     * @brief Destroy the Dispatcher object.
+     *
+     */
+    virtual ~Dispatcher() = default;
+
+    //
+    // Dispatcher
+    //
+
+    /**
+     * @brief Sets the simulation time the next run starts at.  Must be
+     *        called before the dispatcher is started.
+     *
+     * @param clock_offset_ms Simulation time (ms) elapsed before the run.
+     */
+    void Prepare(const int64_t clock_offset_ms);
+
+    /**
+     * @brief Adds a request made outside of the demand model.  It is 
+     *        dispatched by the next tick.
+     *
+     * @param request Trip request.
+     */
+    void Submit(const TripRequest& request);
+
+    /**
+     * @brief Generates the requests made since the previous tick and assigns
+     *        as many waiting requests as possible to idle vehicles.
+     *
+     * @param clock_ms Simulation time (ms) of the tick.
+     * @return size_t Number of requests assigned.
+     */
+    size_t Dispatch(const int64_t clock_ms);
+
+    /**
+     * @brief Number of requests made.
+     *
+     * @return uint64_t Number of requests made.
+     */
+    uint64_t Requests() const { return _requests; }
+
+    /**
+     * @brief Number of requests assigned to a vehicle.
+     *
+     * @return uint64_t Number of requests assigned.
+     */
+    uint64_t Assigned() const { return _assigned; }
+
+    /**
+     * @brief Number of requests that expired before a vehicle was assigned.
+     *
+     * @return uint64_t Number of requests lost.
+     */
+    uint64_t Lost() const { return _lost; }
+
+    /**
+     * @brief Number of requests waiting for a vehicle.
+     *
+     * @return size_t Number of requests waiting.
+     */
+    size_t Backlog() const { return _backlog.size(); }
+
+    /**
+     * @brief Duration (ms) from each assigned request until its vehicle
+     *        arrives at the origin.
+     *
+     */
+    Histogram WaitLaps;
+
+    //
+    // SimulationObject overrides
+    //
+
+    /**
+     * @brief Prints dispatcher statistics to console.
+     *
+     */
+    virtual void PrintStats() override;
+
+    //
+    // SimulationThread overrides
+    //
+
+    /**
+     * @brief Dispatches once each simulated minute until stopped.
+     *
+     */
+    virtual void Run() override;
+
+protected:
+
+    //
+    // SimulationObject overrides
+    //
+
+    /**
+     * @brief String used to uniquely identify this object.
+     *
+     * @return const std::string Header used to uniquely identify dispatcher.
+     */
+    virtual const std::string Header() override;
+
+    /**
+     * @brief Generates the trip requests.
+     *
+     */
+    Demand& _demand;
+
+    /**
+     * @brief Vehicles flying trips.
+     *
+     */
+    const std::vector<std::shared_ptr<Vehicle>>& _vehicles;
+
+    /**
+     * @brief Sites requests are made between.
+     *
+     */
+    const Topology& _topology;
+
+    /**
+     * @brief Duration (ms) a request waits before it is lost.
+     *
+     */
+    const int64_t _max_wait_ms;
+
+    /**
+     * @brief Positions of the idle vehicles (by index into _vehicles),
+     *        updated each tick.
+     *
+     */
+    SpatialIndex _available;
+
+    /**
+     * @brief Requests waiting for a vehicle, oldest first.
+     *
+     */
+    std::vector<TripRequest> _backlog;
+
+    /**
+     * @brief Requests still waiting after a tick.
+     *
+     */
+    std::vector<TripRequest> _unmatched;
+
+    /**
+     * @brief Simulation time (ms) of the previous tick.
+     *
+     */
+    int64_t _last_ms;
+
+    /**
+     * @brief Simulation time (ms) elapsed before the run.
+     *
+     */
+    int64_t _clock_offset_ms;
+
+    /**
+     * @brief Number of requests made.
+     *
+     */
+    uint64_t _requests;
+
+    /**
+     * @brief Number of requests assigned to a vehicle.
+     *
+     */
+    uint64_t _assigned;
+
+    /**
+     * @brief Number of requests that expired before a vehicle was assigned.
+     *
+     */
+    uint64_t _lost;
+};
+
+#endif
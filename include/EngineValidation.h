@@ -0,0 +1,194 @@
+#ifndef ENGINE_VALIDATION_H
+#define ENGINE_VALIDATION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Simulation.h"
+
+/**
+ * @brief Largest difference of a metric from the threaded engine accepted
+ *        by default (percentage points of simulation time).
+ *
+ */
+constexpr double ENGINE_VALIDATION_TOLERANCE_PCT = 5.0;
+
+/**
+ * @brief Results of one engine running the scenario of a validation.
+ *
+ */
+struct EngineResult
+{
+    SimulationEngine                engine;         //!< Engine run.
+    double                          wall_secs;      //!< Realtime (seconds) the run took.
+    double                          speedup;        //!< Realtime of the threaded engine over this engine's.
+    double                          max_error_pct;  //!< Largest difference of a metric from the threaded engine (percentage points).
+    std::vector<VehicleTypeMetrics> metrics;        //!< Results of each vehicle type.
+};
+
+/**
+ * @brief Runs the same seeded scenario on every engine of a Simulation and
+ *        checks the flight, charge and queueing time of each vehicle type
+ *        agree with the threaded engine, the reference, within a tolerance.
+ *        Engines run one after the other so each has the cores to itself,
+ *        and the speedup of each over the threaded engine is reported.
+ *        The threaded engine counts each state in whole simulated minutes,
+ *        so it is short by up to a minute per state of each vehicle; short
+ *        runs need a wider tolerance.
+ *
+ */
+class EngineValidation
+{
+public:
+
+    /**
+     * @brief Construct a new EngineValidation object.
+     *
+     * @param num_vehicles Number of vehicles of the scenario.
+     * @param num_vehicle_types Number of vehicle types.
+     * @param num_chargers Number of chargers of the scenario.
+     * @param num_sites Number of sites (vertiports) the chargers are spread over.
+     */
+    EngineValidation(const unsigned short num_vehicles,
+                     const unsigned short num_vehicle_types,
+                     const unsigned short num_chargers,
+                     const unsigned short num_sites = 1);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    EngineValidation() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    EngineValidation(const EngineValidation &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return EngineValidation&
+     */
+    EngineValidation &operator=(const EngineValidation &) = delete;
+
+    /**
+     * @brief Destroy the EngineValidation object.
+     *
+     */
+    virtual ~EngineValidation() = default;
+
+    /**
+     * @brief Runs the scenario on every engine, the threaded engine first.
+     *
+     * @param sim_time_secs Duration (seconds) to run each engine.
+     * @param seed Seed of the scenario, the same fleet on every engine.
+     * @param tolerance_pct Largest difference of a metric accepted (percentage points).
+     * @return true  Every engine agrees with the threaded engine.
+     * @return false An engine differs by more than tolerance_pct.
+     */
+    bool Run(const int64_t  sim_time_secs,
+             const uint32_t seed,
+             const double   tolerance_pct = ENGINE_VALIDATION_TOLERANCE_PCT);
+
+    /**
+     * @brief Results of each engine of the last Run(), the threaded engine first.
+     *
+     * @return const std::vector<EngineResult>& Results.
+     */
+    const std::vector<EngineResult>& Results() const { return _results; }
+
+    /**
+     * @brief Checks to see if every engine of the last Run() agreed with
+     *        the threaded engine.
+     *
+     * @return true  Every engine agreed.
+     * @return false An engine differed by more than the tolerance.
+     */
+    bool Passed() const;
+
+    /**
+     * @brief Prints the metrics of each vehicle type on each engine, and
+     *        the realtime, speedup and largest difference of each engine.
+     *
+     */
+    void PrintResults() const;
+
+    /**
+     * @brief Name of an engine.
+     *
+     * @param engine Engine.
+     * @return std::string Name ("threaded", "serial" or "parallel").
+     */
+    static std::string Name(const SimulationEngine engine);
+
+private:
+
+    /**
+     * @brief Runs the scenario on one engine.
+     *
+     * @param engine Engine.
+     * @param sim_time_secs Duration (seconds) to run.
+     * @param seed Seed of the scenario.
+     * @return EngineResult Results, not yet compared.
+     */
+    EngineResult RunEngine(const SimulationEngine engine, const int64_t sim_time_secs, const uint32_t seed) const;
+
+    /**
+     * @brief Largest difference of the flight, charge and queueing time of
+     *        a vehicle type between two runs.  A type missing from either
+     *        run, or with a different number of vehicles, differs by 100.
+     *
+     * @param reference Results of the threaded engine.
+     * @param metrics Results of the engine compared.
+     * @return double Largest difference (percentage points).
+     */
+    static double MaxError(const std::vector<VehicleTypeMetrics>& reference,
+                           const std::vector<VehicleTypeMetrics>& metrics);
+
+    /**
+     * @brief Number of vehicles of the scenario.
+     *
+     */
+    const unsigned short _num_vehicles;
+
+    /**
+     * @brief Number of vehicle types.
+     *
+     */
+    const unsigned short _num_vehicle_types;
+
+    /**
+     * @brief Number of chargers of the scenario.
+     *
+     */
+    const unsigned short _num_chargers;
+
+    /**
+     * @brief Number of sites of the scenario.
+     *
+     */
+    const unsigned short _num_sites;
+
+    /**
+     * @brief Largest difference of a metric accepted by the last Run().
+     *
+     */
+    double _tolerance_pct;
+
+    /**
+     * @brief Duration (seconds) of the last Run().
+     *
+     */
+    int64_t _sim_time_secs;
+
+    /**
+     * @brief Results of each engine of the last Run().
+     *
+     */
+    std::vector<EngineResult> _results;
+};
+
+#endif
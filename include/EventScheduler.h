@@ -0,0 +1,175 @@
+#ifndef EVENT_SCHEDULER_H
+#define EVENT_SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+/**
+ * @brief An event pending in a scheduler.
+ *
+ */
+struct ScheduledEvent
+{
+    int64_t  time_ms;  //!< Simulation time (ms) the event is due.
+    uint32_t target;   //!< Object the event is for (e.g. a vehicle lane).
+    uint32_t kind;     //!< What happens (e.g. a VehicleStateType).
+};
+
+/**
+ * @brief Queue of pending events of an event driven engine, popped in time
+ *        order.  Events due at the same time are popped in the order they
+ *        were scheduled, so every scheduler replays a run identically.
+ *
+ */
+class EventScheduler
+{
+public:
+
+    /**
+     * @brief Destroy the EventScheduler object.
+     *
+     */
+    virtual ~EventScheduler() = default;
+
+    /**
+     * @brief Adds an event.
+     *
+     * @param event Event to add.  Must not be due before the last event popped.
+     */
+    virtual void Schedule(const ScheduledEvent& event) = 0;
+
+    /**
+     * @brief Removes the earliest event.
+     *
+     * @param event Earliest event.
+     * @return true  An event was popped.
+     * @return false No events pending.
+     */
+    virtual bool Pop(ScheduledEvent& event) = 0;
+
+    /**
+     * @brief Removes the earliest event if it is due by a time.  Leaves the
+     *        scheduler where events due after until_ms can still be added.
+     *
+     * @param event Earliest event.
+     * @param until_ms Simulation time (ms) the event must be due by.
+     * @return true  An event was popped.
+     * @return false No events due by until_ms.
+     */
+    virtual bool PopDue(ScheduledEvent& event, const int64_t until_ms) = 0;
+
+    /**
+     * @brief Number of events pending.
+     *
+     * @return size_t Number of events pending.
+     */
+    virtual size_t Size() const = 0;
+
+    /**
+     * @brief Checks to see if no events are pending.
+     *
+     * @return true  No events pending.
+     * @return false Events pending.
+     */
+    bool Empty() const { return Size() == 0; }
+};
+
+/**
+ * @brief Scheduler on a binary heap (std::priority_queue), O(log n) per
+ *        event.  The reference the other schedulers are measured against.
+ *
+ */
+class HeapScheduler : public EventScheduler
+{
+public:
+
+    /**
+     * @brief Default Constructor.
+     *
+     */
+    HeapScheduler() = default;
+
+    /**
+     * @brief Destroy the HeapScheduler object.
+     *
+     */
+    virtual ~HeapScheduler() = default;
+
+    /**
+     * @brief Adds an event.
+     *
+     * @param event Event to add.
+     */
+    virtual void Schedule(const ScheduledEvent& event) override { _heap.push({ event, _seq++ }); }
+
+    /**
+     * @brief Removes the earliest event.
+     *
+     * @param event Earliest event.
+     * @return true  An event was popped.
+     * @return false No events pending.
+     */
+    virtual bool Pop(ScheduledEvent& event) override
+    {
+        if(_heap.empty())
+            return false;
+        event = _heap.top().event;
+        _heap.pop();
+        return true;
+    }
+
+    /**
+     * @brief Removes the earliest event if it is due by a time.
+     *
+     * @param event Earliest event.
+     * @param until_ms Simulation time (ms) the event must be due by.
+     * @return true  An event was popped.
+     * @return false No events due by until_ms.
+     */
+    virtual bool PopDue(ScheduledEvent& event, const int64_t until_ms) override
+    {
+        if(_heap.empty() || _heap.top().event.time_ms > until_ms)
+            return false;
+        return Pop(event);
+    }
+
+    /**
+     * @brief Number of events pending.
+     *
+     * @return size_t Number of events pending.
+     */
+    virtual size_t Size() const override { return _heap.size(); }
+
+private:
+
+    /**
+     * @brief Event and the order it was scheduled in, to break ties.
+     *
+     */
+    struct Entry
+    {
+        ScheduledEvent event;
+        uint64_t       seq;
+
+        bool operator>(const Entry& other) const
+        {
+            return event.time_ms != other.event.time_ms ? event.time_ms > other.event.time_ms : seq > other.seq;
+        }
+    };
+
+    /**
+     * @brief Pending events, earliest on top.
+     *
+     */
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> _heap;
+
+    /**
+     * @brief Number of events scheduled.
+     *
+     */
+    uint64_t _seq = 0;
+};
+
+#endif
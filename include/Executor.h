@@ -0,0 +1,161 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "EventScheduler.h"
+#include "Process.h"
+
+/**
+ * @brief Runs processes (coroutines) on one thread in simulation time.  A
+ *        process that awaits is woken by an event of the scheduler, so the
+ *        clock jumps from event to event instead of waiting in real time,
+ *        and a fleet costs a heap frame per process instead of a thread.
+ *
+ *        Times are ms of simulation time (1000 ms are one simulated minute,
+ *        as for the threaded engine's histograms).
+ *
+ */
+class Executor
+{
+public:
+
+    /**
+     * @brief Awaitable that wakes the awaiting process at a time.
+     *
+     */
+    struct Sleep
+    {
+        Executor& executor;
+        int64_t   time_ms;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { executor.Wake(handle, time_ms); }
+        void await_resume() const noexcept { }
+    };
+
+    /**
+     * @brief Construct a new Executor object.
+     *
+     * @param scheduler Scheduler of the wake up events (a TimingWheel when null).
+     */
+    explicit Executor(std::unique_ptr<EventScheduler> scheduler = nullptr);
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    Executor(const Executor &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return Executor&
+     */
+    Executor &operator=(const Executor &) = delete;
+
+    /**
+     * @brief Destroy the Executor object and the frames of its processes.
+     *
+     */
+    virtual ~Executor();
+
+    /**
+     * @brief Takes a process and starts it at the current time.
+     *
+     * @param process Process to run.
+     */
+    void Spawn(Process process);
+
+    /**
+     * @brief Resumes a suspended process at a time.
+     *
+     * @param handle Process to resume.
+     * @param time_ms Simulation time (ms) to resume it at, now when earlier.
+     */
+    void Wake(std::coroutine_handle<> handle, const int64_t time_ms);
+
+    /**
+     * @brief Resumes a suspended process at the current time, after the
+     *        processes already due.
+     *
+     * @param handle Process to resume.
+     */
+    void Wake(std::coroutine_handle<> handle) { Wake(handle, _now); }
+
+    /**
+     * @brief Suspends the awaiting process for a while.
+     *
+     * @param duration_ms Duration (ms) of simulation time.
+     * @return Sleep Awaitable.
+     */
+    Sleep Delay(const int64_t duration_ms) { return Sleep{ *this, _now + duration_ms }; }
+
+    /**
+     * @brief Resumes every process due by a time, in time order, and moves
+     *        the clock to that time.
+     *
+     * @param until_ms Simulation time (ms) to run to.
+     * @return size_t Number of times a process was resumed.
+     */
+    size_t Run(const int64_t until_ms);
+
+    /**
+     * @brief Current simulation time.
+     *
+     * @return int64_t Simulation time (ms).
+     */
+    int64_t Now() const { return _now; }
+
+    /**
+     * @brief Number of processes spawned.
+     *
+     * @return size_t Number of processes.
+     */
+    size_t Processes() const { return _processes.size(); }
+
+    /**
+     * @brief Number of processes waiting for a time (the rest wait for
+     *        another process).
+     *
+     * @return size_t Number of processes.
+     */
+    size_t Pending() const { return _scheduler->Size(); }
+
+private:
+
+    /**
+     * @brief Scheduler of the wake up events.
+     *
+     */
+    std::unique_ptr<EventScheduler> _scheduler;
+
+    /**
+     * @brief Current simulation time (ms).
+     *
+     */
+    int64_t _now;
+
+    /**
+     * @brief Frames of the processes spawned, destroyed with the executor.
+     *
+     */
+    std::vector<std::coroutine_handle<>> _processes;
+
+    /**
+     * @brief Process each pending event wakes, indexed by the event's target.
+     *
+     */
+    std::vector<std::coroutine_handle<>> _waking;
+
+    /**
+     * @brief Entries of _waking not in use.
+     *
+     */
+    std::vector<uint32_t> _free;
+};
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef FLEET_SAMPLER_H
+#define FLEET_SAMPLER_H
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Charger.h"
+#include "SimulationObject.h"
+#include "Topology.h"
+#include "Vehicle.h"
+
+/**
+ * @brief Number of vehicle states sampled.  Vehicles of the threaded engine
+ *        are never grounded for maintenance, the last state.
+ *
+ */
+constexpr size_t FLEET_SAMPLER_STATES = MAINTENANCE;
+
+/**
+ * @brief Samples the state of the fleet at a fixed simulated interval into
+ *        preallocated columns (one vector per metric).  Runs in its own
+ *        thread and only reads atomics and the queue size, so vehicles and
+ *        chargers never wait on it.
+ *
+ */
+class FleetSampler : public SimulationObject
+{
+public:
+
+    /**
+     * @brief Construct a new FleetSampler object.
+     *
+     * @param interval_secs Duration (seconds) between samples.
+     * @param vehicles Vehicles to sample.
+     * @param chargers Chargers to sample.
+     * @param topology Sites holding the charging queues.
+     * @param context State shared by all objects of the simulation.
+     */
+    FleetSampler(const int64_t                                interval_secs,
+                 const std::vector<std::shared_ptr<Vehicle>>& vehicles,
+                 const std::vector<std::shared_ptr<Charger>>& chargers,
+                 const Topology&                              topology,
+                 SimulationContext&                           context);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    FleetSampler() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    FleetSampler(const FleetSampler &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return FleetSampler&
+     */
+    FleetSampler &operator=(const FleetSampler &) = delete;
+
+    /**
+     * @brief Destroy the FleetSampler object.
+     *
+     */
+    virtual ~FleetSampler() = default;
+
+    //
+    // FleetSampler
+    //
+
+    /**
+     * @brief Clears previous samples and preallocates the columns for a run.
+     *        Must be called before the sampler is started.
+     *
+     * @param sim_time_secs Duration (seconds) of the run.
+     * @param clock_offset_ms Simulation time (ms) elapsed before the run.
+     */
+    void Prepare(const int64_t sim_time_secs, const int64_t clock_offset_ms);
+
+    /**
+     * @brief Takes one sample.
+     *
+     * @param clock_ms Simulation time (ms) of the sample.
+     */
+    void Sample(const int64_t clock_ms);
+
+    /**
+     * @brief Number of samples taken.
+     *
+     * @return size_t Number of samples taken.
+     */
+    size_t Size() const { return _time_ms.size(); }
+
+    /**
+     * @brief Writes the samples as a CSV time series.
+     *
+     * @param path Output file.
+     * @throws std::runtime_error File could not be written.
+     */
+    void WriteCsv(const std::string& path) const;
+
+    //
+    // Columns
+    //
+
+    const std::vector<int64_t>&  TimeMs() const { return _time_ms; }
+    const std::vector<uint32_t>& QueueLength() const { return _queue_length; }
+    const std::vector<uint32_t>& BusyChargers() const { return _busy_chargers; }
+    const std::vector<uint32_t>& VehiclesInState(VehicleStateType state) const { return _vehicles_in_state[state]; }
+
+    //
+    // SimulationObject overrides
+    //
+
+    /**
+     * @brief Prints sampler statistics to console.
+     *
+     */
+    virtual void PrintStats() override;
+
+    //
+    // SimulationThread overrides
+    //
+
+    /**
+     * @brief Samples the fleet every interval until stopped.
+     *
+     */
+    virtual void Run() override;
+
+protected:
+
+    //
+    // SimulationObject overrides
+    //
+
+    /**
+     * @brief String used to uniquely identify this object.
+     *
+     * @return const std::string Header used to uniquely identify sampler.
+     */
+    virtual const std::string Header() override;
+
+    /**
+     * @brief Duration (seconds) between samples.
+     *
+     */
+    const int64_t _interval_secs;
+
+    /**
+     * @brief Vehicles to sample.
+     *
+     */
+    const std::vector<std::shared_ptr<Vehicle>>& _vehicles;
+
+    /**
+     * @brief Chargers to sample.
+     *
+     */
+    const std::vector<std::shared_ptr<Charger>>& _chargers;
+
+    /**
+     * @brief Sites holding the charging queues.
+     *
+     */
+    const Topology& _topology;
+
+    /**
+     * @brief Simulation time (ms) elapsed before the run.
+     *
+     */
+    int64_t _clock_offset_ms;
+
+    /**
+     * @brief Samples dropped because the columns were full.
+     *
+     */
+    size_t _dropped;
+
+    /**
+     * @brief Simulation time (ms) of each sample.
+     *
+     */
+    std::vector<int64_t> _time_ms;
+
+    /**
+     * @brief Length of the charging queues at each sample.
+     *
+     */
+    std::vector<uint32_t> _queue_length;
+
+    /**
+     * @brief Number of busy chargers at each sample.
+     *
+     */
+    std::vector<uint32_t> _busy_chargers;
+
+    /**
+     * @brief Number of vehicles in each state at each sample.
+     *
+     */
+    std::array<std::vector<uint32_t>, FLEET_SAMPLER_STATES> _vehicles_in_state;
+};
+
+#endif
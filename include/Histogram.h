@@ -0,0 +1,364 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+/**
+ * @brief Log-bucketed (HDR-style) histogram of non-negative values.  Each
+ *        power of two is split into 2^PRECISION_BITS linear sub-buckets, so
+ *        a recorded value is known within 1/2^PRECISION_BITS of its size.
+ *        The sub-buckets of a power of two (a row) are only allocated once
+ *        a value in it is recorded, so a histogram of similar values costs
+ *        a few hundred bytes rather than every bucket.
+ *
+ *        A histogram has a single writer and no locks; histograms written by
+ *        different threads are merged once the threads have been joined.
+ *
+ */
+class Histogram
+{
+public:
+
+    /**
+     * @brief Number of bits of precision kept for each value.
+     *
+     */
+    static constexpr int PRECISION_BITS = 4;
+
+    /**
+     * @brief Values at or above 2^MAX_BITS are counted in the last bucket.
+     *
+     */
+    static constexpr int MAX_BITS = 40;
+
+    /**
+     * @brief Number of buckets.
+     *
+     */
+    static constexpr size_t NUM_BUCKETS = (MAX_BITS - PRECISION_BITS + 1) << PRECISION_BITS;
+
+    /**
+     * @brief Number of rows (powers of two) of buckets.
+     *
+     */
+    static constexpr size_t NUM_ROWS = NUM_BUCKETS >> PRECISION_BITS;
+
+    /**
+     * @brief Default Constructor.
+     *
+     */
+    Histogram() = default;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    Histogram(const Histogram &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return Histogram&
+     */
+    Histogram &operator=(const Histogram &) = delete;
+
+    /**
+     * @brief Move Constructor.
+     *
+     */
+    Histogram(Histogram &&) = default;
+
+    /**
+     * @brief Move assignment operator.
+     *
+     * @return Histogram&
+     */
+    Histogram &operator=(Histogram &&) = default;
+
+    /**
+     * @brief Destroy the Histogram object.
+     *
+     */
+    virtual ~Histogram() = default;
+
+    /**
+     * @brief Records a value.
+     *
+     * @param value Value to record (negative values are recorded as zero).
+     */
+    void Record(int64_t value);
+
+    /**
+     * @brief Adds the values recorded by another histogram.
+     *
+     * @param other Histogram to merge.
+     */
+    void Merge(const Histogram& other);
+
+    /**
+     * @brief Clears all recorded values.
+     *
+     */
+    void Reset();
+
+    /**
+     * @brief Number of recorded values.
+     *
+     * @return uint64_t Number of recorded values.
+     */
+    uint64_t Count() const { return _count; }
+
+    /**
+     * @brief Smallest recorded value.
+     *
+     * @return int64_t Smallest recorded value (0 when empty).
+     */
+    int64_t Min() const { return _count ? _min : 0; }
+
+    /**
+     * @brief Largest recorded value.
+     *
+     * @return int64_t Largest recorded value (0 when empty).
+     */
+    int64_t Max() const { return _max; }
+
+    /**
+     * @brief Mean of recorded values.
+     *
+     * @return double Mean of recorded values (0 when empty).
+     */
+    double Mean() const { return _count ? double(_sum) / _count : 0.0; }
+
+    /**
+     * @brief Value at or below which the requested percentage of values fall.
+     *
+     * @param percentile Percentile (0 - 100).
+     * @return int64_t Highest value equivalent to the bucket holding the percentile.
+     */
+    int64_t Percentile(double percentile) const;
+
+    /**
+     * @brief Bucket counting a value.
+     *
+     * @param value Value.
+     * @return size_t Bucket index.
+     */
+    static size_t BucketIndex(int64_t value);
+
+    /**
+     * @brief Lowest value counted by a bucket.
+     *
+     * @param index Bucket index.
+     * @return int64_t Lowest value of bucket.
+     */
+    static int64_t BucketLowest(size_t index);
+
+    /**
+     * @brief Number of values counted by a bucket.
+     *
+     * @param index Bucket index.
+     * @return uint32_t Count of bucket.
+     */
+    uint32_t BucketCount(size_t index) const;
+
+    /**
+     * @brief Number of bytes of buckets allocated.
+     *
+     * @return size_t Bytes of buckets allocated.
+     */
+    size_t AllocatedBytes() const;
+
+private:
+
+    /**
+     * @brief Counts of the sub-buckets of one power of two.
+     *
+     */
+    using Row = std::array<uint32_t, size_t(1) << PRECISION_BITS>;
+
+    /**
+     * @brief Rows of buckets, allocated when a value in them is first recorded.
+     *
+     */
+    std::array<std::unique_ptr<Row>, NUM_ROWS> _rows {};
+
+    /**
+     * @brief Number of recorded values.
+     *
+     */
+    uint64_t _count = 0;
+
+    /**
+     * @brief Sum of recorded values.
+     *
+     */
+    int64_t _sum = 0;
+
+    /**
+     * @brief Smallest recorded value.
+     *
+     */
+    int64_t _min = std::numeric_limits<int64_t>::max();
+
+    /**
+     * @brief Largest recorded value.
+     *
+     */
+    int64_t _max = 0;
+};
+
+/**
+ * @brief Bucket counting a value.
+ *
+ * @param value Value.
+ * @return size_t Bucket index.
+ */
+inline size_t Histogram::BucketIndex(int64_t value)
+{
+    constexpr uint64_t sub_buckets = uint64_t(1) << PRECISION_BITS;
+
+    uint64_t v = value < 0 ? 0 : uint64_t(value);
+    if(v < sub_buckets)
+        return v;
+
+    int exponent = 63 - __builtin_clzll(v);
+    if(exponent >= MAX_BITS)
+        return NUM_BUCKETS - 1;
+
+    uint64_t mantissa = (v >> (exponent - PRECISION_BITS)) & (sub_buckets - 1);
+    return ((exponent - PRECISION_BITS + 1) << PRECISION_BITS) + mantissa;
+}
+
+/**
+ * @brief Lowest value counted by a bucket.
+ *
+ * @param index Bucket index.
+ * @return int64_t Lowest value of bucket.
+ */
+inline int64_t Histogram::BucketLowest(size_t index)
+{
+    constexpr uint64_t sub_buckets = uint64_t(1) << PRECISION_BITS;
+
+    if(index < sub_buckets)
+        return index;
+
+    int exponent = int(index >> PRECISION_BITS) + PRECISION_BITS - 1;
+    uint64_t mantissa = index & (sub_buckets - 1);
+    return int64_t((sub_buckets + mantissa) << (exponent - PRECISION_BITS));
+}
+
+/**
+ * @brief Number of values counted by a bucket.
+ *
+ * @param index Bucket index.
+ * @return uint32_t Count of bucket.
+ */
+inline uint32_t Histogram::BucketCount(size_t index) const
+{
+    const std::unique_ptr<Row>& row = _rows[index >> PRECISION_BITS];
+    return row ? (*row)[index & (row->size() - 1)] : 0;
+}
+
+/**
+ * @brief Number of bytes of buckets allocated.
+ *
+ * @return size_t Bytes of buckets allocated.
+ */
+inline size_t Histogram::AllocatedBytes() const
+{
+    return sizeof(Row) * std::count_if(_rows.begin(), _rows.end(), [](const std::unique_ptr<Row>& row) { return bool(row); });
+}
+
+/**
+ * @brief Records a value.
+ *
+ * @param value Value to record (negative values are recorded as zero).
+ */
+inline void Histogram::Record(int64_t value)
+{
+    value = std::max<int64_t>(value, 0);
+
+    const size_t index = BucketIndex(value);
+    std::unique_ptr<Row>& row = _rows[index >> PRECISION_BITS];
+    if(!row)
+        row = std::make_unique<Row>();
+    ++(*row)[index & (row->size() - 1)];
+    ++_count;
+    _sum += value;
+    _min  = std::min(_min, value);
+    _max  = std::max(_max, value);
+}
+
+/**
+ * @brief Adds the values recorded by another histogram.
+ *
+ * @param other Histogram to merge.
+ */
+inline void Histogram::Merge(const Histogram& other)
+{
+    for(size_t r = 0; r < NUM_ROWS; ++r)
+    {
+        if(!other._rows[r])
+            continue;
+
+        if(!_rows[r])
+            _rows[r] = std::make_unique<Row>();
+        for(size_t i = 0; i < _rows[r]->size(); ++i)
+            (*_rows[r])[i] += (*other._rows[r])[i];
+    }
+
+    _count += other._count;
+    _sum   += other._sum;
+    _min    = std::min(_min, other._min);
+    _max    = std::max(_max, other._max);
+}
+
+/**
+ * @brief Clears all recorded values.
+ *
+ */
+inline void Histogram::Reset()
+{
+    *this = Histogram();
+}
+
+/**
+ * @brief Value at or below which the requested percentage of values fall.
+ *
+ * @param percentile Percentile (0 - 100).
+ * @return int64_t Highest value equivalent to the bucket holding the percentile.
+ */
+inline int64_t Histogram::Percentile(double percentile) const
+{
+    if(_count == 0)
+        return 0;
+
+    uint64_t rank = uint64_t(std::clamp(percentile, 0.0, 100.0) / 100.0 * _count + 0.5);
+    rank = std::clamp<uint64_t>(rank, 1, _count);
+
+    uint64_t seen = 0;
+    for(size_t r = 0; r < NUM_ROWS; ++r)
+    {
+        if(!_rows[r])
+            continue;
+
+        for(size_t j = 0; j < _rows[r]->size(); ++j)
+        {
+            seen += (*_rows[r])[j];
+            if(seen >= rank)
+            {
+                size_t  i       = (r << PRECISION_BITS) + j;
+                int64_t highest = (i + 1 < NUM_BUCKETS) ? BucketLowest(i + 1) - 1 : _max;
+                return std::min(highest, _max);
+            }
+        }
+    }
+
+    return _max;
+}
+
+#endif
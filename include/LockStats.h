@@ -0,0 +1,111 @@
+#ifndef LOCK_STATS_H
+#define LOCK_STATS_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Contention of a lock so far.
+ *
+ */
+struct LockStatsTotals
+{
+    uint64_t acquisitions;      //!< Times the lock was taken.
+    uint64_t contended;         //!< Times the lock was held by another thread.
+    int64_t  total_wait_ns;     //!< Time (ns) spent waiting for the lock.
+    int64_t  max_wait_ns;       //!< Longest wait (ns) for the lock.
+    uint64_t wakeups;           //!< Times a waiter was woken by the condition variable.
+    uint64_t spurious_wakeups;  //!< Wakeups that found nothing to take.
+};
+
+/**
+ * @brief Lock statistics policy of a TLockedQueue that keeps none.  Every
+ *        call compiles away and the policy takes no space in the queue.
+ *
+ */
+struct NoLockStats
+{
+    static constexpr bool ENABLED = false;
+
+    void Acquired() { }
+    void Contended(const int64_t) { }
+    void Woken(const bool) { }
+    LockStatsTotals Totals() const { return {}; }
+};
+
+/**
+ * @brief Lock statistics policy of a TLockedQueue that counts each
+ *        acquisition of its lock, the contended ones (the lock is tried
+ *        first) and how long they waited, and the condition variable
+ *        wakeups of its waiters.  Updated under the queue's lock except
+ *        for the wait, relaxed atomics so they can be read at any time.
+ *
+ */
+class LockContentionStats
+{
+public:
+
+    static constexpr bool ENABLED = true;
+
+    /**
+     * @brief Counts an acquisition that did not wait.
+     *
+     */
+    void Acquired()
+    {
+        _acquisitions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts an acquisition that waited for another thread.
+     *
+     * @param wait_ns Time (ns) waited.
+     */
+    void Contended(const int64_t wait_ns)
+    {
+        _acquisitions.fetch_add(1, std::memory_order_relaxed);
+        _contended.fetch_add(1, std::memory_order_relaxed);
+        _total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+
+        int64_t max = _max_wait_ns.load(std::memory_order_relaxed);
+        while(wait_ns > max && !_max_wait_ns.compare_exchange_weak(max, wait_ns, std::memory_order_relaxed)) { }
+    }
+
+    /**
+     * @brief Counts a waiter woken by the condition variable.
+     *
+     * @param spurious Nothing was left to take.
+     */
+    void Woken(const bool spurious)
+    {
+        _wakeups.fetch_add(1, std::memory_order_relaxed);
+        if(spurious)
+            _spurious_wakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Contention of the lock so far.
+     *
+     * @return LockStatsTotals Totals.
+     */
+    LockStatsTotals Totals() const
+    {
+        return { _acquisitions.load(std::memory_order_relaxed),
+                 _contended.load(std::memory_order_relaxed),
+                 _total_wait_ns.load(std::memory_order_relaxed),
+                 _max_wait_ns.load(std::memory_order_relaxed),
+                 _wakeups.load(std::memory_order_relaxed),
+                 _spurious_wakeups.load(std::memory_order_relaxed) };
+    }
+
+private:
+
+    std::atomic<uint64_t> _acquisitions { 0 };
+    std::atomic<uint64_t> _contended { 0 };
+    std::atomic<int64_t>  _total_wait_ns { 0 };
+    std::atomic<int64_t>  _max_wait_ns { 0 };
+    std::atomic<uint64_t> _wakeups { 0 };
+    std::atomic<uint64_t> _spurious_wakeups { 0 };
+};
+
+#endif
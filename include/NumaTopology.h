@@ -0,0 +1,107 @@
+#ifndef NUMA_TOPOLOGY_H
+#define NUMA_TOPOLOGY_H
+
+#include <pthread.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief NUMA nodes of the host and the CPUs of each, read from sysfs.
+ *        Hosts without NUMA information (or a single node) are one node
+ *        holding every CPU, so callers never special case them.
+ *
+ */
+class NumaTopology
+{
+public:
+
+    /**
+     * @brief Construct a new NumaTopology object.
+     *
+     * @param sysfs_root Directory holding the node0, node1, ... entries.
+     */
+    explicit NumaTopology(const std::string& sysfs_root = "/sys/devices/system/node");
+
+    /**
+     * @brief Destroy the NumaTopology object.
+     *
+     */
+    virtual ~NumaTopology() = default;
+
+    /**
+     * @brief Number of nodes with CPUs.
+     *
+     * @return size_t Number of nodes.
+     */
+    size_t Nodes() const { return _cpus.size(); }
+
+    /**
+     * @brief CPUs of a node.
+     *
+     * @param node Node (0 to Nodes() - 1).
+     * @return const std::vector<int>& CPUs of node.
+     */
+    const std::vector<int>& Cpus(const size_t node) const { return _cpus.at(node); }
+
+    /**
+     * @brief Restricts a thread to a set of CPUs.  Fails quietly (e.g. when
+     *        the process is confined to other CPUs) and the thread keeps
+     *        running wherever the kernel puts it.
+     *
+     * @param thread Thread to pin.
+     * @param cpus CPUs the thread may run on.
+     * @return true  Thread was pinned.
+     * @return false Thread was not pinned.
+     */
+    static bool Pin(const pthread_t thread, const std::vector<int>& cpus);
+
+    /**
+     * @brief Runs a function on a thread pinned to a node and waits for it,
+     *        so memory it allocates is first touched on that node.
+     *
+     * @tparam Function void()
+     * @param node Node to run on.
+     * @param function Function to run.
+     */
+    template<class Function> void RunOn(const size_t node, Function function) const;
+
+    /**
+     * @brief Parses a sysfs CPU list, e.g. "0-3,8-11".
+     *
+     * @param list CPU list.
+     * @return std::vector<int> CPUs in the list.
+     */
+    static std::vector<int> ParseCpuList(const std::string& list);
+
+private:
+
+    /**
+     * @brief CPUs of each node.
+     *
+     */
+    std::vector<std::vector<int>> _cpus;
+};
+
+/**
+ * @brief Runs a function on a thread pinned to a node and waits for it,
+ *        so memory it allocates is first touched on that node.
+ *
+ * @tparam Function void()
+ * @param node Node to run on.
+ * @param function Function to run.
+ */
+template<class Function>
+void NumaTopology::RunOn(const size_t node, Function function) const
+{
+    const std::vector<int>& cpus = Cpus(node);
+
+    std::thread worker([&]() {
+        Pin(pthread_self(), cpus);
+        function();
+    });
+    worker.join();
+}
+
+#endif
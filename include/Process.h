@@ -0,0 +1,87 @@
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include <coroutine>
+#include <utility>
+
+/**
+ * @brief Coroutine of a simulated process (e.g. a vehicle or a charger), a
+ *        small heap frame instead of a thread.  The process is created
+ *        suspended and does not run until spawned on an Executor, which
+ *        then owns the frame and resumes it each time what it awaits is
+ *        done.  Exceptions thrown by a process propagate out of the
+ *        Executor's Run().
+ *
+ */
+class Process
+{
+public:
+
+    /**
+     * @brief Promise of the coroutine, suspends it at the start and the end
+     *        so the Executor alone decides when it runs and when it is freed.
+     *
+     */
+    struct promise_type
+    {
+        Process get_return_object() { return Process(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() { }
+        void unhandled_exception() { throw; }
+    };
+
+    /**
+     * @brief Move Constructor.
+     *
+     * @param other Process to take the frame of.
+     */
+    Process(Process&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) { }
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    Process(const Process &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return Process&
+     */
+    Process &operator=(const Process &) = delete;
+
+    /**
+     * @brief Destroy the Process object, and its frame unless released.
+     *
+     */
+    virtual ~Process()
+    {
+        if(_handle)
+            _handle.destroy();
+    }
+
+    /**
+     * @brief Gives up ownership of the frame.
+     *
+     * @return std::coroutine_handle<> Frame of the process.
+     */
+    std::coroutine_handle<> Release() { return std::exchange(_handle, nullptr); }
+
+private:
+
+    /**
+     * @brief Construct a new Process object.  Called by the promise.
+     *
+     * @param handle Frame of the process.
+     */
+    explicit Process(std::coroutine_handle<promise_type> handle) : _handle(handle) { }
+
+    /**
+     * @brief Frame of the process, null once released.
+     *
+     */
+    std::coroutine_handle<promise_type> _handle;
+};
+
+#endif
@@ -0,0 +1,328 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PROFILER_RDTSC
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Most events kept for the trace, over every thread of the process
+ *        (about 40 MB), later scopes are only counted in their thread's
+ *        totals.
+ *
+ */
+constexpr size_t PROFILER_MAX_EVENTS = 1 << 20;
+
+/**
+ * @brief Events a thread takes from PROFILER_MAX_EVENTS at a time, so the
+ *        threads share the budget without contending on every scope.
+ *
+ */
+constexpr size_t PROFILER_EVENTS_PER_RESERVE = 1 << 12;
+
+/**
+ * @brief A timed scope, a complete event of the trace.
+ *
+ */
+struct ProfileEvent
+{
+    const char* name;      //!< Name of the scope (string literal).
+    const char* category;  //!< Category of the scope, e.g. "lock" (string literal).
+    int64_t     start_ns;  //!< Start (ns) since the profiler was created.
+    int64_t     dur_ns;    //!< Duration (ns).
+    uint64_t    cycles;    //!< CPU cycles (time stamp counter) spent.
+};
+
+/**
+ * @brief Running totals of a scope on one thread.
+ *
+ */
+struct ProfileTotals
+{
+    const char* name;      //!< Name of the scope.
+    const char* category;  //!< Category of the scope.
+    uint64_t    count;     //!< Number of times the scope ran.
+    int64_t     total_ns;  //!< Time (ns) spent in the scope.
+    int64_t     max_ns;    //!< Longest run (ns) of the scope.
+    uint64_t    cycles;    //!< CPU cycles spent in the scope.
+};
+
+/**
+ * @brief Records the scopes timed by the PROFILE_* macros of each thread
+ *        and exports them as a Chrome trace-event JSON file (chrome://tracing,
+ *        Perfetto).  Each thread records into a buffer of its own, so the
+ *        hot path takes no lock; the buffers are read once the threads are
+ *        joined.
+ *
+ *        The macros compile to nothing unless EVTOL_PROFILE is defined
+ *        (cmake -DEVTOL_PROFILE=ON).
+ *
+ */
+class Profiler
+{
+public:
+
+    /**
+     * @brief Profiler of the process.
+     *
+     * @return Profiler& Profiler.
+     */
+    static Profiler& Instance();
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    Profiler(const Profiler &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return Profiler&
+     */
+    Profiler &operator=(const Profiler &) = delete;
+
+    /**
+     * @brief Destroy the Profiler object.
+     *
+     */
+    virtual ~Profiler() = default;
+
+    /**
+     * @brief Records a timed scope of the calling thread.
+     *
+     * @param name Name of the scope (string literal).
+     * @param category Category of the scope (string literal).
+     * @param start_ns Start (ns), from Now().
+     * @param end_ns End (ns), from Now().
+     * @param cycles CPU cycles spent.
+     */
+    void Record(const char* name, const char* category, const int64_t start_ns, const int64_t end_ns, const uint64_t cycles);
+
+    /**
+     * @brief Names the calling thread in the trace.
+     *
+     * @param name Name of the thread.
+     */
+    void NameThread(const std::string& name);
+
+    /**
+     * @brief Writes the events of every thread as Chrome trace-event JSON.
+     *        Must be called once the profiled threads have been joined.
+     *
+     * @param path Path of the trace file.
+     * @throws std::runtime_error File could not be written.
+     */
+    void WriteTrace(const std::string& path) const;
+
+    /**
+     * @brief Prints the totals of each scope, summed over the threads, with
+     *        the busiest thread's share.  Must be called once the profiled
+     *        threads have been joined.
+     *
+     */
+    void PrintStats() const;
+
+    /**
+     * @brief Totals of each scope of each thread, by thread.
+     *
+     * @return std::vector<std::vector<ProfileTotals>> Totals of each thread.
+     */
+    std::vector<std::vector<ProfileTotals>> Totals() const;
+
+    /**
+     * @brief Number of events kept for the trace.
+     *
+     * @return size_t Number of events.
+     */
+    size_t Events() const;
+
+    /**
+     * @brief Number of events not kept for the trace, the budget was spent.
+     *
+     * @return uint64_t Number of events.
+     */
+    uint64_t Dropped() const;
+
+    /**
+     * @brief Clears the events and totals of every thread.  Must not be
+     *        called while profiled threads run.
+     *
+     */
+    void Reset();
+
+    /**
+     * @brief Time (ns) since the profiler was created.
+     *
+     * @return int64_t Time (ns).
+     */
+    int64_t Now() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _epoch).count(); }
+
+    /**
+     * @brief CPU time stamp counter, nanoseconds where there is none.
+     *
+     * @return uint64_t Cycles.
+     */
+    static uint64_t Cycles();
+
+private:
+
+    /**
+     * @brief Construct a new Profiler object.
+     *
+     */
+    Profiler();
+
+    /**
+     * @brief Events and totals of one thread.
+     *
+     */
+    struct ThreadBuffer
+    {
+        uint32_t                   tid;
+        std::string                name;
+        std::vector<ProfileEvent>  events;
+        std::vector<ProfileTotals> totals;    //!< Few scopes per thread, searched linearly.
+        uint64_t                   dropped;   //!< Events not kept for the trace.
+        size_t                     reserved;  //!< Events the thread may still keep, taken from the budget.
+    };
+
+    /**
+     * @brief Buffer of the calling thread, created the first time it records.
+     *
+     * @return ThreadBuffer& Buffer.
+     */
+    ThreadBuffer& Local();
+
+    /**
+     * @brief Time the events are timed from.
+     *
+     */
+    const std::chrono::steady_clock::time_point _epoch;
+
+    /**
+     * @brief Buffer of each thread that recorded, never freed.
+     *
+     */
+    std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+
+    /**
+     * @brief Events of PROFILER_MAX_EVENTS taken by the threads so far.
+     *
+     */
+    std::atomic<size_t> _taken;
+
+    /**
+     * @brief Locks _buffers while a thread adds its buffer.
+     *
+     */
+    mutable std::mutex _buffers_lock;
+};
+
+/**
+ * @brief Times the enclosing scope into the Profiler.
+ *
+ */
+class ProfileScope
+{
+public:
+
+    /**
+     * @brief Starts timing a scope.
+     *
+     * @param name Name of the scope (string literal).
+     * @param category Category of the scope (string literal).
+     */
+    ProfileScope(const char* name, const char* category) : _name(name),
+                                                           _category(category),
+                                                           _start_ns(Profiler::Instance().Now()),
+                                                           _start_cycles(Profiler::Cycles())
+    { }
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    ProfileScope(const ProfileScope &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return ProfileScope&
+     */
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+    /**
+     * @brief Stops timing the scope and records it.
+     *
+     */
+    ~ProfileScope()
+    {
+        const uint64_t cycles = Profiler::Cycles() - _start_cycles;
+        Profiler& profiler = Profiler::Instance();
+        profiler.Record(_name, _category, _start_ns, profiler.Now(), cycles);
+    }
+
+private:
+
+    const char*    _name;
+    const char*    _category;
+    const int64_t  _start_ns;
+    const uint64_t _start_cycles;
+};
+
+/**
+ * @brief CPU time stamp counter, nanoseconds where there is none.
+ *
+ * @return uint64_t Cycles.
+ */
+inline uint64_t Profiler::Cycles()
+{
+#ifdef PROFILER_RDTSC
+    return __rdtsc();
+#else
+    return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT_(a, b)
+
+#ifdef EVTOL_PROFILE
+
+/**
+ * @brief Times the rest of the enclosing scope.
+ *
+ */
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(_profile_scope_, __LINE__)(name, "sim")
+
+/**
+ * @brief Times acquiring a lock: locks lock (deferred) and records the wait.
+ *
+ */
+#define PROFILE_LOCK(name, lock) do { ProfileScope _profile_lock(name, "lock"); (lock).lock(); } while(0)
+
+/**
+ * @brief Names the calling thread in the trace.
+ *
+ */
+#define PROFILE_THREAD(name) Profiler::Instance().NameThread(name)
+
+#else
+
+#define PROFILE_SCOPE(name)      ((void)0)
+#define PROFILE_LOCK(name, lock) (lock).lock()
+#define PROFILE_THREAD(name)     ((void)0)
+
+#endif
+
+#endif
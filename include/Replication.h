@@ -0,0 +1,191 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "RunningStat.h"
+
+/**
+ * @brief Minimum number of replicas run before the confidence intervals
+ *        are trusted to stop a replication early.
+ *
+ */
+constexpr size_t REPLICATION_MIN_REPLICAS = 3;
+
+/**
+ * @brief Results of one vehicle type (VehicleA, VehicleB, ...) over the
+ *        replicas of a replication, one value per replica.
+ *
+ */
+struct ReplicatedMetrics
+{
+    RunningStat cruise_pct;  //!< Flight time (% of simulation time).
+    RunningStat charge_pct;  //!< Charge time (% of simulation time).
+    RunningStat qing_pct;    //!< Queueing time (% of simulation time).
+    RunningStat qing_mins;   //!< Mean queueing time per vehicle (mins).
+};
+
+/**
+ * @brief Runs independent, seeded replicas of a simulation and aggregates
+ *        the results of each vehicle type with streaming mean, variance and
+ *        95% confidence intervals.  Replicas run concurrently, several per
+ *        core since each replica mostly sleeps, and the replication stops
+ *        as soon as every interval is narrow enough.
+ *
+ */
+class Replication
+{
+public:
+
+    /**
+     * @brief Construct a new Replication object.
+     *
+     * @param num_vehicles Number of vehicles of each replica.
+     * @param num_vehicle_types Number of vehicle types.
+     * @param num_chargers Number of chargers of each replica.
+     * @param num_sites Number of sites (vertiports) the chargers are spread over.
+     * @param trips_per_min Trip requests per minute (0 flies full battery flights).
+     */
+    Replication(const unsigned short num_vehicles,
+                const unsigned short num_vehicle_types,
+                const unsigned short num_chargers,
+                const unsigned short num_sites = 1,
+                const double         trips_per_min = 0.0);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    Replication() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    Replication(const Replication &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return Replication&
+     */
+    Replication &operator=(const Replication &) = delete;
+
+    /**
+     * @brief Destroy the Replication object.
+     *
+     */
+    virtual ~Replication() = default;
+
+    /**
+     * @brief Runs replicas until the confidence interval of every metric is
+     *        within rel_width of its mean, or max_replicas have run.
+     *        Replica k is seeded from (seed, k), so a replication can be
+     *        repeated.
+     *
+     * @param sim_time_secs Duration (seconds) to run each replica.
+     * @param max_replicas Largest number of replicas to run.
+     * @param rel_width Target half width of the intervals relative to the mean.
+     * @param parallel Number of replicas run at once.
+     * @param seed Seed of the replication.
+     * @return size_t Number of replicas run.
+     */
+    size_t Run(const int64_t  sim_time_secs,
+               const size_t   max_replicas,
+               const double   rel_width,
+               const size_t   parallel,
+               const uint32_t seed);
+
+    /**
+     * @brief Checks to see if every interval is within rel_width of its mean.
+     *
+     * @param rel_width Target half width of the intervals relative to the mean.
+     * @return true  Every interval is narrow enough.
+     * @return false More replicas are needed.
+     */
+    bool Converged(const double rel_width) const;
+
+    /**
+     * @brief Number of replicas run.
+     *
+     * @return size_t Number of replicas.
+     */
+    size_t Replicas() const { return _replicas; }
+
+    /**
+     * @brief Results of each vehicle type over the replicas.
+     *
+     * @return const std::map<std::string, ReplicatedMetrics>& Results by type name.
+     */
+    const std::map<std::string, ReplicatedMetrics>& Metrics() const { return _metrics; }
+
+    /**
+     * @brief Prints the mean and 95% confidence interval of each metric of
+     *        each vehicle type to console.
+     *
+     */
+    void PrintStats() const;
+
+private:
+
+    /**
+     * @brief Runs one replica and adds its results.
+     *
+     * @param sim_time_secs Duration (seconds) to run the replica.
+     * @param seed Seed of the replica.
+     */
+    void RunReplica(const int64_t sim_time_secs, const uint32_t seed);
+
+    /**
+     * @brief Number of vehicles of each replica.
+     *
+     */
+    const unsigned short _num_vehicles;
+
+    /**
+     * @brief Number of vehicle types.
+     *
+     */
+    const unsigned short _num_vehicle_types;
+
+    /**
+     * @brief Number of chargers of each replica.
+     *
+     */
+    const unsigned short _num_chargers;
+
+    /**
+     * @brief Number of sites of each replica.
+     *
+     */
+    const unsigned short _num_sites;
+
+    /**
+     * @brief Trip requests per minute (0 flies full battery flights).
+     *
+     */
+    const double _trips_per_min;
+
+    /**
+     * @brief Guards the results while replicas finish concurrently.
+     *
+     */
+    mutable std::mutex _mutex;
+
+    /**
+     * @brief Number of replicas run.
+     *
+     */
+    size_t _replicas;
+
+    /**
+     * @brief Results of each vehicle type over the replicas.
+     *
+     */
+    std::map<std::string, ReplicatedMetrics> _metrics;
+};
+
+#endif
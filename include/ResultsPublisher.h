@@ -0,0 +1,299 @@
+#ifndef RESULTS_PUBLISHER_H
+#define RESULTS_PUBLISHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "CacheLine.h"
+#include "SimulationObject.h"
+#include "TypeStats.h"
+
+/**
+ * @brief Identifies a results segment, and the version of its layout.
+ *
+ */
+constexpr uint64_t SHARED_RESULTS_MAGIC   = 0x5345525F4C4F5445;  // "ETOL_RES"
+constexpr uint32_t SHARED_RESULTS_VERSION = 1;
+
+/**
+ * @brief Results of a vehicle type, as published.
+ *
+ */
+struct SharedTypeResults
+{
+    char           name[16];                         //!< Vehicle type name, null terminated.
+    int64_t        num_vehicles;                     //!< Number of vehicles of the type.
+    double         passenger_miles_per_min;          //!< Passenger miles per minute cruising.
+    double         faults_per_min;                   //!< Probability of fault per minute.
+    TypeStatTotals totals[NUM_TYPE_STAT_KINDS];      //!< Flights, charges and waits for a charger (by TypeStatKind).
+};
+
+/**
+ * @brief Live aggregates of a running simulation, as published.
+ *
+ */
+struct SharedResults
+{
+    int64_t           clock_ms;                        //!< Simulation time (ms) of the results.
+    uint64_t          publications;                    //!< Results published so far, these included.
+    uint32_t          done;                            //!< 1 once these are the final results of the run.
+    uint32_t          num_types;                       //!< Vehicle types in types.
+    SharedTypeResults types[TYPE_STATS_MAX_TYPES];     //!< Results of each type, ordered by name.
+};
+
+static_assert(std::is_trivially_copyable_v<SharedResults> && sizeof(SharedResults) % sizeof(uint64_t) == 0,
+              "Results are copied in and out of the segment a word at a time");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "The sequence is shared between processes");
+
+/**
+ * @brief Layout of a results segment.  The header is written once, before
+ *        the first results.  Results are guarded by a sequence lock: the
+ *        sequence is odd while they are written, and a reader whose copy
+ *        saw the same even sequence before and after has a consistent one.
+ *
+ */
+struct SharedResultsSegment
+{
+    uint64_t magic;                                                 //!< SHARED_RESULTS_MAGIC.
+    uint32_t version;                                               //!< SHARED_RESULTS_VERSION.
+    uint32_t size;                                                  //!< Size (bytes) of the segment.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> sequence;        //!< Odd while the results are written.
+    alignas(CACHE_LINE_SIZE) SharedResults         results;         //!< Latest results.
+};
+
+/**
+ * @brief Publishes the running totals of each vehicle type (TypeStats) into
+ *        a POSIX shared memory segment at a fixed interval of realtime, so
+ *        local readers (dashboards, sweep controllers) can follow a run
+ *        without parsing its output.  The segment is created and mapped
+ *        once; publishing is plain stores between two sequence updates, no
+ *        system calls and no locks.  Runs in its own thread and only reads
+ *        the relaxed atomics of the totals, so vehicles never wait on it.
+ *        The segment is unlinked when the publisher is destroyed; readers
+ *        that mapped it keep the final results.
+ *
+ */
+class ResultsPublisher : public SimulationObject
+{
+public:
+
+    /**
+     * @brief Construct a new ResultsPublisher object and creates its segment.
+     *        A segment of the same name is never taken over, readers of
+     *        another run would see its results change under them.
+     *
+     * @param name Name of the shared memory segment, e.g. "/evtol_results".
+     * @param interval_ms Duration (ms of realtime) between publications.
+     * @param context State shared by all objects of the simulation.
+     * @throws std::runtime_error Segment already exists or could not be created.
+     */
+    ResultsPublisher(const std::string& name, const int64_t interval_ms, SimulationContext& context);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    ResultsPublisher() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    ResultsPublisher(const ResultsPublisher &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return ResultsPublisher&
+     */
+    ResultsPublisher &operator=(const ResultsPublisher &) = delete;
+
+    /**
+     * @brief Unmaps and unlinks the segment.
+     *
+     */
+    virtual ~ResultsPublisher();
+
+    /**
+     * @brief Takes the vehicle types of the run.  Must be called after the
+     *        vehicles are created, before the publisher is started.
+     *
+     * @param clock_offset_ms Simulation time (ms) elapsed before the run.
+     */
+    void Prepare(const int64_t clock_offset_ms);
+
+    /**
+     * @brief Publishes the totals so far.  Only called by one thread at a
+     *        time, the publisher's own while it runs.
+     *
+     * @param clock_ms Simulation time (ms) of the totals.
+     * @param done These are the final results of the run.
+     */
+    void Publish(const int64_t clock_ms, const bool done);
+
+    /**
+     * @brief Name of the shared memory segment.
+     *
+     * @return const std::string& Name.
+     */
+    const std::string& Name() const { return _name; }
+
+    /**
+     * @brief Number of results published so far.
+     *
+     * @return uint64_t Number of publications.
+     */
+    uint64_t Publications() const { return _results.publications; }
+
+    //
+    // SimulationObject overrides
+    //
+
+    /**
+     * @brief Prints publisher statistics to console.
+     *
+     */
+    virtual void PrintStats() override;
+
+    //
+    // SimulationThread overrides
+    //
+
+    /**
+     * @brief Publishes the totals every interval until stopped.
+     *
+     */
+    virtual void Run() override;
+
+protected:
+
+    //
+    // SimulationObject overrides
+    //
+
+    /**
+     * @brief String used to uniquely identify this object.
+     *
+     * @return const std::string Header used to uniquely identify publisher.
+     */
+    virtual const std::string Header() override;
+
+    /**
+     * @brief Name of the shared memory segment.
+     *
+     */
+    const std::string _name;
+
+    /**
+     * @brief Duration (ms of realtime) between publications.
+     *
+     */
+    const int64_t _interval_ms;
+
+    /**
+     * @brief Mapped segment.
+     *
+     */
+    SharedResultsSegment* _segment;
+
+    /**
+     * @brief Vehicle types of the run, taken by Prepare().
+     *
+     */
+    std::vector<std::pair<size_t, TypeStats::TypeInfo>> _types;
+
+    /**
+     * @brief Results being published, copied into the segment.
+     *
+     */
+    SharedResults _results;
+
+    /**
+     * @brief Simulation time (ms) elapsed before the run.
+     *
+     */
+    int64_t _clock_offset_ms;
+};
+
+/**
+ * @brief Reads the results published by a ResultsPublisher, possibly of
+ *        another process.  Reads never block the publisher: a read that
+ *        overlaps a publication is retried.
+ *
+ */
+class ResultsReader
+{
+public:
+
+    /**
+     * @brief Construct a new ResultsReader object and maps the segment
+     *        (read-only).
+     *
+     * @param name Name of the shared memory segment.
+     * @throws std::runtime_error Segment could not be mapped or is not a results segment.
+     */
+    explicit ResultsReader(const std::string& name);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    ResultsReader() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    ResultsReader(const ResultsReader &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return ResultsReader&
+     */
+    ResultsReader &operator=(const ResultsReader &) = delete;
+
+    /**
+     * @brief Unmaps the segment.
+     *
+     */
+    virtual ~ResultsReader();
+
+    /**
+     * @brief Copies the latest results, once.
+     *
+     * @param results Copy of the results, consistent only when true is returned.
+     * @return true  Copy is consistent.
+     * @return false A publication overlapped the copy.
+     */
+    bool TryRead(SharedResults& results) const;
+
+    /**
+     * @brief Copies the latest results, retrying until the copy is consistent.
+     *
+     * @return SharedResults Copy of the results.
+     */
+    SharedResults Read() const;
+
+    /**
+     * @brief Sequence of the segment, advanced by 2 by each publication.
+     *
+     * @return uint64_t Sequence.
+     */
+    uint64_t Sequence() const { return _segment->sequence.load(std::memory_order_acquire); }
+
+private:
+
+    /**
+     * @brief Mapped segment.
+     *
+     */
+    const SharedResultsSegment* _segment;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef RUNNING_STAT_H
+#define RUNNING_STAT_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Streaming mean and variance of a sample (Welford's algorithm).
+ *        Values are folded in one at a time in constant space and without
+ *        the cancellation of summing squares.
+ *
+ */
+class RunningStat
+{
+public:
+
+    /**
+     * @brief Default Constructor.
+     *
+     */
+    RunningStat() = default;
+
+    /**
+     * @brief Destroy the RunningStat object.
+     *
+     */
+    virtual ~RunningStat() = default;
+
+    /**
+     * @brief Adds a value to the sample.
+     *
+     * @param value Value to add.
+     */
+    void Add(const double value)
+    {
+        ++_count;
+        const double delta = value - _mean;
+        _mean += delta / _count;
+        _m2   += delta * (value - _mean);
+    }
+
+    /**
+     * @brief Number of values added.
+     *
+     * @return uint64_t Number of values.
+     */
+    uint64_t Count() const { return _count; }
+
+    /**
+     * @brief Mean of the values added.
+     *
+     * @return double Mean (0 when empty).
+     */
+    double Mean() const { return _mean; }
+
+    /**
+     * @brief Sample variance of the values added.
+     *
+     * @return double Variance (0 with fewer than two values).
+     */
+    double Variance() const { return _count > 1 ? _m2 / (_count - 1) : 0.0; }
+
+    /**
+     * @brief Sample standard deviation of the values added.
+     *
+     * @return double Standard deviation (0 with fewer than two values).
+     */
+    double StdDev() const { return std::sqrt(Variance()); }
+
+    /**
+     * @brief Half width of the 95% confidence interval of the mean
+     *        (Student's t).
+     *
+     * @return double Half width (infinite with fewer than two values).
+     */
+    double HalfWidth() const
+    {
+        if(_count < 2)
+            return INFINITY;
+        return TCritical(_count - 1) * StdDev() / std::sqrt(double(_count));
+    }
+
+    /**
+     * @brief Two-sided 95% critical value of Student's t distribution.
+     *
+     * @param df Degrees of freedom (at least 1).
+     * @return double Critical value.
+     */
+    static double TCritical(const uint64_t df)
+    {
+        static constexpr std::array<double, 30> table = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+             2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+             2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+        if(df == 0)
+            return INFINITY;
+        if(df <= table.size())
+            return table[df - 1];
+
+        // Beyond 30 degrees of freedom the normal value is close enough
+        return 1.960;
+    }
+
+private:
+
+    /**
+     * @brief Number of values added.
+     *
+     */
+    uint64_t _count = 0;
+
+    /**
+     * @brief Mean of the values added.
+     *
+     */
+    double _mean = 0.0;
+
+    /**
+     * @brief Sum of squared differences from the mean.
+     *
+     */
+    double _m2 = 0.0;
+};
+
+#endif
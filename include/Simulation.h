@@ -1,12 +1,57 @@
 #ifndef SIMULATION_H
 #define SIMULATION_H
 
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
 #include <vector>
 
 #include "Charger.h"
+#include "ChargingModel.h"
+#include "Demand.h"
+#include "Dispatcher.h"
+#include "FleetSampler.h"
+#include "NumaTopology.h"
+#include "ResultsPublisher.h"
+#include "SimulationContext.h"
+#include "Snapshot.h"
 #include "TLockedQueue.h"
+#include "Topology.h"
 #include "Vehicle.h"
 
+/**
+ * @brief Results of the vehicles of one type (VehicleA, VehicleB, ...).
+ *
+ */
+struct VehicleTypeMetrics
+{
+    std::string name;          //!< Vehicle type name.
+    int64_t     num_vehicles;  //!< Number of vehicles of the type.
+    double      cruise_mins;   //!< Mean flight time per vehicle (mins).
+    double      charge_mins;   //!< Mean charge time per vehicle (mins).
+    double      qing_mins;     //!< Mean queueing time per vehicle (mins).
+    double      cruise_pct;    //!< Flight time (% of simulation time).
+    double      charge_pct;    //!< Charge time (% of simulation time).
+    double      qing_pct;      //!< Queueing time (% of simulation time).
+    double      distance;      //!< Total distance flown by the type (miles).
+    double      max_faults;    //!< Expected number of faults of the type.
+};
+
+/**
+ * @brief Engine a Simulation runs its fleet on.
+ * 
+ */
+enum class SimulationEngine
+{
+    THREADED,   //!< A thread per vehicle and charger in real time (reference).
+    SERIAL,     //!< Discrete events on one thread (CoroutineEngine).
+    PARALLEL    //!< Fixed time steps of vehicle cohorts on a thread per core (CohortEngine).
+};
+
+class CoroutineEngine;
+class CohortEngine;
+
 /**
  * @brief Main application that runs the simulation.  The simulation consists
  *        of running n number of Vehicles with m number of chargers for a requested
@@ -23,10 +68,12 @@ public:
      * @param num_vehicles Number of vehicles to run in simulation.
      * @param num_vehicle_types Number of vehicle types.
      * @param num_chargers Number of chargers to run in simulation.
+     * @param num_sites Number of sites (vertiports) the chargers are spread over.
      */
     Simulation(const unsigned short num_vehicles,
                const unsigned short num_vehicle_types,
-               const unsigned short num_chargers);
+               const unsigned short num_chargers,
+               const unsigned short num_sites = 1);
  
     /**
      * @brief Default Constructor (disabled).
@@ -51,7 +98,7 @@ public:
      * @brief Destroy the Simulation object.
      * 
      */
-    virtual ~Simulation() = default;
+    virtual ~Simulation();
 
     /**
      * @brief Creates random vehicles and chargers simulation objects. 
@@ -59,12 +106,226 @@ public:
      */
     size_t Create();
 
+    /**
+     * @brief Selects the engine the fleet runs on.  The serial and parallel
+     *        engines run full battery flights in simulation time, as fast 
+     *        as they can, with unbounded queues and no outages, trips, 
+     *        checkpoints or sampling.  Only the serial engine models 
+     *        maintenance.  The same seed draws the same fleet on every 
+     *        engine.  Must be called before Create().
+     * 
+     * @param engine Engine.
+     */
+    void SelectEngine(const SimulationEngine engine) { _engine = engine; }
+
+    /**
+     * @brief Engine the fleet runs on.
+     * 
+     * @return SimulationEngine Engine.
+     */
+    SimulationEngine Engine() const { return _engine; }
+
+    /**
+     * @brief Pins each vehicle and charger thread to the NUMA node of its home
+     *        site, with the sites spread over the nodes.  Degrades to a single
+     *        node on hosts without NUMA.  Must be called before Create() for
+     *        objects to be allocated on their node.
+     * 
+     */
+    void EnableNuma();
+
+    /**
+     * @brief Bounds the charging queue of every site.  A vehicle finding
+     *        its queue full waits, diverts or holds as policy says.  Holding
+     *        needs EnableTrips(), full battery flights land with no energy
+     *        to circle on.
+     * 
+     * @param capacity Maximum number of vehicles waiting at a site, 0 for no limit.
+     * @param policy What a vehicle does when the queue is full.
+     */
+    void BoundQueues(const size_t capacity, const QueueFullPolicy policy);
+
+    /**
+     * @brief Runs headless: vehicles and chargers skip their per-event 
+     *        messages and Run() prints only the results of each vehicle
+     *        type, so a batch run is pure compute.
+     * 
+     */
+    void EnableQuiet() { _context.Quiet = true; }
+
+    /**
+     * @brief Fails each charger at random, with exponentially distributed
+     *        times between failures and times to repair.  Must be called
+     *        after Create().
+     * 
+     * @param mtbf_mins Mean time (mins) a charger is in service between failures.
+     * @param mttr_mins Mean time (mins) to repair a charger.
+     */
+    void EnableOutages(const double mtbf_mins, const double mttr_mins);
+
+    /**
+     * @brief Schedules an outage of a charger, e.g. maintenance.  Must be 
+     *        called after Create().
+     * 
+     * @param charger Id of the charger.
+     * @param start_mins Start of the outage (mins into the run).
+     * @param duration_mins Length of the outage (mins).
+     */
+    void ScheduleOutage(const uint16_t charger, const int64_t start_mins, const int64_t duration_mins);
+
+    /**
+     * @brief Grounds vehicles that fault in flight until a technician has 
+     *        repaired them, and samples the fleet's availability each 
+     *        simulated minute.  Only the serial engine models maintenance,
+     *        Simulate() rejects it on the others.  Must be called before 
+     *        Create().
+     * 
+     * @param technicians Number of vehicles repaired at the same time.
+     * @param mean_repair_mins Mean time (mins) to repair a vehicle.
+     */
+    void EnableMaintenance(const uint16_t technicians, const double mean_repair_mins);
+
+    /**
+     * @brief Seeds the random number generator, so a run can be repeated.
+     *        Must be called before Create().
+     * 
+     * @param seed Seed of the random number generator.
+     */
+    void Seed(const uint32_t seed);
+
+    /**
+     * @brief Creates a simulation restored from a snapshot file, ready to Run().
+     * 
+     * @param path Snapshot file.
+     * @return std::shared_ptr<Simulation> Restored simulation.
+     * @throws std::runtime_error Snapshot could not be loaded, or holds more 
+     *                            vehicles, chargers or sites than a simulation.
+     */
+    static std::shared_ptr<Simulation> Resume(const std::string& path);
+
+    /**
+     * @brief Creates a variant of a warmed up simulation with a different 
+     *        number of chargers, ready to Run().  The variant's snapshot image
+     *        shares the records of base copy-on-write, so its checkpoints only
+     *        copy the records it changes.  The running objects are not shared:
+     *        every variant restores the whole fleet, a vehicle and a thread per
+     *        vehicle and charger, so creating one costs as much as Resume().
+     * 
+     * @param base Snapshot returned by Warmup() (or loaded from a file).
+     * @param num_chargers Number of chargers to run in the variant.
+     * @return std::shared_ptr<Simulation> Variant simulation.
+     */
+    static std::shared_ptr<Simulation> Fork(const std::shared_ptr<const Snapshot>& base,
+                                            const unsigned short num_chargers);
+
+    /**
+     * @brief Runs the simulation for sim_time_secs without printing stats and 
+     *        captures its state, to be used as the base of Fork().
+     * 
+     * @param sim_time_secs Duration (seconds) to run simulation.
+     * @return std::shared_ptr<const Snapshot> State of the simulation at sim_time_secs.
+     */
+    std::shared_ptr<const Snapshot> Warmup(const int64_t sim_time_secs);
+
+    /**
+     * @brief Creates vehicles and chargers simulation objects in the state 
+     *        saved by snapshot.  Alternative to Create().  The snapshot may 
+     *        hold a different number of chargers; vehicles on chargers beyond
+     *        this simulation's chargers are returned to the front of the queue.
+     *        The snapshot keeps each vehicle's total times only, so the
+     *        running totals (TypeStats) count, and take the shortest and
+     *        longest of, the intervals of this run only.
+     * 
+     * @param snapshot Snapshot to restore.
+     * @return size_t Number of simulation objects created.
+     * @throws std::invalid_argument Snapshot does not match the simulation configuration.
+     */
+    size_t Restore(const Snapshot& snapshot);
+
+    /**
+     * @brief Captures the full state of the simulation.  State transitions of
+     *        the simulation objects are paused only while the state is copied.
+     *        The same image is updated by each capture; only changed records
+     *        are written to it.
+     * 
+     * @return std::shared_ptr<Snapshot> Captured state.
+     */
+    std::shared_ptr<Snapshot> Capture();
+
+    /**
+     * @brief Captures the state of the simulation and writes the changes 
+     *        since the previous checkpoint to the checkpoint file.
+     * 
+     * @return size_t Number of bytes written.
+     */
+    size_t Checkpoint();
+
+    /**
+     * @brief Periodically writes checkpoints while the simulation runs.
+     * 
+     * @param path Checkpoint file.
+     * @param interval_secs Duration (seconds) between checkpoints.
+     */
+    void EnableCheckpoints(const std::string& path, const int64_t interval_secs);
+
+    /**
+     * @brief Samples the fleet while the simulation runs and writes the 
+     *        samples as a CSV time series once the run completes.
+     * 
+     * @param path Time series file.
+     * @param interval_secs Duration (seconds) between samples.
+     * @return std::shared_ptr<const FleetSampler> Sampler holding the samples of the last run.
+     */
+    std::shared_ptr<const FleetSampler> EnableSampling(const std::string& path, const int64_t interval_secs);
+
+    /**
+     * @brief Publishes the running totals of each vehicle type into a POSIX
+     *        shared memory segment while the simulation runs, for local 
+     *        readers (ResultsReader) to poll.  The final totals are 
+     *        published once the run stops.  Must be called after the 
+     *        vehicles are created (or restored).
+     * 
+     * @param name Name of the shared memory segment, e.g. "/evtol_results".
+     * @param interval_ms Duration (ms of realtime) between publications.
+     * @return std::shared_ptr<const ResultsPublisher> Publisher of the results.
+     * @throws std::runtime_error Segment could not be created.
+     */
+    std::shared_ptr<const ResultsPublisher> EnablePublishing(const std::string& name, const int64_t interval_ms);
+
+    /**
+     * @brief Vehicles fly passenger trips assigned by a dispatcher instead of
+     *        flying until their battery is empty.  Must be called after the 
+     *        vehicles are created (or restored).
+     * 
+     * @param trips_per_min Mean number of trip requests per minute over a day.
+     * @param max_wait_mins Duration (mins) a request waits before it is lost.
+     * @return std::shared_ptr<const Dispatcher> Dispatcher assigning the trips.
+     */
+    std::shared_ptr<const Dispatcher> EnableTrips(const double trips_per_min, const int64_t max_wait_mins);
+
+    /**
+     * @brief Simulation time elapsed including time elapsed before a restore.
+     * 
+     * @return int64_t Simulation time elapsed (ms).
+     */
+    int64_t Clock() const;
+
     /**
      * @brief Prints the stats for each simulation object (Vehicle, Charger) to the console.
      * 
      */
     void PrintStatsForEachSimObject() const;
 
+    /**
+     * @brief Calculates the results of each vehicle type (VehicleA, VehicleB, ...)
+     *        from the running totals of the types, O(types) however large the
+     *        fleet, so it can be called at any time during a run.
+     * 
+     * @param sim_time_secs Duration (seconds) the simulation ran.
+     * @return std::vector<VehicleTypeMetrics> Results of each type, ordered by name.
+     */
+    std::vector<VehicleTypeMetrics> MetricsForEachVehicleType(const int64_t sim_time_secs) const;
+
     /**
      * @brief Calculates and prints stats for each vehicle type (VehicleA, VehicleB, ...).
      *          * Avg Flight Time (mins)
@@ -79,18 +340,125 @@ public:
      */
     void PrintStatsForEachVehicleType(const int64_t sim_time_secs) const;
 
+    /**
+     * @brief Merges the latency histograms of each vehicle type (VehicleA, 
+     *        VehicleB, ...) and prints their distribution.
+     *          * Flight Time
+     *          * Charge Time
+     *          * Qing Time
+     * 
+     */
+    void PrintLatencyForEachVehicleType() const;
+
+    /**
+     * @brief Merges the histograms of the chargers of each site and prints 
+     *        the number of charges and the distribution of queueing time.
+     * 
+     */
+    void PrintStatsForEachSite() const;
+
+    /**
+     * @brief Prints the vehicles and chargers pinned to each NUMA node and how
+     *        many charging queue arrivals came from vehicles on other nodes.
+     *        Requires EnableNuma().
+     * 
+     */
+    void PrintStatsForEachNode() const;
+
+    /**
+     * @brief Prints the capacity of each site's charging queue and how many
+     *        vehicles found it full and waited, diverted or held.  Requires
+     *        BoundQueues().
+     * 
+     */
+    void PrintOverflowForEachSite() const;
+
+    /**
+     * @brief Prints the outages of the chargers of each site, the charges
+     *        they cut short and the vehicles moved to other sites.  
+     *        Requires EnableOutages() or ScheduleOutage().
+     * 
+     */
+    void PrintOutagesForEachSite() const;
+
+    /**
+     * @brief Prints the contention of the lock of each site's charging 
+     *        queue.  Requires a build with EVTOL_LOCK_STATS.
+     * 
+     */
+    void PrintLockStatsForEachSite() const;
+
+    /**
+     * @brief Analytical model of this simulation's fleet and chargers.  
+     *        Chargers of every site are modeled as a single pool.
+     * 
+     * @return ChargingModel Model of the charging system.
+     */
+    ChargingModel Model() const;
+
+    /**
+     * @brief Prints the queueing time of each vehicle type (VehicleA, 
+     *        VehicleB, ...) and charger utilization predicted by Model() 
+     *        next to the measured values.  The model predicts steady state;
+     *        runs shorter than a few charge cycles measure less queueing.
+     * 
+     * @param sim_time_secs Duration (seconds) the simulation ran.
+     */
+    void PrintModelForEachVehicleType(const int64_t sim_time_secs) const;
+
+    /**
+     * @brief Prints the predicted charger utilization and queueing time of 
+     *        each vehicle type for 1 to max_chargers chargers, without 
+     *        running the simulation.
+     * 
+     * @param max_chargers Largest number of chargers to predict.
+     */
+    void PrintChargerSizing(const unsigned short max_chargers) const;
+
     /**
      * @brief Runs the simulation for sim_time_secs. Each second that passes in 
      *        realtime is equivalent to one minute of simulation time, i.e. 180s
      *        of realtime is 3 hours for simulation time.  Prints stats of each
-     *        vehicle type.
+     *        vehicle type.  The serial and parallel engines run as fast as
+     *        they can instead.
      * 
      * @param sim_time_secs Duration (seconds) to run simulation.
      */
-    void Run(const int64_t sim_time_secs) const;
+    void Run(const int64_t sim_time_secs);
+
+    /**
+     * @brief Runs the simulation for sim_time_secs, checkpointing when 
+     *        enabled, without printing stats.  Run() prints the stats
+     *        afterwards; replications collect the metrics instead.
+     * 
+     * @param sim_time_secs Duration (seconds) to run simulation.
+     * @throws std::logic_error Features the selected engine does not run are enabled,
+     *         or vehicles hold without trips.
+     */
+    void Simulate(const int64_t sim_time_secs);
 
 private:
 
+    /**
+     * @brief Starts all simulation objects.
+     * 
+     */
+    void Start();
+
+    /**
+     * @brief Stops all simulation objects.  The stop is broadcast to every 
+     *        object first so all objects exit concurrently, then each is joined.
+     * 
+     */
+    void Stop();
+
+    /**
+     * @brief Sets the affinity of each vehicle and charger to the node of its
+     *        home site.
+     * 
+     */
+    void PinToNodes();
+
     /**
      * @brief Number of chargers to run in simulation.
      * 
@@ -109,6 +477,90 @@ private:
      */
     const unsigned short _num_vehicle_types;
 
+    /**
+     * @brief State shared by all simulation objects.
+     * 
+     */
+    SimulationContext _context;
+
+    /**
+     * @brief Seed of the random number generator, passed on to the other engines.
+     * 
+     */
+    uint32_t _seed;
+
+    /**
+     * @brief Random number generator used to create the simulation.
+     * 
+     */
+    std::mt19937 _gen;
+
+    /**
+     * @brief Simulation time (ms) elapsed before the simulation was restored.
+     * 
+     */
+    int64_t _clock_offset_ms;
+
+    /**
+     * @brief Realtime the simulation was started.
+     * 
+     */
+    std::chrono::steady_clock::time_point _run_start;
+
+    /**
+     * @brief Writes checkpoints (nullptr when disabled).
+     * 
+     */
+    std::unique_ptr<SnapshotWriter> _snapshot_writer;
+
+    /**
+     * @brief Image updated by Capture().
+     * 
+     */
+    std::shared_ptr<Snapshot> _image;
+
+    /**
+     * @brief Duration (seconds) between checkpoints.
+     * 
+     */
+    int64_t _checkpoint_interval_secs;
+
+    /**
+     * @brief Number of checkpoints written.
+     * 
+     */
+    uint64_t _checkpoint_generation;
+
+    /**
+     * @brief Samples the fleet (nullptr when disabled).
+     * 
+     */
+    std::shared_ptr<FleetSampler> _sampler;
+
+    /**
+     * @brief Time series file written by the sampler.
+     * 
+     */
+    std::string _sampler_path;
+
+    /**
+     * @brief Publishes the results to shared memory (nullptr when disabled).
+     * 
+     */
+    std::shared_ptr<ResultsPublisher> _publisher;
+
+    /**
+     * @brief Generates trip requests (nullptr when vehicles do not fly trips).
+     * 
+     */
+    std::unique_ptr<Demand> _demand;
+
+    /**
+     * @brief Assigns trip requests to vehicles (nullptr when vehicles do not fly trips).
+     * 
+     */
+    std::shared_ptr<Dispatcher> _dispatcher;
+
     /**
      * @brief Simulation objects that will run in simulation.
      * 
@@ -116,10 +568,64 @@ private:
     std::vector<std::shared_ptr<SimulationObject>> _sim_objs;
 
     /**
-     * @brief Vehicle charging queue.
+     * @brief Vehicles running in simulation (indexed by id).
+     * 
+     */
+    std::vector<std::shared_ptr<Vehicle>> _vehicles;
+
+    /**
+     * @brief Chargers running in simulation (indexed by id).
+     * 
+     */
+    std::vector<std::shared_ptr<Charger>> _chargers;
+
+    /**
+     * @brief Sites, each with its own charging queue.
+     * 
+     */
+    Topology _topology;
+
+    /**
+     * @brief NUMA nodes threads are pinned to (nullptr when disabled).
+     * 
+     */
+    std::unique_ptr<NumaTopology> _numa;
+
+    /**
+     * @brief Chargers have outages.
+     * 
+     */
+    bool _outages;
+
+    /**
+     * @brief Number of technicians, 0 when maintenance is disabled.
+     * 
+     */
+    uint16_t _technicians;
+
+    /**
+     * @brief Mean time (mins) to repair a vehicle.
+     * 
+     */
+    double _mean_repair_mins;
+
+    /**
+     * @brief Engine the fleet runs on.
+     * 
+     */
+    SimulationEngine _engine;
+
+    /**
+     * @brief Serial engine (nullptr unless selected).
+     * 
+     */
+    std::unique_ptr<CoroutineEngine> _serial;
+
+    /**
+     * @brief Parallel engine (nullptr unless selected).
      * 
      */
-    ChargingQ _vehicle_charging_q;
+    std::unique_ptr<CohortEngine> _parallel;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef SIMULATION_CONTEXT_H
+#define SIMULATION_CONTEXT_H
+
+#include <shared_mutex>
+
+#include "StopToken.h"
+#include "TypeStats.h"
+
+/**
+ * @brief State shared by every simulation object of a single Simulation.
+ *
+ */
+class SimulationContext
+{
+public:
+
+    /**
+     * @brief Default Constructor.
+     *
+     */
+    SimulationContext() = default;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    SimulationContext(const SimulationContext &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return SimulationContext&
+     */
+    SimulationContext &operator=(const SimulationContext &) = delete;
+
+    /**
+     * @brief Destroy the SimulationContext object.
+     *
+     */
+    virtual ~SimulationContext() = default;
+
+    /**
+     * @brief Held shared by simulation objects while they change state and
+     *        exclusively while a snapshot of the simulation is captured, so a
+     *        snapshot never observes a half completed state transition.
+     *
+     */
+    std::shared_mutex FreezeLock;
+
+    /**
+     * @brief Broadcasts a stop to every simulation object at once.
+     *
+     */
+    StopSource Shutdown;
+
+    /**
+     * @brief Running statistics of each vehicle type, recorded as the
+     *        vehicles' StopWatches stop.
+     *
+     */
+    TypeStats Stats;
+
+    /**
+     * @brief Headless run: simulation objects skip their per-event 
+     *        messages and only the final aggregates are printed.
+     *
+     */
+    bool Quiet = false;
+};
+
+#endif
@@ -4,6 +4,8 @@
 #include <iomanip>
 #include <iostream>
 
+#include "Profiler.h"
+#include "SimulationContext.h"
 #include "SimulationThread.h"
 
 class SimulationObject : public SimulationThread
@@ -11,10 +13,17 @@ class SimulationObject : public SimulationThread
 public:
 
     /**
-     * @brief Default Constructor
+     * @brief Construct a new Simulation Object object
      * 
+     * @param context State shared by all objects of the simulation.
      */
-    SimulationObject() = default;
+    explicit SimulationObject(SimulationContext& context) : _context(context) { }
+
+    /**
+     * @brief Default Constructor (disabled)
+     * 
+     */
+    SimulationObject() = delete;
 
     /**
      * @brief Default Copy Constructor (disabled)
@@ -43,6 +52,28 @@ public:
     
 protected:
 
+    /**
+     * @brief State shared by all objects of the simulation.
+     * 
+     */
+    SimulationContext& _context;
+
+    /**
+     * @brief Checks to see if per-event messages are printed.  Always false
+     *        when built with EVTOL_QUIET, so the messages compile out.
+     * 
+     * @return true  Messages are printed.
+     * @return false Run is headless.
+     */
+    bool Verbose() const
+    {
+#ifdef EVTOL_QUIET
+        return false;
+#else
+        return !_context.Quiet;
+#endif
+    }
+
     /**
      * @brief Header identifier used to identify this object.
      * 
@@ -57,6 +88,8 @@ protected:
      */
     void PrintToConsole(const std::stringstream& ss)
     {
+        PROFILE_SCOPE("PrintToConsole");
+
         tm localTime;
         std::chrono::system_clock::time_point t = std::chrono::system_clock::now();
         time_t now = std::chrono::system_clock::to_time_t(t);
@@ -2,10 +2,14 @@
 #define SIMULATION_THREAD_H
 
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
 
+#include "CacheLine.h"
+#include "StopToken.h"
+
 /**
  * @brief State of thread.
  * 
@@ -65,8 +69,10 @@ public:
     /**
      * @brief Starts the thread.
      * 
+     * @param parent Token shared by a group of threads, a stop requested on 
+     *               it also stops this thread.
      */
-    virtual void Start();
+    virtual void Start(const StopToken& parent = StopToken());
     
     /**
      * @brief Stops the thread.
@@ -74,6 +80,20 @@ public:
      */
     virtual void Stop();
 
+    /**
+     * @brief Requests the thread to stop without waiting for it to exit.
+     * 
+     */
+    void RequestStop();
+
+    /**
+     * @brief Checks to see if the thread has been requested to stop.
+     * 
+     * @return true  Thread has been requested to stop.
+     * @return false Thread has not been requested to stop.
+     */
+    bool StopRequested() const { return _stop_source.StopRequested(); }
+
     /**
      * @brief Blocks thread for duration OR signaled to exit.
      * 
@@ -85,6 +105,21 @@ public:
      */
     template<class Duration> bool WaitFor(Duration duration);
 
+    /**
+     * @brief Pins the thread to the CPUs of a NUMA node from the next Start().
+     * 
+     * @param node NUMA node of the thread.
+     * @param cpus CPUs of the node.
+     */
+    void SetAffinity(const uint16_t node, const std::vector<int>& cpus);
+
+    /**
+     * @brief NUMA node the thread is pinned to (0 when not pinned).
+     * 
+     * @return uint16_t NUMA node.
+     */
+    uint16_t Node() const { return _node; }
+
 protected:
 
     /**
@@ -94,10 +129,11 @@ protected:
     std::unique_ptr<std::thread> _thread;
 
     /**
-     * @brief Current state of thread.
+     * @brief Current state of thread.  Starts the fields locked by each 
+     *        WaitFor(), on their own cache lines.
      * 
      */
-    ThreadState _thread_state;
+    alignas(CACHE_LINE_SIZE) ThreadState _thread_state;
     
     /**
      * @brief Locks access and used to exit thread.
@@ -111,6 +147,36 @@ protected:
      */
     std::condition_variable _cv;
 
+    /**
+     * @brief Requests this thread to stop.
+     * 
+     */
+    StopSource _stop_source;
+
+    /**
+     * @brief Wakes this thread when a stop is requested.
+     * 
+     */
+    std::unique_ptr<StopCallback> _on_stop;
+
+    /**
+     * @brief Requests this thread to stop when its parent token is stopped.
+     * 
+     */
+    std::unique_ptr<StopCallback> _on_parent_stop;
+
+    /**
+     * @brief NUMA node the thread is pinned to.
+     * 
+     */
+    uint16_t _node = 0;
+
+    /**
+     * @brief CPUs the thread is pinned to (empty when not pinned).
+     * 
+     */
+    std::vector<int> _cpus;
+
 private:
 
     static void run(SimulationThread* so);
@@ -129,7 +195,7 @@ template<class Duration>
 bool SimulationThread::WaitFor(Duration duration)
 {
     std::unique_lock<std::mutex> lock(_cs);
-    return !_cv.wait_for(lock, duration, [this](){
+    return _cv.wait_for(lock, duration, [this](){
         return _thread_state == ThreadState::EXIT;
     });
 }
@@ -0,0 +1,495 @@
+#ifndef SITE_H
+#define SITE_H
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TLockedQueue.h"
+
+class Vehicle;
+
+/**
+ * @brief Lock statistics policy of the charging queues, counted when built
+ *        with EVTOL_LOCK_STATS (cmake -DEVTOL_LOCK_STATS=ON).
+ * 
+ */
+#ifdef EVTOL_LOCK_STATS
+typedef LockContentionStats ChargingQLockStats;
+#else
+typedef NoLockStats ChargingQLockStats;
+#endif
+
+typedef TLockedQueue<std::shared_ptr<Vehicle>, ChargingQLockStats> ChargingQ;
+
+/**
+ * @brief What a vehicle does when the charging queue of its site is full.
+ * 
+ */
+enum QueueFullPolicy
+{
+    BLOCK,   //!< Waits on the ground until the queue has room.
+    DIVERT,  //!< Charges at the nearest other site with room, else waits.
+    HOLD     //!< Circles until the queue has room, burning energy (trips only).
+};
+
+/**
+ * @brief A vertiport with its own pool of chargers and charging queue.
+ *        Vehicles land at a site and queue for that site's chargers only, so
+ *        each queue is shared by a single site and never by the whole fleet.
+ *
+ */
+class Site
+{
+public:
+
+    /**
+     * @brief Construct a new Site object.
+     *
+     * @param id Site identification.
+     * @param x Position east (miles).
+     * @param y Position north (miles).
+     */
+    Site(uint16_t id, float x = 0.0f, float y = 0.0f) : _id(id), _x(x), _y(y), _charging_site(this), _node(0), _queue_capacity(0), _full_policy(BLOCK), _local_arrivals(0), _remote_arrivals(0), _blocked(0), _diverted(0), _held(0), _chargers(0), _chargers_up(0), _redistributed(0) { }
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    Site() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    Site(const Site &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return Site&
+     */
+    Site &operator=(const Site &) = delete;
+
+    /**
+     * @brief Destroy the Site object.
+     *
+     */
+    virtual ~Site() = default;
+
+    /**
+     * @brief Id of this site.
+     *
+     * @return uint16_t Id of this site.
+     */
+    uint16_t ID() const { return _id; }
+
+    /**
+     * @brief Name of this site.
+     *
+     * @return const std::string Name of this site.
+     */
+    const std::string Name() const { return "Site " + std::to_string(_id); }
+
+    /**
+     * @brief Position east (miles).
+     *
+     * @return float Position east (miles).
+     */
+    float X() const { return _x; }
+
+    /**
+     * @brief Position north (miles).
+     *
+     * @return float Position north (miles).
+     */
+    float Y() const { return _y; }
+
+    /**
+     * @brief Straight line distance to another site.
+     *
+     * @param other Other site.
+     * @return float Distance (miles).
+     */
+    float Distance(const Site& other) const { return std::hypot(other._x - _x, other._y - _y); }
+
+    /**
+     * @brief Adds a route flown from this site.  Must be called before the
+     *        simulation is started.
+     *
+     * @param destination Site the route flies to.
+     */
+    void AddRoute(Site& destination) { _routes.push_back(&destination); }
+
+    /**
+     * @brief Site a vehicle departing this site flies to.  Each vehicle
+     *        always takes the same route from a site, so routing needs no
+     *        shared state.
+     *
+     * @param vehicle_id Id of departing vehicle.
+     * @return Site& Destination (this site when no routes).
+     */
+    Site& Route(uint16_t vehicle_id) { return _routes.empty() ? *this : *_routes[vehicle_id % _routes.size()]; }
+
+    /**
+     * @brief Sets the site vehicles landing here charge at.  Must be called
+     *        before the simulation is started.
+     *
+     * @param site Nearest site with chargers (this site when it has any).
+     */
+    void SetChargingSite(Site& site) { _charging_site = &site; }
+
+    /**
+     * @brief Site vehicles landing here charge at.  Sites without chargers
+     *        hand vehicles on to the nearest site with chargers.
+     *
+     * @return Site& Site to charge at.
+     */
+    Site& ChargingSite() const { return *_charging_site; }
+
+    /**
+     * @brief Adds a site vehicles are diverted to when the queue is full,
+     *        nearest first.  Must be called before the simulation is started.
+     *
+     * @param site Another site with chargers.
+     */
+    void AddDivertSite(Site& site) { _divert_sites.push_back(&site); }
+
+    /**
+     * @brief Sites vehicles are diverted to when the queue is full.
+     *
+     * @return const std::vector<Site*>& Other sites with chargers, nearest first.
+     */
+    const std::vector<Site*>& DivertSites() const { return _divert_sites; }
+
+    /**
+     * @brief Bounds the charging queue.  Must be called before the simulation
+     *        is started.
+     *
+     * @param capacity Maximum number of vehicles waiting, 0 for no limit.
+     * @param policy What a vehicle does when the queue is full.
+     */
+    void SetQueueCapacity(size_t capacity, QueueFullPolicy policy)
+    {
+        _queue_capacity = capacity;
+        _full_policy    = policy;
+    }
+
+    /**
+     * @brief Maximum number of vehicles waiting for a charger.
+     *
+     * @return size_t Capacity, 0 for no limit.
+     */
+    size_t QueueCapacity() const { return _queue_capacity; }
+
+    /**
+     * @brief What a vehicle does when the charging queue is full.
+     *
+     * @return QueueFullPolicy Policy.
+     */
+    QueueFullPolicy FullPolicy() const { return _full_policy; }
+
+    /**
+     * @brief Adds a vehicle to the charging queue unless it is full, or 
+     *        every charger is out of service and another site has one in
+     *        service.  Checked under the queue's lock, so a vehicle is never
+     *        queued after the last charger redistributed the queue.
+     *
+     * @param vehicle Vehicle needing charged.
+     * @param front Vehicle was interrupted by an outage, it is next in line
+     *              and the capacity does not apply.
+     * @return true  Vehicle is queued.
+     * @return false Queue is full or site is down, vehicle was not queued.
+     */
+    bool Join(std::shared_ptr<Vehicle> vehicle, const bool front = false)
+    {
+        return Queue.try_enqueue_if(std::move(vehicle), [this, front](size_t size) {
+            if(Down() && &Fallback() != this)
+                return false;
+            return front || _queue_capacity == 0 || size < _queue_capacity;
+        }, front);
+    }
+
+    /**
+     * @brief Adds the vehicles waiting at a site whose chargers are all out
+     *        of service to the charging queue, in order, as many as it has 
+     *        room for.  None are added while this site is down too.  
+     *        Checked under the queue's lock, as Join() is.
+     *
+     * @tparam InputIt Input iterator (move iterator to move vehicles in).
+     * @param first First vehicle to add.
+     * @param last End of vehicles to add.
+     * @return size_t Number of vehicles added, from first.
+     */
+    template <typename InputIt> size_t JoinBulk(InputIt first, InputIt last)
+    {
+        return Queue.enqueue_bulk_if(first, last, [this](size_t size) -> size_t {
+            if(Down())
+                return 0;
+            if(_queue_capacity == 0)
+                return SIZE_MAX;
+            return size < _queue_capacity ? _queue_capacity - size : 0;
+        });
+    }
+
+    /**
+     * @brief Counts a vehicle finding the queue full, by what it did.
+     *
+     * @param policy What the vehicle did (DIVERT when it went elsewhere).
+     */
+    void CountFull(QueueFullPolicy policy)
+    {
+        (policy == DIVERT ? _diverted : policy == HOLD ? _held : _blocked).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of vehicles that found the queue full and waited on the
+     *        ground for room.
+     *
+     * @return uint64_t Number of vehicles.
+     */
+    uint64_t Blocked() const { return _blocked.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of vehicles that found the queue full and charged at
+     *        another site.
+     *
+     * @return uint64_t Number of vehicles.
+     */
+    uint64_t Diverted() const { return _diverted.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of vehicles that found the queue full and circled until
+     *        it had room.
+     *
+     * @return uint64_t Number of vehicles.
+     */
+    uint64_t Held() const { return _held.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Counts a charger installed at this site, in service.
+     *
+     */
+    void AddCharger()
+    {
+        _chargers.fetch_add(1, std::memory_order_relaxed);
+        _chargers_up.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts a charger of this site going out of service.
+     *
+     * @return true  It was the last charger in service.
+     * @return false Other chargers are still in service.
+     */
+    bool ChargerDown() { return _chargers_up.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    /**
+     * @brief Counts a charger of this site coming back into service.
+     *
+     */
+    void ChargerUp() { _chargers_up.fetch_add(1, std::memory_order_acq_rel); }
+
+    /**
+     * @brief Number of chargers of this site in service.
+     *
+     * @return uint16_t Number of chargers.
+     */
+    uint16_t ChargersUp() const { return _chargers_up.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Checks to see if every charger of this site is out of service.
+     *
+     * @return true  Site has chargers and none is in service.
+     * @return false A charger is in service (or none are installed).
+     */
+    bool Down() const { return _chargers.load(std::memory_order_relaxed) > 0 && ChargersUp() == 0; }
+
+    /**
+     * @brief Site to charge at while this one is down: the nearest divert
+     *        site with a charger in service.
+     *
+     * @return Site& Site to charge at (this site when none is up).
+     */
+    Site& Fallback()
+    {
+        for(Site* other : _divert_sites)
+        {
+            if(other->ChargersUp() > 0)
+                return *other;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Counts vehicles moved from this site's queue to another site
+     *        because every charger went out of service.
+     *
+     * @param count Number of vehicles moved.
+     */
+    void CountRedistributed(uint64_t count) { _redistributed.fetch_add(count, std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of vehicles moved from this site's queue to another
+     *        site because every charger went out of service.
+     *
+     * @return uint64_t Number of vehicles.
+     */
+    uint64_t Redistributed() const { return _redistributed.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Sets the NUMA node the chargers and queue of this site live on.
+     *        Must be called before the simulation is started.
+     *
+     * @param node NUMA node.
+     */
+    void SetNode(uint16_t node) { _node = node; }
+
+    /**
+     * @brief NUMA node the chargers and queue of this site live on.
+     *
+     * @return uint16_t NUMA node.
+     */
+    uint16_t Node() const { return _node; }
+
+    /**
+     * @brief Counts a vehicle joining the queue, by whether the vehicle's
+     *        thread runs on this site's node.
+     *
+     * @param node NUMA node of the arriving vehicle.
+     */
+    void CountArrival(uint16_t node)
+    {
+        (node == _node ? _local_arrivals : _remote_arrivals).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of queue arrivals from vehicles on this site's node.
+     *
+     * @return uint64_t Number of arrivals.
+     */
+    uint64_t LocalArrivals() const { return _local_arrivals.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of queue arrivals from vehicles on another node, each
+     *        moving the queue's cache lines across nodes.
+     *
+     * @return uint64_t Number of arrivals.
+     */
+    uint64_t RemoteArrivals() const { return _remote_arrivals.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Vehicles waiting for a charger at this site.
+     *
+     */
+    ChargingQ Queue;
+
+private:
+
+    /**
+     * @brief Id of this site.
+     *
+     */
+    const uint16_t _id;
+
+    /**
+     * @brief Position east (miles).
+     *
+     */
+    const float _x;
+
+    /**
+     * @brief Position north (miles).
+     *
+     */
+    const float _y;
+
+    /**
+     * @brief Routes flown from this site.
+     *
+     */
+    std::vector<Site*> _routes;
+
+    /**
+     * @brief Site vehicles landing here charge at.
+     *
+     */
+    Site* _charging_site;
+
+    /**
+     * @brief Other sites with chargers, nearest first.
+     *
+     */
+    std::vector<Site*> _divert_sites;
+
+    /**
+     * @brief NUMA node the chargers and queue of this site live on.
+     *
+     */
+    uint16_t _node;
+
+    /**
+     * @brief Maximum number of vehicles waiting, 0 for no limit.
+     *
+     */
+    size_t _queue_capacity;
+
+    /**
+     * @brief What a vehicle does when the queue is full.
+     *
+     */
+    QueueFullPolicy _full_policy;
+
+    /**
+     * @brief Number of queue arrivals from vehicles on this site's node.
+     *
+     */
+    std::atomic<uint64_t> _local_arrivals;
+
+    /**
+     * @brief Number of queue arrivals from vehicles on another node.
+     *
+     */
+    std::atomic<uint64_t> _remote_arrivals;
+
+    /**
+     * @brief Number of vehicles that waited on the ground for room.
+     *
+     */
+    std::atomic<uint64_t> _blocked;
+
+    /**
+     * @brief Number of vehicles diverted to another site.
+     *
+     */
+    std::atomic<uint64_t> _diverted;
+
+    /**
+     * @brief Number of vehicles that circled until there was room.
+     *
+     */
+    std::atomic<uint64_t> _held;
+
+    /**
+     * @brief Number of chargers installed.
+     *
+     */
+    std::atomic<uint16_t> _chargers;
+
+    /**
+     * @brief Number of chargers in service.
+     *
+     */
+    std::atomic<uint16_t> _chargers_up;
+
+    /**
+     * @brief Number of vehicles moved to another site by outages.
+     *
+     */
+    std::atomic<uint64_t> _redistributed;
+};
+
+#endif
@@ -0,0 +1,602 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Identifies a simulation snapshot file ("EVTS").
+ *
+ */
+constexpr uint32_t SNAPSHOT_MAGIC = 0x53545645;
+
+/**
+ * @brief Version of the snapshot layout.
+ *
+ */
+constexpr uint16_t SNAPSHOT_VERSION = 4;
+
+/**
+ * @brief Number of 32-bit words needed to hold the std::mt19937 state.
+ *
+ */
+constexpr size_t SNAPSHOT_RNG_WORDS = 625;
+
+/**
+ * @brief Number of slots of a snapshot file.  Writes alternate between the
+ *        slots, so the previous snapshot stays intact while the next one is
+ *        written.
+ *
+ */
+constexpr size_t SNAPSHOT_SLOTS = 2;
+
+/**
+ * @brief Saved state of a StopWatch.
+ *
+ */
+struct StopWatchRecord
+{
+    int64_t total_secs;
+    int64_t elapsed_ms;     // Elapsed time of a running StopWatch, -1 when stopped
+};
+
+/**
+ * @brief Fixed-size snapshot header.
+ *
+ */
+struct SnapshotHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t num_vehicle_types;
+    uint32_t num_vehicles;
+    uint32_t num_chargers;
+    uint64_t generation;    // Incremented on every write
+    uint64_t sequence;      // Stamped by SnapshotWriter, the slot with the highest valid sequence is loaded
+    uint64_t checksum;      // Of the header (with checksum 0) and the records, stamped by SnapshotWriter
+    int64_t  clock_ms;      // Simulation time elapsed (1 ms realtime == 1 ms of simulated minutes)
+    uint32_t queue_length;  // Queues of every site, in site order
+    uint32_t num_sites;
+    uint32_t rng_words;
+    uint32_t rng[SNAPSHOT_RNG_WORDS];
+};
+
+/**
+ * @brief Fixed-size saved state of a Vehicle.
+ *
+ */
+struct VehicleRecord
+{
+    uint16_t id;
+    uint8_t  type;
+    uint8_t  state;
+    uint16_t site;          // Site the vehicle is at, or flying to
+    uint16_t reserved;
+    float    energy;        // Energy (kWh) left in the battery
+    int32_t  leg_mins;      // Duration of the current flight
+    StopWatchRecord cruising;
+    StopWatchRecord charging;
+    StopWatchRecord qing;
+};
+
+/**
+ * @brief Fixed-size saved state of a Charger.
+ *
+ */
+struct ChargerRecord
+{
+    uint16_t id;
+    uint16_t site;
+    int32_t  vehicle_id;    // Vehicle being charged, -1 when idle
+};
+
+static_assert(sizeof(VehicleRecord) == 64, "VehicleRecord layout changed");
+static_assert(sizeof(ChargerRecord) == 8,  "ChargerRecord layout changed");
+
+/**
+ * @brief Compact binary image of the full state of a simulation.  The image
+ *        is a header followed by fixed-size vehicle, charger and queue
+ *        records so that it can be mapped straight from a file and so that
+ *        successive images can be diffed record by record.
+ *
+ *        Records are stored in segments that are shared copy-on-write between
+ *        a snapshot and its forks; a segment is only copied once a record in
+ *        it is changed.
+ *
+ */
+class Snapshot
+{
+public:
+
+    /**
+     * @brief Construct a new, zeroed Snapshot object.
+     *
+     * @param num_vehicles Number of vehicle records.
+     * @param num_chargers Number of charger records.
+     */
+    Snapshot(const uint32_t num_vehicles,
+             const uint32_t num_chargers);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    Snapshot() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    Snapshot(const Snapshot &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return Snapshot&
+     */
+    Snapshot &operator=(const Snapshot &) = delete;
+
+    /**
+     * @brief Destroy the Snapshot object.
+     *
+     */
+    virtual ~Snapshot() = default;
+
+    /**
+     * @brief Maps a snapshot file into memory (read-only), the slot holding
+     *        the latest snapshot whose checksum is intact.
+     *
+     * @param path Snapshot file.
+     * @return std::shared_ptr<const Snapshot> Loaded snapshot.
+     * @throws std::runtime_error File could not be mapped or has no valid snapshot.
+     */
+    static std::shared_ptr<const Snapshot> Load(const std::string& path);
+
+    /**
+     * @brief Checksum of a raw image, with the checksum of its header taken as 0.
+     *
+     * @param f Visitor of the segments of the image, see ForEachSegment().
+     * @return uint64_t Checksum.
+     */
+    template<typename F> static uint64_t Checksum(F for_each_segment);
+
+    /**
+     * @brief Checksum of this snapshot's raw image.
+     *
+     * @return uint64_t Checksum.
+     */
+    uint64_t Checksum() const { return Checksum([this](auto f) { ForEachSegment(f); }); }
+
+    /**
+     * @brief Distance (bytes) between the slots of a snapshot file holding
+     *        images of size bytes (rounded up to a page, so each slot can be
+     *        mapped on its own).
+     *
+     * @param size Size of image in bytes.
+     * @return size_t Size of a slot in bytes.
+     */
+    static size_t SlotSize(const size_t size);
+
+    /**
+     * @brief Finds the slot of a snapshot file holding the latest valid
+     *        snapshot: magic, version, size and checksum all match.
+     *
+     * @param file Contents of the file.
+     * @param file_size Size of the file in bytes.
+     * @return int Slot (-1 when no slot is valid).
+     */
+    static int LatestSlot(const uint8_t* file, const size_t file_size);
+
+    /**
+     * @brief Size (bytes) of an image holding the requested number of records.
+     *
+     * @param num_vehicles Number of vehicle records.
+     * @param num_chargers Number of charger records.
+     * @return size_t Size of image in bytes.
+     */
+    static size_t ImageSize(const uint32_t num_vehicles,
+                            const uint32_t num_chargers);
+
+    /**
+     * @brief Creates a copy-on-write fork of this snapshot.  Vehicle and queue
+     *        records are shared until changed; charger records are resized to
+     *        num_chargers (new chargers are idle).
+     *
+     * @param num_chargers Number of charger records of the fork.
+     * @return std::shared_ptr<Snapshot> Forked snapshot.
+     */
+    std::shared_ptr<Snapshot> Fork(const uint32_t num_chargers) const;
+
+    //
+    // Properties
+    //
+
+    /**
+     * @brief Snapshot header.
+     *
+     * @return SnapshotHeader& Snapshot header.
+     */
+    const SnapshotHeader& Header() const { return *reinterpret_cast<const SnapshotHeader*>(_segments[0].data.get()); }
+    SnapshotHeader& Header() { return *reinterpret_cast<SnapshotHeader*>(_segments[0].data.get()); }
+
+    /**
+     * @brief Saved state of the i'th vehicle.
+     *
+     * @param i Index of vehicle.
+     * @return VehicleRecord& Saved state of vehicle.
+     */
+    const VehicleRecord& VehicleAt(size_t i) const { return *Record<VehicleRecord>(_vehicle_segs, i); }
+    VehicleRecord& VehicleAt(size_t i) { return *MutableRecord<VehicleRecord>(_vehicle_segs, i); }
+
+    /**
+     * @brief Saved state of the i'th charger.
+     *
+     * @param i Index of charger.
+     * @return ChargerRecord& Saved state of charger.
+     */
+    const ChargerRecord& ChargerAt(size_t i) const { return *Record<ChargerRecord>(_charger_segs, i); }
+    ChargerRecord& ChargerAt(size_t i) { return *MutableRecord<ChargerRecord>(_charger_segs, i); }
+
+    /**
+     * @brief Vehicle id of the i'th entry of the charging queue (front first).
+     *
+     * @param i Position in charging queue.
+     * @return uint32_t& Vehicle id.
+     */
+    const uint32_t& QueueAt(size_t i) const { return *Record<uint32_t>(_queue_segs, i); }
+    uint32_t& QueueAt(size_t i) { return *MutableRecord<uint32_t>(_queue_segs, i); }
+
+    /**
+     * @brief Sets the i'th record of type R, copying its segment only if the
+     *        record changed.
+     *
+     * @tparam R VehicleRecord, ChargerRecord or uint32_t (queue entry).
+     * @param i Index of record.
+     * @param rec New value of record.
+     * @return true  Record changed.
+     * @return false Record is unchanged.
+     */
+    template<typename R> bool Set(size_t i, const R& rec);
+
+    /**
+     * @brief Size of raw image.
+     *
+     * @return size_t Size of image in bytes.
+     */
+    size_t Size() const { return ImageSize(_num_vehicles, _num_chargers); }
+
+    /**
+     * @brief Number of bytes of records still shared with another snapshot.
+     *
+     * @return size_t Number of shared bytes.
+     */
+    size_t SharedBytes() const;
+
+    /**
+     * @brief Visits each contiguous segment of the raw image in order.
+     *
+     * @tparam F void(size_t offset, const uint8_t* data, size_t size)
+     * @param f Visitor.
+     */
+    template<typename F> void ForEachSegment(F f) const;
+
+private:
+
+    /**
+     * @brief Contiguous part of the raw image.
+     *
+     */
+    struct Segment
+    {
+        size_t offset;
+        size_t size;
+        std::shared_ptr<uint8_t> data;
+    };
+
+    /**
+     * @brief Records of one type: the first segment and records per segment.
+     *
+     */
+    struct Region
+    {
+        size_t first;
+        size_t per_segment;
+    };
+
+    /**
+     * @brief Construct a Snapshot object whose segments view a contiguous 
+     *        image (a mapped file), or are zeroed when image is nullptr.
+     *
+     * @param num_vehicles Number of vehicle records.
+     * @param num_chargers Number of charger records.
+     * @param image Contiguous image or nullptr.
+     */
+    Snapshot(const uint32_t num_vehicles,
+             const uint32_t num_chargers,
+             const std::shared_ptr<uint8_t>& image);
+
+    /**
+     * @brief Construct a copy-on-write fork of base.
+     *
+     * @param base Snapshot to fork.
+     * @param num_chargers Number of charger records of the fork.
+     */
+    Snapshot(const Snapshot& base,
+             const uint32_t  num_chargers);
+
+    /**
+     * @brief Appends segments holding count records.  Segments view image at
+     *        the current end of the layout, or are zeroed when image is nullptr.
+     *
+     * @param count Number of records.
+     * @param size Size of a record.
+     * @param per_segment Records per segment.
+     * @param image Contiguous image or nullptr.
+     * @return Region Region of the appended segments.
+     */
+    Region AddRegion(size_t count, size_t size, size_t per_segment, const std::shared_ptr<uint8_t>& image);
+
+    /**
+     * @brief Recalculates the offset of each segment.
+     *
+     */
+    void Layout();
+
+    /**
+     * @brief Pointer to the i'th record of a region.
+     *
+     */
+    template<typename R> const R* Record(const Region& region, size_t i) const
+    {
+        const Segment& seg = _segments[region.first + i / region.per_segment];
+        return reinterpret_cast<const R*>(seg.data.get()) + i % region.per_segment;
+    }
+
+    /**
+     * @brief Pointer to the i'th record of a region, copying its segment 
+     *        first when the segment is shared.
+     *
+     */
+    template<typename R> R* MutableRecord(const Region& region, size_t i)
+    {
+        Segment& seg = _segments[region.first + i / region.per_segment];
+        if(seg.data.use_count() > 1)
+            Unshare(seg);
+        return reinterpret_cast<R*>(seg.data.get()) + i % region.per_segment;
+    }
+
+    /**
+     * @brief Replaces a shared segment with a private copy.
+     *
+     * @param seg Segment to copy.
+     */
+    static void Unshare(Segment& seg);
+
+    /**
+     * @brief Region holding records of type R.
+     *
+     */
+    template<typename R> const Region& RegionOf() const;
+
+    /**
+     * @brief Number of vehicle records.
+     *
+     */
+    uint32_t _num_vehicles;
+
+    /**
+     * @brief Number of charger records.
+     *
+     */
+    uint32_t _num_chargers;
+
+    /**
+     * @brief Segments of the raw image in order (header first).
+     *
+     */
+    std::vector<Segment> _segments;
+
+    /**
+     * @brief Vehicle records.
+     *
+     */
+    Region _vehicle_segs;
+
+    /**
+     * @brief Charger records.
+     *
+     */
+    Region _charger_segs;
+
+    /**
+     * @brief Charging queue entries.
+     *
+     */
+    Region _queue_segs;
+};
+
+template<> inline const Snapshot::Region& Snapshot::RegionOf<VehicleRecord>() const { return _vehicle_segs; }
+template<> inline const Snapshot::Region& Snapshot::RegionOf<ChargerRecord>() const { return _charger_segs; }
+template<> inline const Snapshot::Region& Snapshot::RegionOf<uint32_t>() const { return _queue_segs; }
+
+/**
+ * @brief Sets the i'th record of type R, copying its segment only if the
+ *        record changed.
+ *
+ * @tparam R VehicleRecord, ChargerRecord or uint32_t (queue entry).
+ * @param i Index of record.
+ * @param rec New value of record.
+ * @return true  Record changed.
+ * @return false Record is unchanged.
+ */
+template<typename R>
+inline bool Snapshot::Set(size_t i, const R& rec)
+{
+    const Region& region = RegionOf<R>();
+    if(std::memcmp(Record<R>(region, i), &rec, sizeof(R)) == 0)
+        return false;
+
+    *MutableRecord<R>(region, i) = rec;
+    return true;
+}
+
+/**
+ * @brief Visits each contiguous segment of the raw image in order.
+ *
+ * @tparam F void(size_t offset, const uint8_t* data, size_t size)
+ * @param f Visitor.
+ */
+template<typename F>
+inline void Snapshot::ForEachSegment(F f) const
+{
+    for(auto const& seg : _segments)
+        f(seg.offset, static_cast<const uint8_t*>(seg.data.get()), seg.size);
+}
+
+/**
+ * @brief Checksum of a raw image, with the checksum of its header taken as 0.
+ *
+ * @tparam F void(G) where G is void(size_t offset, const uint8_t* data, size_t size)
+ * @param for_each_segment Visitor of the segments of the image, see ForEachSegment().
+ * @return uint64_t Checksum.
+ */
+template<typename F>
+inline uint64_t Snapshot::Checksum(F for_each_segment)
+{
+    // FNV-1a over the bytes of the image
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto add = [&hash](const uint8_t* data, size_t size) {
+        for(size_t i = 0; i < size; ++i)
+            hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    };
+
+    for_each_segment([&](size_t offset, const uint8_t* data, size_t size) {
+        if(offset == 0)
+        {
+            SnapshotHeader header;
+            std::memcpy(&header, data, sizeof(SnapshotHeader));
+            header.checksum = 0;
+            add(reinterpret_cast<const uint8_t*>(&header), sizeof(SnapshotHeader));
+            add(data + sizeof(SnapshotHeader), size - sizeof(SnapshotHeader));
+        }
+        else
+        {
+            add(data, size);
+        }
+    });
+
+    return hash;
+}
+
+/**
+ * @brief Writes snapshots to a file incrementally.  The file holds two
+ *        slots (SNAPSHOT_SLOTS) written in turn, so a crash while writing
+ *        one leaves the other, the previous snapshot, intact.  Only the
+ *        records that changed since the slot was last written are written;
+ *        the records are synced before the header, and the header carries
+ *        a checksum of the whole snapshot that Snapshot::Load() verifies.
+ *
+ */
+class SnapshotWriter
+{
+public:
+
+    /**
+     * @brief Construct a new SnapshotWriter object.
+     *
+     * @param path Snapshot file (created if missing).  A valid snapshot
+     *             already in the file is kept until the first write is synced.
+     * @throws std::runtime_error File could not be opened.
+     */
+    explicit SnapshotWriter(const std::string& path);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    SnapshotWriter() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    SnapshotWriter(const SnapshotWriter &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return SnapshotWriter&
+     */
+    SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+    /**
+     * @brief Destroy the SnapshotWriter object.  Closes the file.
+     *
+     */
+    virtual ~SnapshotWriter();
+
+    /**
+     * @brief Writes the records of snapshot that differ from the snapshot
+     *        last written to the next slot, syncs them, then writes the
+     *        header and syncs the file.
+     *
+     * @param snapshot Snapshot to write.
+     * @return size_t Number of bytes written.
+     * @throws std::runtime_error Write failed.
+     */
+    size_t Write(const Snapshot& snapshot);
+
+    /**
+     * @brief Path of snapshot file.
+     *
+     * @return const std::string& Path of snapshot file.
+     */
+    const std::string& Path() const { return _path; }
+
+private:
+
+    /**
+     * @brief Writes a range of the image to an offset in the file.
+     *
+     * @param data Start of range.
+     * @param offset Offset in file.
+     * @param size Number of bytes to write.
+     */
+    void WriteRange(const uint8_t* data, size_t offset, size_t size);
+
+    /**
+     * @brief Path of snapshot file.
+     *
+     */
+    const std::string _path;
+
+    /**
+     * @brief Snapshot file descriptor.
+     *
+     */
+    int _fd;
+
+    /**
+     * @brief Syncs the data written to the file.
+     *
+     */
+    void Sync();
+
+    /**
+     * @brief Image last written to each slot.
+     *
+     */
+    std::array<std::vector<uint8_t>, SNAPSHOT_SLOTS> _previous;
+
+    /**
+     * @brief Sequence of the last write.
+     *
+     */
+    uint64_t _sequence;
+};
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Uniform grid over points in the plane, for nearest neighbour
+ *        queries.  Points are identified by a dense id (e.g. an index into a
+ *        vector of vehicles).  Inserting, moving and removing a point are
+ *        O(1); a nearest query searches rings of cells outwards from the
+ *        query point and stops once no closer point can exist.
+ *
+ *        Not thread-safe; an index is owned by a single thread.
+ *
+ */
+class SpatialIndex
+{
+public:
+
+    /**
+     * @brief Construct a new SpatialIndex object.
+     *
+     * @param cell_size Width of a grid cell (miles).  Queries are fastest when
+     *                  a cell holds a few points.
+     */
+    explicit SpatialIndex(const float cell_size);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    SpatialIndex() = delete;
+
+    /**
+     * @brief Destroy the SpatialIndex object.
+     *
+     */
+    virtual ~SpatialIndex() = default;
+
+    /**
+     * @brief Adds a point, or moves it when already present.
+     *
+     * @param id Point identification.
+     * @param x Position east (miles).
+     * @param y Position north (miles).
+     */
+    void Insert(const uint32_t id, const float x, const float y);
+
+    /**
+     * @brief Moves a point.  Only changes cells when the point leaves its cell.
+     *
+     * @param id Point identification.
+     * @param x Position east (miles).
+     * @param y Position north (miles).
+     */
+    void Move(const uint32_t id, const float x, const float y) { Insert(id, x, y); }
+
+    /**
+     * @brief Removes a point (no-op when not present).
+     *
+     * @param id Point identification.
+     */
+    void Remove(const uint32_t id);
+
+    /**
+     * @brief Checks to see if a point is present.
+     *
+     * @param id Point identification.
+     * @return true  Point is present.
+     * @return false Point is not present.
+     */
+    bool Contains(const uint32_t id) const { return id < _points.size() && _points[id].present; }
+
+    /**
+     * @brief Number of points.
+     *
+     * @return size_t Number of points.
+     */
+    size_t Size() const { return _size; }
+
+    /**
+     * @brief Removes every point.
+     *
+     */
+    void Clear();
+
+    /**
+     * @brief Nearest point accepted by a predicate.
+     *
+     * @tparam Accept bool(uint32_t id)
+     * @param x Position east (miles).
+     * @param y Position north (miles).
+     * @param accept Returns true for the points that may be returned.
+     * @return int64_t Id of the nearest accepted point, -1 when none.
+     */
+    template<class Accept> int64_t Nearest(const float x, const float y, Accept accept) const;
+
+    /**
+     * @brief Nearest point.
+     *
+     * @param x Position east (miles).
+     * @param y Position north (miles).
+     * @return int64_t Id of the nearest point, -1 when empty.
+     */
+    int64_t Nearest(const float x, const float y) const { return Nearest(x, y, [](uint32_t) { return true; }); }
+
+private:
+
+    /**
+     * @brief A point and where it is stored in its cell.
+     *
+     */
+    struct Point
+    {
+        float    x;
+        float    y;
+        int64_t  cell;
+        uint32_t slot;
+        bool     present;
+    };
+
+    /**
+     * @brief Cell coordinate of a position.
+     *
+     * @param v Position (miles).
+     * @return int32_t Cell coordinate.
+     */
+    int32_t CellOf(const float v) const { return int32_t(std::floor(v / _cell_size)); }
+
+    /**
+     * @brief Key of the cell at cell coordinates.
+     *
+     * @param cx Cell coordinate east.
+     * @param cy Cell coordinate north.
+     * @return int64_t Key of cell.
+     */
+    static int64_t Key(const int32_t cx, const int32_t cy) { return (int64_t(cx) << 32) | uint32_t(cy); }
+
+    /**
+     * @brief Width of a grid cell (miles).
+     *
+     */
+    const float _cell_size;
+
+    /**
+     * @brief Points (indexed by id).
+     *
+     */
+    std::vector<Point> _points;
+
+    /**
+     * @brief Ids of the points in each occupied cell.
+     *
+     */
+    std::unordered_map<int64_t, std::vector<uint32_t>> _cells;
+
+    /**
+     * @brief Number of points.
+     *
+     */
+    size_t _size;
+
+    /**
+     * @brief Bounds of the cells ever occupied, so searches of sparse grids end.
+     *
+     */
+    int32_t _min_cx, _max_cx, _min_cy, _max_cy;
+};
+
+/**
+ * @brief Nearest point accepted by a predicate.
+ *
+ * @tparam Accept bool(uint32_t id)
+ * @param x Position east (miles).
+ * @param y Position north (miles).
+ * @param accept Returns true for the points that may be returned.
+ * @return int64_t Id of the nearest accepted point, -1 when none.
+ */
+template<class Accept>
+int64_t SpatialIndex::Nearest(const float x, const float y, Accept accept) const
+{
+    if(_size == 0)
+        return -1;
+
+    const int32_t cx = CellOf(x);
+    const int32_t cy = CellOf(y);
+
+    // Rings beyond this radius hold no cells that were ever occupied
+    const int32_t max_ring = std::max({ cx - _min_cx, _max_cx - cx, cy - _min_cy, _max_cy - cy, 0 });
+
+    int64_t best = -1;
+    float   best_d2 = std::numeric_limits<float>::max();
+
+    auto visit = [&](int32_t i, int32_t j) {
+        auto cell = _cells.find(Key(i, j));
+        if(cell == _cells.end())
+            return;
+
+        for(uint32_t id : cell->second)
+        {
+            const Point& p = _points[id];
+            float d2 = (p.x - x) * (p.x - x) + (p.y - y) * (p.y - y);
+            if(d2 < best_d2 && accept(id))
+            {
+                best_d2 = d2;
+                best = id;
+            }
+        }
+    };
+
+    for(int32_t r = 0; r <= max_ring; ++r)
+    {
+        if(r == 0)
+        {
+            visit(cx, cy);
+        }
+        else
+        {
+            for(int32_t i = cx - r; i <= cx + r; ++i)
+            {
+                visit(i, cy - r);
+                visit(i, cy + r);
+            }
+            for(int32_t j = cy - r + 1; j <= cy + r - 1; ++j)
+            {
+                visit(cx - r, j);
+                visit(cx + r, j);
+            }
+        }
+
+        // Every point beyond ring r is at least r cells away
+        const float reach = r * _cell_size;
+        if(best >= 0 && best_d2 <= reach * reach)
+            break;
+    }
+
+    return best;
+}
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef STOP_TOKEN_H
+#define STOP_TOKEN_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief Shared state of a StopSource and its StopTokens.
+ *
+ */
+class StopState
+{
+public:
+
+    /**
+     * @brief Default Constructor.
+     *
+     */
+    StopState() = default;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    StopState(const StopState &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return StopState&
+     */
+    StopState &operator=(const StopState &) = delete;
+
+    /**
+     * @brief Destroy the StopState object.
+     *
+     */
+    virtual ~StopState() = default;
+
+    /**
+     * @brief Requests a stop and invokes every registered callback.
+     *
+     * @return true  This call requested the stop.
+     * @return false A stop had already been requested.
+     */
+    bool RequestStop();
+
+    /**
+     * @brief Checks to see if a stop has been requested.
+     *
+     * @return true  Stop has been requested.
+     * @return false Stop has not been requested.
+     */
+    bool StopRequested() const { return _stop_requested.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Registers a callback invoked when a stop is requested.  The
+     *        callback is invoked immediately when a stop was already requested.
+     *
+     * @param callback Callback to invoke.
+     * @return uint64_t Registration id (0 when invoked immediately).
+     */
+    uint64_t Register(std::function<void()> callback);
+
+    /**
+     * @brief Unregisters a callback.  Waits for the callback to return if it
+     *        is being invoked.
+     *
+     * @param id Registration id.
+     */
+    void Unregister(uint64_t id);
+
+private:
+
+    /**
+     * @brief Stop has been requested.
+     *
+     */
+    std::atomic<bool> _stop_requested { false };
+
+    /**
+     * @brief Locks access to callbacks.
+     *
+     */
+    std::mutex _cs;
+
+    /**
+     * @brief Registered callbacks.
+     *
+     */
+    std::map<uint64_t, std::function<void()>> _callbacks;
+
+    /**
+     * @brief Next registration id.
+     *
+     */
+    uint64_t _next_id = 1;
+};
+
+/**
+ * @brief Observes stop requests of a StopSource (similar to std::stop_token).
+ *
+ */
+class StopToken
+{
+public:
+
+    /**
+     * @brief Construct a StopToken with no associated StopSource.
+     *
+     */
+    StopToken() = default;
+
+    /**
+     * @brief Construct a new StopToken object.
+     *
+     * @param state Shared stop state.
+     */
+    explicit StopToken(std::shared_ptr<StopState> state) : _state(std::move(state)) { }
+
+    /**
+     * @brief Checks to see if a stop has been requested.
+     *
+     * @return true  Stop has been requested.
+     * @return false Stop has not been requested (or no StopSource).
+     */
+    bool StopRequested() const { return _state && _state->StopRequested(); }
+
+    /**
+     * @brief Checks to see if a stop can ever be requested.
+     *
+     * @return true  Token has an associated StopSource.
+     * @return false Token has no associated StopSource.
+     */
+    bool StopPossible() const { return _state != nullptr; }
+
+private:
+
+    friend class StopCallback;
+
+    /**
+     * @brief Shared stop state.
+     *
+     */
+    std::shared_ptr<StopState> _state;
+};
+
+/**
+ * @brief Requests stops broadcast to every associated StopToken (similar to
+ *        std::stop_source).
+ *
+ */
+class StopSource
+{
+public:
+
+    /**
+     * @brief Construct a new StopSource object.
+     *
+     */
+    StopSource() : _state(std::make_shared<StopState>()) { }
+
+    /**
+     * @brief Requests a stop.
+     *
+     * @return true  This call requested the stop.
+     * @return false A stop had already been requested.
+     */
+    bool RequestStop() { return _state->RequestStop(); }
+
+    /**
+     * @brief Checks to see if a stop has been requested.
+     *
+     * @return true  Stop has been requested.
+     * @return false Stop has not been requested.
+     */
+    bool StopRequested() const { return _state->StopRequested(); }
+
+    /**
+     * @brief Token observing this StopSource.
+     *
+     * @return StopToken Token observing this StopSource.
+     */
+    StopToken Token() const { return StopToken(_state); }
+
+private:
+
+    /**
+     * @brief Shared stop state.
+     *
+     */
+    std::shared_ptr<StopState> _state;
+};
+
+/**
+ * @brief Invokes a callback when a stop is requested for as long as it
+ *        exists (similar to std::stop_callback).
+ *
+ */
+class StopCallback
+{
+public:
+
+    /**
+     * @brief Construct a new StopCallback object.  Invokes callback
+     *        immediately when a stop was already requested.
+     *
+     * @param token Token to observe.
+     * @param callback Callback to invoke.
+     */
+    StopCallback(const StopToken& token, std::function<void()> callback) : _state(token._state),
+                                                                          _id(0)
+    {
+        if(_state)
+            _id = _state->Register(std::move(callback));
+    }
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    StopCallback(const StopCallback &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return StopCallback&
+     */
+    StopCallback &operator=(const StopCallback &) = delete;
+
+    /**
+     * @brief Destroy the StopCallback object.  Unregisters the callback.
+     *
+     */
+    virtual ~StopCallback()
+    {
+        if(_state && _id)
+            _state->Unregister(_id);
+    }
+
+private:
+
+    /**
+     * @brief Shared stop state.
+     *
+     */
+    std::shared_ptr<StopState> _state;
+
+    /**
+     * @brief Registration id.
+     *
+     */
+    uint64_t _id;
+};
+
+/**
+ * @brief Requests a stop and invokes every registered callback.
+ *
+ * @return true  This call requested the stop.
+ * @return false A stop had already been requested.
+ */
+inline bool StopState::RequestStop()
+{
+    std::unique_lock<std::mutex> lock(_cs);
+
+    if(_stop_requested.exchange(true, std::memory_order_acq_rel))
+        return false;
+
+    for(auto const& [id, callback] : _callbacks)
+        callback();
+
+    return true;
+}
+
+/**
+ * @brief Registers a callback invoked when a stop is requested.  The
+ *        callback is invoked immediately when a stop was already requested.
+ *
+ * @param callback Callback to invoke.
+ * @return uint64_t Registration id (0 when invoked immediately).
+ */
+inline uint64_t StopState::Register(std::function<void()> callback)
+{
+    std::unique_lock<std::mutex> lock(_cs);
+
+    if(_stop_requested.load(std::memory_order_acquire))
+    {
+        lock.unlock();
+        callback();
+        return 0;
+    }
+
+    uint64_t id = _next_id++;
+    _callbacks.emplace(id, std::move(callback));
+    return id;
+}
+
+/**
+ * @brief Unregisters a callback.  Waits for the callback to return if it
+ *        is being invoked.
+ *
+ * @param id Registration id.
+ */
+inline void StopState::Unregister(uint64_t id)
+{
+    std::unique_lock<std::mutex> lock(_cs);
+    _callbacks.erase(id);
+}
+
+#endif
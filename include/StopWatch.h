@@ -3,6 +3,8 @@
 
 #include <chrono>
 
+#include "TypeStats.h"
+
 /**
  * @brief Simple stopwatch to calculate differences in timepoints.
  * 
@@ -51,8 +53,9 @@ public:
     /**
      * @brief Stop Stopwatch.
      * 
+     * @return std::chrono::milliseconds Duration since the StopWatch was started.
      */
-    void Tok();
+    std::chrono::milliseconds Tok();
     
     /**
      * @brief Calculatess total duration of StopWatch.
@@ -61,6 +64,39 @@ public:
      */
     constexpr int64_t Total();
 
+    /**
+     * @brief Checks to see if the StopWatch has been started and not yet stopped.
+     * 
+     * @return true  StopWatch is running.
+     * @return false StopWatch is stopped.
+     */
+    bool Running() const;
+
+    /**
+     * @brief Time elapsed since the StopWatch was started.
+     * 
+     * @return std::chrono::milliseconds Elapsed time, zero when stopped.
+     */
+    std::chrono::milliseconds Elapsed() const;
+
+    /**
+     * @brief Restores a previously saved StopWatch.
+     * 
+     * @param total_secs Total duration of StopWatch in seconds.
+     * @param running StopWatch was running when saved.
+     * @param elapsed Time elapsed since the StopWatch was started when saved.
+     */
+    void Restore(int64_t total_secs, bool running, std::chrono::milliseconds elapsed);
+
+    /**
+     * @brief Records each interval stopped by Tok() into running statistics.
+     * 
+     * @param stats Statistics to record into.
+     * @param type Vehicle type timed.
+     * @param kind What is timed.
+     */
+    void Attach(TypeStats& stats, size_t type, TypeStatKind kind);
+
 private:
 
     /**
@@ -79,7 +115,31 @@ private:
      * @brief Durations of start and stop timepoints.
      * 
      */
-    std::chrono::seconds _total;
+    std::chrono::seconds _total {};
+
+    /**
+     * @brief StopWatch has been started and not yet stopped.
+     * 
+     */
+    bool _running = false;
+
+    /**
+     * @brief Statistics each interval is recorded into, none when null.
+     * 
+     */
+    TypeStats* _stats = nullptr;
+
+    /**
+     * @brief Vehicle type timed.
+     * 
+     */
+    size_t _stats_type = 0;
+
+    /**
+     * @brief What is timed.
+     * 
+     */
+    TypeStatKind _stats_kind = CRUISE_STAT;
 };
 
 /**
@@ -91,6 +151,7 @@ inline void StopWatch::Reset()
     _start = {};
     _stop  = {};
     _total = {};
+    _running = false;
 }
 
 /**
@@ -99,17 +160,26 @@ inline void StopWatch::Reset()
  */
 inline void StopWatch::Tik()
 {
-    _start = std::chrono::steady_clock::now();
+    _start   = std::chrono::steady_clock::now();
+    _running = true;
 }
 
 /**
  * @brief Stop StopWatch.
  * 
+ * @return std::chrono::milliseconds Duration since the StopWatch was started.
  */
-inline void StopWatch::Tok()
+inline std::chrono::milliseconds StopWatch::Tok()
 {
     _stop   = std::chrono::steady_clock::now();
-    _total += std::chrono::duration_cast<std::chrono::seconds>(_stop - _start); 
+    const std::chrono::seconds secs = std::chrono::duration_cast<std::chrono::seconds>(_stop - _start);
+    const std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds>(_stop - _start);
+    _total += secs;
+    _running = false;
+
+    if(_stats)
+        _stats->Record(_stats_type, _stats_kind, secs.count(), ms.count());
+    return ms;
 }
 
 /**
@@ -122,4 +192,59 @@ inline constexpr int64_t StopWatch::Total()
     return _total.count();
 }
 
+/**
+ * @brief Checks to see if the StopWatch has been started and not yet stopped.
+ * 
+ * @return true  StopWatch is running.
+ * @return false StopWatch is stopped.
+ */
+inline bool StopWatch::Running() const
+{
+    return _running;
+}
+
+/**
+ * @brief Time elapsed since the StopWatch was started.
+ * 
+ * @return std::chrono::milliseconds Elapsed time, zero when stopped.
+ */
+inline std::chrono::milliseconds StopWatch::Elapsed() const
+{
+    if(!_running)
+        return {};
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start);
+}
+
+/**
+ * @brief Restores a previously saved StopWatch.  A running StopWatch is
+ *        restarted as if it had been started elapsed ago.
+ * 
+ * @param total_secs Total duration of StopWatch in seconds.
+ * @param running StopWatch was running when saved.
+ * @param elapsed Time elapsed since the StopWatch was started when saved.
+ */
+inline void StopWatch::Restore(int64_t total_secs, bool running, std::chrono::milliseconds elapsed)
+{
+    _total   = std::chrono::seconds(total_secs);
+    _running = running;
+    _start   = std::chrono::steady_clock::now() - elapsed;
+    _stop    = {};
+}
+
+
+/**
+ * @brief Records each interval stopped by Tok() into running statistics.
+ * 
+ * @param stats Statistics to record into.
+ * @param type Vehicle type timed.
+ * @param kind What is timed.
+ */
+inline void StopWatch::Attach(TypeStats& stats, size_t type, TypeStatKind kind)
+{
+    _stats      = &stats;
+    _stats_type = type;
+    _stats_kind = kind;
+}
+
 #endif
\ No newline at end of file
@@ -1,18 +1,29 @@
 #ifndef T_LOCKED_QUEUE_H
 #define T_LOCKED_QUEUE_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <iterator>
+#include <deque>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <vector>
+
+#include "LockStats.h"
+#include "Profiler.h"
 
 /**
  * @brief Thread-safe multi-producer / multi-consumer queue.
  * 
  * @tparam T 
+ * @tparam LockStats Lock statistics policy, LockContentionStats to count
+ *                   the contention of the queue's lock (NoLockStats costs
+ *                   nothing).
  * 
  */
-template <typename T>
+template <typename T, typename LockStats = NoLockStats>
 class TLockedQueue
 {
 public:
@@ -27,14 +38,14 @@ public:
     * @brief Default Copy Constructor (disabled).
     * 
     */
-   TLockedQueue(const TLockedQueue<T> &) = delete;
+   TLockedQueue(const TLockedQueue &) = delete;
 
    /**
     * @brief Assignment operator (disabled).
     * 
     * @return TLockedQueue& 
     */
-   TLockedQueue &operator=(const TLockedQueue<T> &) = delete;
+   TLockedQueue &operator=(const TLockedQueue &) = delete;
 
    /**
     * @brief Destroy the TLockedQueue object
@@ -73,6 +84,41 @@ public:
     */
    virtual void enqueue(const T &item);
 
+   /**
+    * @brief Push (move) item into queue unless it already holds capacity 
+    *        items.  Non-blocking, the item is left untouched when full.
+    * 
+    * @tparam T 
+    * @param item Item to push.
+    * @param capacity Maximum number of items in queue.
+    * @return true  Item was pushed.
+    * @return false Queue is full.
+    */
+   virtual bool try_enqueue(T &&item, size_t capacity);
+
+   /**
+    * @brief Push (move) item into queue when pred, called with the number 
+    *        of items in queue under the queue's lock, returns true.  
+    *        Non-blocking, the item is left untouched when refused.
+    * 
+    * @tparam Pred Callable taking the number of items (size_t), returning bool.
+    * @param item Item to push.
+    * @param pred Checks to see if the item may be pushed.
+    * @param front Push to the front of the queue, to be popped next.
+    * @return true  Item was pushed.
+    * @return false Item was refused.
+    */
+   template <typename Pred> bool try_enqueue_if(T &&item, Pred pred, bool front = false);
+
+   /**
+    * @brief Push (move) item to the front of the queue, to be popped next,
+    *        e.g. an item whose processing was interrupted.  O(1).
+    * 
+    * @tparam T 
+    * @param item Item to push.
+    */
+   virtual void enqueue_front(T &&item);
+
    /**
     * @brief Pop item from queue.  Non-blocking.
     * 
@@ -81,6 +127,43 @@ public:
     */
    virtual bool try_dequeue(T &item);
 
+   /**
+    * @brief Push a range of items into queue with one lock, waking a 
+    *        waiter per item.  Pass move iterators to move the items in.
+    * 
+    * @tparam InputIt Input iterator.
+    * @param first First item to push.
+    * @param last End of items to push.
+    * @return size_t Number of items pushed.
+    */
+   template <typename InputIt> size_t enqueue_bulk(InputIt first, InputIt last);
+
+   /**
+    * @brief Push a range of items into queue with one lock, as many as 
+    *        room, called with the number of items in queue under the 
+    *        queue's lock, allows.  Items past those pushed are left 
+    *        untouched.
+    * 
+    * @tparam InputIt Input iterator.
+    * @tparam Room Callable taking the number of items (size_t), returning
+    *              how many more may be pushed (size_t).
+    * @param first First item to push.
+    * @param last End of items to push.
+    * @param room Checks to see how many items may be pushed.
+    * @return size_t Number of items pushed, from first.
+    */
+   template <typename InputIt, typename Room> size_t enqueue_bulk_if(InputIt first, InputIt last, Room room);
+
+   /**
+    * @brief Pop (move) up to max items from queue with one lock.  Non-blocking.
+    * 
+    * @tparam OutputIt Output iterator.
+    * @param out Items are written to out, front first.
+    * @param max Maximum number of items to pop.
+    * @return size_t Number of items popped.
+    */
+   template <typename OutputIt> size_t try_dequeue_bulk(OutputIt out, size_t max);
+
    /**
     * @brief Checks to see if queue is empty.
     * 
@@ -98,13 +181,45 @@ public:
     */
    size_t Size();
 
+   /**
+    * @brief Size of queue, read without the lock (for monitoring).  May 
+    *        lag a push or pop that is in progress.
+    * 
+    * @return size_t Size of queue.
+    */
+   size_t ApproxSize() const { return _size.load(std::memory_order_relaxed); }
+
+   /**
+    * @brief Copies the items currently in the queue, front first.
+    * 
+    * @tparam T 
+    * @return std::vector<T> Items in queue order.
+    */
+   std::vector<T> Items();
+
+   /**
+    * @brief Contention of the queue's lock so far, all zero with 
+    *        NoLockStats.
+    * 
+    * @return LockStatsTotals Totals.
+    */
+   LockStatsTotals LockTotals() const { return _stats.Totals(); }
+
 private:
 
+   /**
+    * @brief Locks access to shared resources, timing the wait when 
+    *        profiling.
+    * 
+    * @return std::unique_lock<std::mutex> Lock held.
+    */
+   std::unique_lock<std::mutex> acquire() const;
+
    /**
     * @brief Locks access to shared resources.
     * 
     */
-   std::mutex _cs;
+   mutable std::mutex _cs;
 
    /**
     * @brief Signals thread that either and item has been pushed.
@@ -113,27 +228,84 @@ private:
    std::condition_variable _cv;
 
    /**
-    * @brief Queue container buffer.
+    * @brief Queue container buffer (a deque, so items can also be pushed
+    *        back to the front).
     * 
     */
-   std::queue<T> _q;
+   std::deque<T> _q;
+
+   /**
+    * @brief Size of _q, stored under the lock after each push or pop.
+    * 
+    */
+   std::atomic<size_t> _size {0};
+
+   /**
+    * @brief Number of threads waiting on _cv for an item, under the lock.
+    * 
+    */
+   size_t _waiters = 0;
+
+   /**
+    * @brief Contention of _cs (empty with NoLockStats).
+    * 
+    */
+   [[no_unique_address]] mutable LockStats _stats;
    
 };
 
+/**
+ * @brief Locks access to shared resources, timing the wait when 
+ *        profiling.
+ * 
+ * @return std::unique_lock<std::mutex> Lock held.
+ */
+template <typename T, typename LockStats>
+inline std::unique_lock<std::mutex> TLockedQueue<T, LockStats>::acquire() const
+{
+   std::unique_lock<std::mutex> lock(_cs, std::defer_lock);
+
+   if constexpr (LockStats::ENABLED)
+   {
+      // Contended when the lock is not free at once, only then is the wait timed
+      if(lock.try_lock())
+      {
+         _stats.Acquired();
+         return lock;
+      }
+
+      const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+      PROFILE_LOCK("TLockedQueue::lock", lock);
+      _stats.Contended(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t1).count());
+   }
+   else
+   {
+      PROFILE_LOCK("TLockedQueue::lock", lock);
+   }
+   return lock;
+}
+
 /**
  * @brief Pop item from queue.  Blocks on empty queue.
  * 
  * @return T First item. 
  */
-template <typename T>
-inline T TLockedQueue<T>::dequeue()
+template <typename T, typename LockStats>
+inline T TLockedQueue<T, LockStats>::dequeue()
 {
-   std::unique_lock<std::mutex> lock(_cs);
+   std::unique_lock<std::mutex> lock = acquire();
    
-   _cv.wait(lock, [this]{ return !_q.empty(); });
+   while(_q.empty())
+   {
+      ++_waiters;
+      _cv.wait(lock);
+      --_waiters;
+      _stats.Woken(_q.empty());
+   }
 
-   auto item = _q.front();
-   _q.pop();
+   T item = std::move(_q.front());
+   _q.pop_front();
+   _size.store(_q.size(), std::memory_order_relaxed);
    return item;
 }
 
@@ -143,15 +315,22 @@ inline T TLockedQueue<T>::dequeue()
  * @tparam T 
  * @param item First item.
  */
-template <typename T>
-inline void TLockedQueue<T>::dequeue(T &item)
+template <typename T, typename LockStats>
+inline void TLockedQueue<T, LockStats>::dequeue(T &item)
 {
-   std::unique_lock<std::mutex> lock(_cs);
+   std::unique_lock<std::mutex> lock = acquire();
    
-   _cv.wait(lock, [this]{ return !_q.empty(); } );
+   while(_q.empty())
+   {
+      ++_waiters;
+      _cv.wait(lock);
+      --_waiters;
+      _stats.Woken(_q.empty());
+   }
 
-   item = _q.front();
-   _q.pop();
+   item = std::move(_q.front());
+   _q.pop_front();
+   _size.store(_q.size(), std::memory_order_relaxed);
 }
 
 /**
@@ -160,14 +339,89 @@ inline void TLockedQueue<T>::dequeue(T &item)
  * @tparam T 
  * @param item Item to push.
  */
-template <typename T>
-inline void TLockedQueue<T>::enqueue(const T &item)
+template <typename T, typename LockStats>
+inline void TLockedQueue<T, LockStats>::enqueue(const T &item)
+{
+   std::unique_lock<std::mutex> lock = acquire();
+
+   _q.push_back(item);
+   _size.store(_q.size(), std::memory_order_relaxed);
+   lock.unlock();
+   _cv.notify_one();
+}
+
+/**
+ * @brief Push (move) item to the front of the queue, to be popped next,
+ *        e.g. an item whose processing was interrupted.  O(1).
+ * 
+ * @tparam T 
+ * @param item Item to push.
+ */
+template <typename T, typename LockStats>
+inline void TLockedQueue<T, LockStats>::enqueue_front(T &&item)
 {
-   std::unique_lock<std::mutex> lock(_cs);
+   std::unique_lock<std::mutex> lock = acquire();
+
+   _q.push_front(std::move(item));
+   _size.store(_q.size(), std::memory_order_relaxed);
+   lock.unlock();
+   _cv.notify_one();
+}
+
+/**
+ * @brief Push (move) item into queue unless it already holds capacity 
+ *        items.  Non-blocking, the item is left untouched when full.
+ * 
+ * @tparam T 
+ * @param item Item to push.
+ * @param capacity Maximum number of items in queue.
+ * @return true  Item was pushed.
+ * @return false Queue is full.
+ */
+template <typename T, typename LockStats>
+inline bool TLockedQueue<T, LockStats>::try_enqueue(T &&item, size_t capacity)
+{
+   std::unique_lock<std::mutex> lock = acquire();
+
+   if(_q.size() >= capacity)
+      return false;
+
+   _q.push_back(std::move(item));
+   _size.store(_q.size(), std::memory_order_relaxed);
+   lock.unlock();
+   _cv.notify_one();
+   return true;
+}
+
+/**
+ * @brief Push (move) item into queue when pred, called with the number 
+ *        of items in queue under the queue's lock, returns true.  
+ *        Non-blocking, the item is left untouched when refused.
+ * 
+ * @tparam Pred Callable taking the number of items (size_t), returning bool.
+ * @param item Item to push.
+ * @param pred Checks to see if the item may be pushed.
+ * @param front Push to the front of the queue, to be popped next.
+ * @return true  Item was pushed.
+ * @return false Item was refused.
+ */
+template <typename T, typename LockStats>
+template <typename Pred>
+inline bool TLockedQueue<T, LockStats>::try_enqueue_if(T &&item, Pred pred, bool front)
+{
+   std::unique_lock<std::mutex> lock = acquire();
+
+   if(!pred(_q.size()))
+      return false;
 
-   _q.push(item);
+   if(front)
+      _q.push_front(std::move(item));
+   else
+      _q.push_back(std::move(item));
+   _size.store(_q.size(), std::memory_order_relaxed);
    lock.unlock();
    _cv.notify_one();
+   return true;
 }
 
 /**
@@ -176,12 +430,13 @@ inline void TLockedQueue<T>::enqueue(const T &item)
  * @tparam T 
  * @param item Item to push.
  */
-template <typename T>
-inline void TLockedQueue<T>::enqueue(T &&item)
+template <typename T, typename LockStats>
+inline void TLockedQueue<T, LockStats>::enqueue(T &&item)
 {
-   std::unique_lock<std::mutex> lock(_cs);
+   std::unique_lock<std::mutex> lock = acquire();
 
-   _q.push(std::move(item));
+   _q.push_back(std::move(item));
+   _size.store(_q.size(), std::memory_order_relaxed);
    lock.unlock();
    _cv.notify_one();
 }
@@ -192,18 +447,107 @@ inline void TLockedQueue<T>::enqueue(T &&item)
  * @tparam T 
  * @param item 
  */
-template <typename T>
-inline bool TLockedQueue<T>::try_dequeue(T &item)
+template <typename T, typename LockStats>
+inline bool TLockedQueue<T, LockStats>::try_dequeue(T &item)
 {
-   std::unique_lock<std::mutex> lock(_cs);
+   std::unique_lock<std::mutex> lock = acquire();
    if(_q.empty())
       return false;
 
-   item = _q.front();
-   _q.pop();
+   item = std::move(_q.front());
+   _q.pop_front();
+   _size.store(_q.size(), std::memory_order_relaxed);
    return true;
 }
 
+/**
+ * @brief Push a range of items into queue with one lock, waking a 
+ *        waiter per item.  Pass move iterators to move the items in.
+ * 
+ * @tparam InputIt Input iterator.
+ * @param first First item to push.
+ * @param last End of items to push.
+ * @return size_t Number of items pushed.
+ */
+template <typename T, typename LockStats>
+template <typename InputIt>
+inline size_t TLockedQueue<T, LockStats>::enqueue_bulk(InputIt first, InputIt last)
+{
+   std::unique_lock<std::mutex> lock = acquire();
+
+   size_t count = 0;
+   for(; first != last; ++first, ++count)
+      _q.push_back(*first);
+   _size.store(_q.size(), std::memory_order_relaxed);
+   const size_t wake = std::min(count, _waiters);
+   lock.unlock();
+
+   // One wake up per item, no more than there are waiters, so no waiter
+   // is woken to find the items taken
+   for(size_t i = 0; i < wake; ++i)
+      _cv.notify_one();
+
+   return count;
+}
+
+/**
+ * @brief Push a range of items into queue with one lock, as many as 
+ *        room, called with the number of items in queue under the 
+ *        queue's lock, allows.  Items past those pushed are left 
+ *        untouched.
+ * 
+ * @tparam InputIt Input iterator.
+ * @tparam Room Callable taking the number of items (size_t), returning
+ *              how many more may be pushed (size_t).
+ * @param first First item to push.
+ * @param last End of items to push.
+ * @param room Checks to see how many items may be pushed.
+ * @return size_t Number of items pushed, from first.
+ */
+template <typename T, typename LockStats>
+template <typename InputIt, typename Room>
+inline size_t TLockedQueue<T, LockStats>::enqueue_bulk_if(InputIt first, InputIt last, Room room)
+{
+   std::unique_lock<std::mutex> lock = acquire();
+
+   const size_t max = room(_q.size());
+   size_t count = 0;
+   for(; count < max && first != last; ++first, ++count)
+      _q.push_back(*first);
+   _size.store(_q.size(), std::memory_order_relaxed);
+   const size_t wake = std::min(count, _waiters);
+   lock.unlock();
+
+   for(size_t i = 0; i < wake; ++i)
+      _cv.notify_one();
+
+   return count;
+}
+
+/**
+ * @brief Pop (move) up to max items from queue with one lock.  Non-blocking.
+ * 
+ * @tparam OutputIt Output iterator.
+ * @param out Items are written to out, front first.
+ * @param max Maximum number of items to pop.
+ * @return size_t Number of items popped.
+ */
+template <typename T, typename LockStats>
+template <typename OutputIt>
+inline size_t TLockedQueue<T, LockStats>::try_dequeue_bulk(OutputIt out, size_t max)
+{
+   std::unique_lock<std::mutex> lock = acquire();
+
+   size_t count = 0;
+   for(; count < max && !_q.empty(); ++count)
+   {
+      *out++ = std::move(_q.front());
+      _q.pop_front();
+   }
+   _size.store(_q.size(), std::memory_order_relaxed);
+   return count;
+}
+
 /**
  * @brief Checks to see if queue is empty.
  * 
@@ -211,10 +555,10 @@ inline bool TLockedQueue<T>::try_dequeue(T &item)
  * @return true Queue is empty.
  * @return false Queue is not empty.
  */
-template <typename T>
-inline bool TLockedQueue<T>::Empty() const
+template <typename T, typename LockStats>
+inline bool TLockedQueue<T, LockStats>::Empty() const
 {
-   std::unique_lock<std::mutex> lock(_cs);
+   std::unique_lock<std::mutex> lock = acquire();
    return _q.empty();
 }
 
@@ -224,11 +568,24 @@ inline bool TLockedQueue<T>::Empty() const
  * @tparam T 
  * @return size_t Size of queue.
  */
-template <typename T>
-inline size_t TLockedQueue<T>::Size()
+template <typename T, typename LockStats>
+inline size_t TLockedQueue<T, LockStats>::Size()
 {
-   std::unique_lock<std::mutex> lock(_cs);
+   std::unique_lock<std::mutex> lock = acquire();
    return _q.size();
 }
 
+/**
+ * @brief Copies the items currently in the queue, front first.
+ * 
+ * @tparam T 
+ * @return std::vector<T> Items in queue order.
+ */
+template <typename T, typename LockStats>
+inline std::vector<T> TLockedQueue<T, LockStats>::Items()
+{
+   std::unique_lock<std::mutex> lock = acquire();
+   return std::vector<T>(_q.begin(), _q.end());
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,178 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "EventScheduler.h"
+
+/**
+ * @brief Scheduler on a hierarchical timing wheel, O(1) per event.  Level 0
+ *        has a slot for each ms of the current 256 ms, level 1 a slot for
+ *        each 256 ms of the current 65 s, and so on.  An event goes into
+ *        the lowest level whose span holds it, and moves down a level each
+ *        time the wheel below turns over, until it is due.  Flight and
+ *        charge durations are whole minutes, so pending events bunch into
+ *        few slots and most are moved only once or twice.
+ *
+ *        Events due beyond the top level's span (about 50 days) wait in an
+ *        overflow list until the wheel reaches them.
+ *
+ */
+class TimingWheel : public EventScheduler
+{
+public:
+
+    /**
+     * @brief Number of levels.
+     *
+     */
+    static constexpr int LEVELS = 4;
+
+    /**
+     * @brief Bits of the time covered by each level.
+     *
+     */
+    static constexpr int SLOT_BITS = 8;
+
+    /**
+     * @brief Number of slots of each level.
+     *
+     */
+    static constexpr size_t SLOTS = size_t(1) << SLOT_BITS;
+
+    /**
+     * @brief Construct a new TimingWheel object.
+     *
+     * @param start_ms Simulation time (ms) the wheel starts at.
+     */
+    explicit TimingWheel(const int64_t start_ms = 0);
+
+    /**
+     * @brief Destroy the TimingWheel object.
+     *
+     */
+    virtual ~TimingWheel() = default;
+
+    /**
+     * @brief Adds an event.
+     *
+     * @param event Event to add.  Events due before the last event popped
+     *              are due immediately.
+     */
+    virtual void Schedule(const ScheduledEvent& event) override;
+
+    /**
+     * @brief Removes the earliest event.
+     *
+     * @param event Earliest event.
+     * @return true  An event was popped.
+     * @return false No events pending.
+     */
+    virtual bool Pop(ScheduledEvent& event) override;
+
+    /**
+     * @brief Removes the earliest event if it is due by a time.  The wheel
+     *        never turns past until_ms, so events due after it can still
+     *        be added.
+     *
+     * @param event Earliest event.
+     * @param until_ms Simulation time (ms) the event must be due by.
+     * @return true  An event was popped.
+     * @return false No events due by until_ms.
+     */
+    virtual bool PopDue(ScheduledEvent& event, const int64_t until_ms) override;
+
+    /**
+     * @brief Number of events pending.
+     *
+     * @return size_t Number of events pending.
+     */
+    virtual size_t Size() const override { return _size; }
+
+    /**
+     * @brief Simulation time (ms) the wheel has turned to.
+     *
+     * @return int64_t Simulation time (ms).
+     */
+    int64_t Now() const { return _now; }
+
+private:
+
+    /**
+     * @brief Slots of a level and a bit per slot that holds events.
+     *
+     */
+    struct Level
+    {
+        std::array<std::vector<ScheduledEvent>, SLOTS> slots;
+        std::array<uint64_t, SLOTS / 64>               occupied;
+    };
+
+    /**
+     * @brief Puts an event in the slot of the lowest level spanning it.
+     *
+     * @param event Event to place.
+     */
+    void Place(const ScheduledEvent& event);
+
+    /**
+     * @brief First slot holding events at or after a slot.
+     *
+     * @param level Level to search.
+     * @param from First slot searched.
+     * @return int Slot, -1 when none.
+     */
+    int NextOccupied(const int level, const size_t from) const;
+
+    /**
+     * @brief Turns the wheel to the next due events and moves them to the
+     *        ready list, without turning past a time.
+     *
+     * @param until_ms Simulation time (ms) the wheel may turn to.
+     * @return true  Events are ready.
+     * @return false No events due by until_ms.
+     */
+    bool Turn(const int64_t until_ms);
+
+    /**
+     * @brief Simulation time (ms) the wheel has turned to.
+     *
+     */
+    int64_t _now;
+
+    /**
+     * @brief Number of events pending.
+     *
+     */
+    size_t _size;
+
+    /**
+     * @brief Levels of the wheel, finest first.
+     *
+     */
+    std::array<Level, LEVELS> _levels;
+
+    /**
+     * @brief Events due at _now, in the order they were scheduled.
+     *
+     */
+    std::deque<ScheduledEvent> _ready;
+
+    /**
+     * @brief Events beyond the span of the top level.
+     *
+     */
+    std::vector<ScheduledEvent> _overflow;
+
+    /**
+     * @brief Events being moved down a level.  Swapped with the emptied
+     *        slot, so slots keep reusing their storage.
+     *
+     */
+    std::vector<ScheduledEvent> _scratch;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <memory>
+#include <vector>
+
+#include "Site.h"
+
+/**
+ * @brief Network of sites (vertiports) and the routes flown between them.
+ *
+ */
+class Topology
+{
+public:
+
+    /**
+     * @brief Construct a ring of sites evenly spaced on a circle, with routes
+     *        to the neighbouring site on either side.
+     *
+     * @param num_sites Number of sites.
+     * @param radius_miles Radius (miles) of the circle.
+     */
+    explicit Topology(const uint16_t num_sites, const float radius_miles = 50.0f);
+
+    /**
+     * @brief Default Constructor (disabled).
+     *
+     */
+    Topology() = delete;
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    Topology(const Topology &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return Topology&
+     */
+    Topology &operator=(const Topology &) = delete;
+
+    /**
+     * @brief Destroy the Topology object.
+     *
+     */
+    virtual ~Topology() = default;
+
+    /**
+     * @brief Number of sites.
+     *
+     * @return size_t Number of sites.
+     */
+    size_t Size() const { return _sites.size(); }
+
+    /**
+     * @brief Site by id.
+     *
+     * @param id Site identification.
+     * @return Site& Site.
+     * @throws std::out_of_range No site with id.
+     */
+    Site& At(const size_t id) const { return *_sites.at(id); }
+
+    /**
+     * @brief Site a charger is installed at.  Chargers are spread evenly
+     *        over the sites.
+     *
+     * @param charger_id Charger identification.
+     * @return Site& Site of charger.
+     */
+    Site& SiteOfCharger(const uint16_t charger_id) const { return *_sites[charger_id % _sites.size()]; }
+
+    /**
+     * @brief Home site of a vehicle.  Vehicles are spread evenly over the sites.
+     *
+     * @param vehicle_id Vehicle identification.
+     * @return Site& Home site of vehicle.
+     */
+    Site& SiteOfVehicle(const uint16_t vehicle_id) const { return *_sites[vehicle_id % _sites.size()]; }
+
+    /**
+     * @brief Points the sites without chargers at the nearest site with
+     *        chargers.  Must be called before the simulation is started.
+     *
+     * @param num_chargers Number of chargers spread over the sites.
+     */
+    void AssignChargingSites(const uint16_t num_chargers);
+
+    /**
+     * @brief Total number of vehicles waiting for a charger at every site,
+     *        read without taking the queues' locks.
+     *
+     * @return size_t Number of vehicles waiting.
+     */
+    size_t QueueLength() const;
+
+private:
+
+    /**
+     * @brief Sites (indexed by id).
+     *
+     */
+    std::vector<std::unique_ptr<Site>> _sites;
+};
+
+#endif
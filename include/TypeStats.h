@@ -0,0 +1,256 @@
+#ifndef TYPE_STATS_H
+#define TYPE_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sched.h>
+
+#include "CacheLine.h"
+
+/**
+ * @brief Most vehicle types the statistics are kept for.
+ *
+ */
+constexpr size_t TYPE_STATS_MAX_TYPES = 8;
+
+/**
+ * @brief What a statistic times.
+ *
+ */
+enum TypeStatKind
+{
+    CRUISE_STAT,  //!< Flights.
+    CHARGE_STAT,  //!< Charges.
+    QING_STAT     //!< Waits for a charger.
+};
+
+/**
+ * @brief Number of kinds of statistics.
+ *
+ */
+constexpr size_t NUM_TYPE_STAT_KINDS = QING_STAT + 1;
+
+/**
+ * @brief Running aggregate of the intervals of a kind, for a vehicle type.
+ *
+ */
+struct TypeStatTotals
+{
+    int64_t count;       //!< Number of intervals, including those cut short by the end of the run.
+    int64_t total_secs;  //!< Sum of the intervals (secs), as StopWatch::Total().
+    int64_t min_ms;      //!< Shortest interval (ms), 0 when none.
+    int64_t max_ms;      //!< Longest interval (ms).
+};
+
+/**
+ * @brief Per vehicle type running aggregates of flight, charge and queueing
+ *        time, updated by each StopWatch::Tok() of a vehicle, so the results
+ *        of a type can be read at any time without walking the fleet.
+ *
+ *        Updates go to the shard of the CPU the updating thread runs on,
+ *        each on its own cache lines, so the threads of a run (many more
+ *        than the CPUs) share a counter only with the threads of their CPU,
+ *        never at the same instant.  A read sums the shards,
+ *        O(types x shards).
+ *
+ */
+class TypeStats
+{
+public:
+
+    /**
+     * @brief Parameters of a vehicle type the results are derived with.
+     *
+     */
+    struct TypeInfo
+    {
+        std::string name;                     //!< Vehicle type name.
+        int64_t     num_vehicles;             //!< Number of vehicles of the type.
+        double      passenger_miles_per_min;  //!< Passenger miles per minute cruising.
+        double      faults_per_min;           //!< Probability of fault per minute.
+    };
+
+    /**
+     * @brief Construct a new TypeStats object.
+     *
+     * @param shards Number of shards, rounded up to a power of 2 (one per
+     *               hardware thread when 0).  CPUs beyond the shards share
+     *               them.
+     */
+    explicit TypeStats(size_t shards = 0);
+
+    /**
+     * @brief Default Copy Constructor (disabled).
+     *
+     */
+    TypeStats(const TypeStats &) = delete;
+
+    /**
+     * @brief Assignment operator (disabled).
+     *
+     * @return TypeStats&
+     */
+    TypeStats &operator=(const TypeStats &) = delete;
+
+    /**
+     * @brief Destroy the TypeStats object.
+     *
+     */
+    virtual ~TypeStats() = default;
+
+    /**
+     * @brief Counts a vehicle of a type.  Called once per vehicle created.
+     *
+     * @param type Vehicle type (0 to TYPE_STATS_MAX_TYPES - 1).
+     * @param name Vehicle type name.
+     * @param passenger_miles_per_min Passenger miles per minute cruising.
+     * @param faults_per_min Probability of fault per minute.
+     */
+    void AddVehicle(const size_t type, const std::string& name, const double passenger_miles_per_min, const double faults_per_min);
+
+    /**
+     * @brief Records an interval.  Lock free, called by StopWatch::Tok().
+     *
+     * @param type Vehicle type.
+     * @param kind What was timed.
+     * @param secs Interval (secs) added to the total.
+     * @param ms Interval (ms) for the shortest and longest.
+     */
+    void Record(const size_t type, const TypeStatKind kind, const int64_t secs, const int64_t ms);
+
+    /**
+     * @brief Adds time to a total without counting an interval, e.g. the
+     *        totals of vehicles restored from a snapshot.
+     *
+     * @param type Vehicle type.
+     * @param kind What was timed.
+     * @param secs Time (secs) added to the total.
+     */
+    void AddTotal(const size_t type, const TypeStatKind kind, const int64_t secs);
+
+    /**
+     * @brief Aggregate of a kind for a type, summed over the shards.
+     *
+     * @param type Vehicle type.
+     * @param kind What was timed.
+     * @return TypeStatTotals Aggregate so far.
+     */
+    TypeStatTotals Totals(const size_t type, const TypeStatKind kind) const;
+
+    /**
+     * @brief Vehicle types with at least one vehicle, ordered by name.
+     *
+     * @return std::vector<std::pair<size_t, TypeInfo>> Each type and its parameters.
+     */
+    std::vector<std::pair<size_t, TypeInfo>> Types() const;
+
+    /**
+     * @brief Number of shards.
+     *
+     * @return size_t Number of shards.
+     */
+    size_t Shards() const { return _shards.size(); }
+
+private:
+
+    /**
+     * @brief Aggregate of one kind for one type in one shard.
+     *
+     */
+    struct Aggregate
+    {
+        std::atomic<int64_t> count { 0 };
+        std::atomic<int64_t> total_secs { 0 };
+        std::atomic<int64_t> min_ms { INT64_MAX };
+        std::atomic<int64_t> max_ms { 0 };
+    };
+
+    /**
+     * @brief Aggregates updated by the threads of the CPUs mapped to one
+     *        shard.
+     *
+     */
+    struct alignas(CACHE_LINE_SIZE) Shard
+    {
+        std::array<std::array<Aggregate, NUM_TYPE_STAT_KINDS>, TYPE_STATS_MAX_TYPES> aggregates;
+    };
+
+    /**
+     * @brief Shard of the CPU the calling thread runs on.  Where the CPU
+     *        is not known, threads are spread over the shards round robin
+     *        the first time they update.
+     *
+     * @return Shard& Shard.
+     */
+    Shard& Local();
+
+    /**
+     * @brief Shards of the aggregates.
+     *
+     */
+    std::vector<std::unique_ptr<Shard>> _shards;
+
+    /**
+     * @brief Parameters of each type, indexed by type.
+     *
+     */
+    std::array<TypeInfo, TYPE_STATS_MAX_TYPES> _types;
+
+    /**
+     * @brief Locks _types while vehicles are added.
+     *
+     */
+    mutable std::mutex _types_lock;
+};
+
+/**
+ * @brief Records an interval.  Lock free, called by StopWatch::Tok().
+ *
+ * @param type Vehicle type.
+ * @param kind What was timed.
+ * @param secs Interval (secs) added to the total.
+ * @param ms Interval (ms) for the shortest and longest.
+ */
+inline void TypeStats::Record(const size_t type, const TypeStatKind kind, const int64_t secs, const int64_t ms)
+{
+    Aggregate& a = Local().aggregates[type][kind];
+
+    a.count.fetch_add(1, std::memory_order_relaxed);
+    a.total_secs.fetch_add(secs, std::memory_order_relaxed);
+
+    int64_t min = a.min_ms.load(std::memory_order_relaxed);
+    while(ms < min && !a.min_ms.compare_exchange_weak(min, ms, std::memory_order_relaxed)) { }
+
+    int64_t max = a.max_ms.load(std::memory_order_relaxed);
+    while(ms > max && !a.max_ms.compare_exchange_weak(max, ms, std::memory_order_relaxed)) { }
+}
+
+/**
+ * @brief Shard of the CPU the calling thread runs on.  Where the CPU
+ *        is not known, threads are spread over the shards round robin
+ *        the first time they update.
+ *
+ * @return Shard& Shard.
+ */
+inline TypeStats::Shard& TypeStats::Local()
+{
+    // A thread moved to another CPU mid update only shares a shard, the
+    // updates are atomic
+    const int cpu = sched_getcpu();
+    if(cpu >= 0)
+        return *_shards[size_t(cpu) & (_shards.size() - 1)];
+
+    static std::atomic<size_t> next { 0 };
+    thread_local const size_t thread = next.fetch_add(1, std::memory_order_relaxed);
+
+    return *_shards[thread & (_shards.size() - 1)];
+}
+
+#endif
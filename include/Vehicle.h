@@ -1,13 +1,17 @@
 #ifndef VEHICLE_H
 #define VEHICLE_H
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <sstream>
 
+#include "Demand.h"
+#include "CacheLine.h"
+#include "Histogram.h"
 #include "SimulationObject.h"
+#include "Site.h"
 #include "StopWatch.h"
-#include "TLockedQueue.h"
 
 /**
  * @brief Vehicle types.
@@ -32,9 +36,17 @@ enum VehicleStateType
     CRUISING,
     NEEDS_CHARGED,
     CHARGING,
-    CHARGED
+    CHARGED,
+    IDLE,
+    MAINTENANCE   //!< Grounded by a fault, waiting for or under repair (serial engine only).
 };
 
+/**
+ * @brief Number of vehicle states.
+ * 
+ */
+constexpr size_t NUM_VEHICLE_STATES = MAINTENANCE + 1;
+
 /**
  * @brief Simulates a vehicle (producer) running in a thread.
  * 
@@ -48,6 +60,7 @@ public:
     /**
      * @brief Construct a new Vehicle object.
      * 
+     * @param type Type of vehicle.
      * @param n Name of vehicle.
      * @param bc Battery capacity (kWh).
      * @param cs Cruise speed (mph)
@@ -56,9 +69,11 @@ public:
      * @param pof Probability of fault (fault/hr).
      * @param ttc Time to charge (hr)
      * @param id Identification of this vehicle
-     * @param chargingQ Vehicle charging queue.
+     * @param site Site the vehicle starts at.
+     * @param context State shared by all objects of the simulation.
      */
-    Vehicle(const std::string& n, 
+    Vehicle(const VehicleType  type,
+            const std::string& n, 
             const uint16_t     bc,
             const uint16_t     cs,
             const uint16_t     pc,
@@ -66,7 +81,8 @@ public:
             const float        pof,
             const float        ttc,
             const uint16_t     id,
-            TLockedQueue<std::shared_ptr<Vehicle>>& chargingQ);
+            Site&              site,
+            SimulationContext& context);
 
     /**
      * @brief Default Constructor (disabled).
@@ -98,12 +114,14 @@ public:
      * 
      * @param type 
      * @param id 
-     * @param chargingQ 
+     * @param site 
+     * @param context 
      * @return std::shared_ptr<Vehicle> 
      */
     static std::shared_ptr<Vehicle> Create(VehicleType type, 
                                            const uint16_t id,
-                                           TLockedQueue<std::shared_ptr<Vehicle>>& chargingQ);
+                                           Site& site,
+                                           SimulationContext& context);
 
     //
     // Properties
@@ -165,6 +183,50 @@ public:
      */
     float TimeToCharge() const { return _time_to_charge; }
 
+    /**
+     * @brief Type of vehicle.
+     * 
+     * @return VehicleType Type of vehicle.
+     */
+    VehicleType Type() const { return _type; }
+
+    /**
+     * @brief Current state of vehicle.
+     * 
+     * @return VehicleStateType Current state of vehicle.
+     */
+    VehicleStateType State() const { return _state; }
+
+    /**
+     * @brief Site the vehicle is at, or flying to while cruising.
+     * 
+     * @return Site& Site of vehicle.
+     */
+    Site& Location() const { return *_site; }
+
+    /**
+     * @brief Energy left in the battery.  Safe to call from any thread.
+     * 
+     * @return float Energy (kWh).
+     */
+    float Energy() const { return _energy.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Duration of the current (or last) flight.
+     * 
+     * @return int64_t Flight time (mins).
+     */
+    int64_t LegTime() const { return _leg_mins; }
+
+    /**
+     * @brief Checks to see if the vehicle is idle and can be assigned a trip.
+     *        Safe to call from any thread.
+     * 
+     * @return true  Vehicle can be assigned a trip.
+     * @return false Vehicle is busy or has a trip it has not taken yet.
+     */
+    bool Available() const { return _state == IDLE && !_trip_pending.load(std::memory_order_acquire); }
+
     //
     // Vehicle
     //
@@ -178,6 +240,10 @@ public:
 
     /**
      * @brief Simulates a vehicle cruising by blocking thread for CruiseTime().
+     *        A restored vehicle only cruises for the remainder of CruiseTime().
+     *        The vehicle flies to the next site on its route, where it then 
+     *        needs charged.  A vehicle flying trips instead flies its trip
+     *        and only needs charged once its battery reaches the reserve.
      * 
      */
     void CruiseAction();
@@ -197,10 +263,95 @@ public:
     int64_t ChargeTime() const;
 
     /**
-     * @brief Pushes vehicle to charging queue.
+     * @brief Calculates the time to charge the energy used since the last
+     *        charge, converted to simulation time.
+     * 
+     * @return int64_t Time to recharge in seconds.
+     */
+    int64_t RechargeTime() const;
+
+    /**
+     * @brief Flies trips assigned by a dispatcher instead of flying until
+     *        the battery is empty.  Must be called before the vehicle is 
+     *        started.
+     * 
+     */
+    void EnableTrips() { _on_demand = true; }
+
+    /**
+     * @brief Calculates the flight time of a trip, including the flight 
+     *        from the vehicle's site to the trip's origin.
+     * 
+     * @param origin Site the trip departs from.
+     * @param destination Site the trip flies to.
+     * @return int64_t Flight time (mins).
+     */
+    int64_t TripTime(const Site& origin, const Site& destination) const;
+
+    /**
+     * @brief Calculates the energy used by a flight.
+     * 
+     * @param flight_mins Flight time (mins).
+     * @return float Energy (kWh).
+     */
+    float FlightEnergy(const int64_t flight_mins) const;
+
+    /**
+     * @brief Assigns a trip to an idle vehicle.  Called by the dispatcher, 
+     *        the vehicle flies the trip the next time it runs.
+     * 
+     * @param origin Site the trip departs from.
+     * @param destination Site the trip flies to.
+     * @return true  Trip was assigned.
+     * @return false Vehicle has not taken its previous trip yet.
+     */
+    bool Assign(Site& origin, Site& destination);
+
+    /**
+     * @brief Pushes vehicle to charging queue.  When the queue is full the
+     *        vehicle diverts, or waits and is called again, as its site's
+     *        QueueFullPolicy says.
+     * 
+     * @return true  Vehicle is queued.
+     * @return false Queue is full, vehicle is still waiting for room.
+     */
+    bool NeedsChargedAction();
+
+    /**
+     * @brief Adds the energy charged in part of a charge, e.g. one cut short
+     *        by a charger outage.
+     * 
+     * @param charged Time (ms) charged, converted to simulation time.
+     */
+    void AddCharge(const std::chrono::milliseconds charged);
+
+    /**
+     * @brief Hands back a vehicle whose charge was cut short by an outage.
+     *        It needs charged again and rejoins a charging queue in 
+     *        service first in line.  Called by the charger with the 
+     *        FreezeLock held.
      * 
      */
-    void NeedsChargedAction();
+    void Requeue();
+
+    /**
+     * @brief Moves a waiting vehicle to another site's charging queue.  
+     *        Called with the FreezeLock held.
+     * 
+     * @param site Site the vehicle now waits at.
+     */
+    void MoveTo(Site& site) { _site = &site; }
+
+    /**
+     * @brief Restores the state of this vehicle from a snapshot.  Must be 
+     *        called before the vehicle is started.
+     * 
+     * @param state State of vehicle.
+     * @param site Site of vehicle.
+     * @param energy Energy (kWh) left in the battery.
+     * @param leg_mins Duration (mins) of the current flight.
+     */
+    void Restore(VehicleStateType state, Site& site, float energy, int64_t leg_mins);
 
     /**
      * @brief Formatted string describing this vehicle.
@@ -238,24 +389,53 @@ public:
     // Properties
     //
 
+    //
+    // Hot fields are grouped by the thread writing them, each group starting
+    // a cache line, so the charger hand-off does not contend with the
+    // vehicle's own bookkeeping.
+    //
+
     /**
      * @brief Cruising duration converted to simulation time (seconds).
+     *        Written by the vehicle thread.
      * 
      */
-    StopWatch CruisingTime;
+    alignas(CACHE_LINE_SIZE) StopWatch CruisingTime;
 
     /**
      * @brief Charging duration converted to simulation time (seconds).
+     *        Written by the charger thread.
      * 
      */
-    StopWatch ChargingTime;
+    alignas(CACHE_LINE_SIZE) StopWatch ChargingTime;
 
     /**
      * @brief Queueing duration converted to simulation time (seconds).
+     *        Started by the vehicle thread, stopped by the charger thread
+     *        at hand-off.
      * 
      */
     StopWatch QingTime;
 
+    /**
+     * @brief Duration (ms) of each completed flight.  Written by the vehicle thread.
+     * 
+     */
+    alignas(CACHE_LINE_SIZE) Histogram CruisingLaps;
+
+    /**
+     * @brief Duration (ms) of each completed charge.  Written by the charger thread.
+     * 
+     */
+    alignas(CACHE_LINE_SIZE) Histogram ChargingLaps;
+
+    /**
+     * @brief Duration (ms) of each wait in the charging queue.  Written by
+     *        the charger thread.
+     * 
+     */
+    Histogram QingLaps;
+
 protected:
 
     //
@@ -270,10 +450,10 @@ protected:
     virtual const std::string Header() override;
 
     //
-    // Properties
+    // Properties (read only, shared by every thread)
     //
 
-    const uint16_t _battery_capacity;
+    alignas(CACHE_LINE_SIZE) const uint16_t _battery_capacity;
     const uint16_t _cruise_speed;
     const float _energy_use_at_cruise;
     const std::string _header;
@@ -282,20 +462,70 @@ protected:
     const uint16_t _passenger_count; 
     const float _prob_of_fault;
     const float _time_to_charge;
+    const VehicleType _type;
 
     /**
-     * @brief Vehicle charging queue.
+     * @brief Site the vehicle is at (its charging queue), or flying to.
+     *        Starts the state shared by the vehicle, its charger and the
+     *        dispatcher, kept off the lines of the read only properties.
      * 
      */
-    TLockedQueue<std::shared_ptr<Vehicle>>& _charging_q;
+    alignas(CACHE_LINE_SIZE) Site* _site;
+
+    /**
+     * @brief Energy (kWh) left in the battery.
+     * 
+     */
+    std::atomic<float> _energy;
+
+    /**
+     * @brief Duration (mins) of the current (or last) flight.
+     * 
+     */
+    int64_t _leg_mins;
+
+    /**
+     * @brief Flies trips assigned by a dispatcher.
+     * 
+     */
+    bool _on_demand;
+
+    /**
+     * @brief Vehicle found its charging queue full and is waiting for room.
+     * 
+     */
+    bool _queue_full;
+
+    /**
+     * @brief Vehicle was interrupted by an outage and rejoins a charging
+     *        queue at the front.
+     * 
+     */
+    bool _requeue;
+
+    /**
+     * @brief A trip has been assigned and not yet taken.
+     * 
+     */
+    std::atomic<bool> _trip_pending;
+
+    /**
+     * @brief Site the assigned trip departs from.
+     * 
+     */
+    Site* _trip_origin;
+
+    /**
+     * @brief Site the assigned trip flies to.
+     * 
+     */
+    Site* _trip_destination;
 
     /**
      * @brief Current state of vehicle.
      * 
      */
-    VehicleStateType _state;
+    std::atomic<VehicleStateType> _state;
 };
 
-typedef TLockedQueue<std::shared_ptr<Vehicle>> ChargingQ;
-
 #endif
\ No newline at end of file
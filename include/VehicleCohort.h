@@ -0,0 +1,234 @@
+#ifndef VEHICLE_COHORT_H
+#define VEHICLE_COHORT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Vehicle.h"
+
+/**
+ * @brief Lanes of the kernel are processed in blocks of this many (one
+ *        AVX2 register of 32 bit values).
+ *
+ */
+constexpr size_t COHORT_BLOCK = 8;
+
+/**
+ * @brief State of the padding lanes of the last block, never advanced.
+ *
+ */
+constexpr int32_t COHORT_PAD = -1;
+
+/**
+ * @brief Vehicles flying full battery flights, packed into arrays (one lane
+ *        per vehicle) so the time bucket of a batched engine advances all of
+ *        them at once.  Advance() applies every transition that falls due
+ *        with masks instead of a switch per vehicle: AVX2 when the CPU has
+ *        it, otherwise a scalar loop that computes the same result.
+ *
+ *        Times are 32 bit ms of simulation time, enough for about 590 hours
+ *        (1 ms of realtime is 1 ms of simulated minutes).
+ *
+ */
+class VehicleCohort
+{
+public:
+
+    /**
+     * @brief Default Constructor.
+     *
+     */
+    VehicleCohort() = default;
+
+    /**
+     * @brief Destroy the VehicleCohort object.
+     *
+     */
+    virtual ~VehicleCohort() = default;
+
+    /**
+     * @brief Adds a lane for a vehicle, cruising from time 0.
+     *
+     * @param vehicle Vehicle the lane takes its type parameters from.
+     * @return uint32_t Lane of the vehicle.
+     */
+    uint32_t Add(const Vehicle& vehicle);
+
+    /**
+     * @brief Adds a lane, cruising from time 0.
+     *
+     * @param cruise_ms Duration (ms) of a flight.
+     * @param charge_ms Duration (ms) of a charge.
+     * @param capacity Battery capacity (kWh).
+     * @return uint32_t Lane of the vehicle.
+     */
+    uint32_t Add(const int32_t cruise_ms, const int32_t charge_ms, const float capacity);
+
+    /**
+     * @brief Number of vehicles.
+     *
+     * @return size_t Number of vehicles.
+     */
+    size_t Size() const { return _size; }
+
+    /**
+     * @brief Applies every transition due by now_ms, at most one per vehicle:
+     *        flights that ended need charged, charges that ended start the
+     *        next flight.  Vehicles that need charged are appended to
+     *        needs_charged in lane order, to be queued for a charger.
+     *
+     * @param now_ms Simulation time (ms) of the end of the time bucket.
+     * @param needs_charged Lanes that started needing charged.
+     * @return size_t Number of transitions applied.
+     */
+    size_t Advance(const int32_t now_ms, std::vector<uint32_t>& needs_charged);
+
+    /**
+     * @brief Advance() with the scalar kernel.
+     *
+     * @param now_ms Simulation time (ms) of the end of the time bucket.
+     * @param needs_charged Lanes that started needing charged.
+     * @return size_t Number of transitions applied.
+     */
+    size_t AdvanceScalar(const int32_t now_ms, std::vector<uint32_t>& needs_charged);
+
+    /**
+     * @brief Advance() with the AVX2 kernel.  Must only be called when
+     *        HasAvx2() is true.
+     *
+     * @param now_ms Simulation time (ms) of the end of the time bucket.
+     * @param needs_charged Lanes that started needing charged.
+     * @return size_t Number of transitions applied.
+     */
+    size_t AdvanceAvx2(const int32_t now_ms, std::vector<uint32_t>& needs_charged);
+
+    /**
+     * @brief Checks to see if the AVX2 kernel can run on this CPU.
+     *
+     * @return true  AVX2 kernel is available.
+     * @return false Only the scalar kernel is available.
+     */
+    static bool HasAvx2();
+
+    /**
+     * @brief Starts charging a vehicle that needs charged.  The time since
+     *        its flight ended is counted as queueing.
+     *
+     * @param lane Lane of the vehicle.
+     * @param now_ms Simulation time (ms) the charge starts.
+     */
+    void StartCharging(const uint32_t lane, const int32_t now_ms);
+
+    /**
+     * @brief State of a vehicle.
+     *
+     * @param lane Lane of the vehicle.
+     * @return VehicleStateType State.
+     */
+    VehicleStateType State(const uint32_t lane) const { return static_cast<VehicleStateType>(_state[lane]); }
+
+    /**
+     * @brief Energy of a vehicle (kWh).
+     *
+     * @param lane Lane of the vehicle.
+     * @return float Energy (kWh).
+     */
+    float Energy(const uint32_t lane) const { return _energy[lane]; }
+
+    /**
+     * @brief Simulation time (ms) the current flight or charge ends, or the
+     *        flight ended while the vehicle needs charged.
+     *
+     * @param lane Lane of the vehicle.
+     * @return int32_t Simulation time (ms).
+     */
+    int32_t NextEvent(const uint32_t lane) const { return _next_ms[lane]; }
+
+    /**
+     * @brief Duration (ms) of the flights completed by a vehicle.
+     *
+     * @param lane Lane of the vehicle.
+     * @return int32_t Duration (ms).
+     */
+    int32_t CruisingTotal(const uint32_t lane) const { return _cruise_total[lane]; }
+
+    /**
+     * @brief Duration (ms) of the charges completed by a vehicle.
+     *
+     * @param lane Lane of the vehicle.
+     * @return int32_t Duration (ms).
+     */
+    int32_t ChargingTotal(const uint32_t lane) const { return _charge_total[lane]; }
+
+    /**
+     * @brief Duration (ms) a vehicle waited for a charger.
+     *
+     * @param lane Lane of the vehicle.
+     * @return int32_t Duration (ms).
+     */
+    int32_t QingTotal(const uint32_t lane) const { return _qing_total[lane]; }
+
+private:
+
+    /**
+     * @brief Number of vehicles (lanes beyond are padding).
+     *
+     */
+    size_t _size = 0;
+
+    /**
+     * @brief State of each lane (VehicleStateType, COHORT_PAD for padding).
+     *
+     */
+    std::vector<int32_t> _state;
+
+    /**
+     * @brief Simulation time (ms) of the next event of each lane.
+     *
+     */
+    std::vector<int32_t> _next_ms;
+
+    /**
+     * @brief Duration (ms) of a flight of each lane.
+     *
+     */
+    std::vector<int32_t> _cruise_ms;
+
+    /**
+     * @brief Duration (ms) of a charge of each lane.
+     *
+     */
+    std::vector<int32_t> _charge_ms;
+
+    /**
+     * @brief Duration (ms) of the completed flights of each lane.
+     *
+     */
+    std::vector<int32_t> _cruise_total;
+
+    /**
+     * @brief Duration (ms) of the completed charges of each lane.
+     *
+     */
+    std::vector<int32_t> _charge_total;
+
+    /**
+     * @brief Duration (ms) each lane waited for a charger.
+     *
+     */
+    std::vector<int32_t> _qing_total;
+
+    /**
+     * @brief Energy (kWh) of each lane.
+     *
+     */
+    std::vector<float> _energy;
+
+    /**
+     * @brief Battery capacity (kWh) of each lane.
+     *
+     */
+    std::vector<float> _capacity;
+};
+
+#endif
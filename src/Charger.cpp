@@ -1,16 +1,34 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
 #include "Charger.h"
 
 /**
  * @brief Construct a new Charger object
  * 
  * @param id Charger identification.
- * @param charging_q Vehicle charging queue.
+ * @param site Site the charger is installed at.
+ * @param context State shared by all objects of the simulation.
  */
-Charger::Charger(uint16_t   id, 
-                 ChargingQ& charging_q) : _header("<Charger " + std::to_string(id) + "> "),
-                                          _id(id),
-                                          _charging_q {charging_q}                                            
-{ }
+Charger::Charger(uint16_t           id, 
+                 Site&              site,
+                 SimulationContext& context) : SimulationObject(context),
+                                               _header("<Charger " + std::to_string(id) + "> "),
+                                               _id(id),
+                                               _site {site},
+                                               _vehicle(),
+                                               _busy(false),
+                                               _down(false),
+                                               _interrupted(0),
+                                               _outages(),
+                                               _mtbf_mins(0.0),
+                                               _mttr_mins(0.0),
+                                               _gen(),
+                                               _started(std::chrono::steady_clock::now())
+{
+    _site.AddCharger();
+}
 
 /**
  * @brief String used to uniquely identify this object.
@@ -28,7 +46,267 @@ const std::string Charger::Header()
  */
 void Charger::PrintStats()
 {
-    // Charger does not have any stats (yet)
+    std::stringstream output;
+    output << "\n------------------------------------------------------------------------------------------------------" << std::endl;
+    output << "|       Metric       |  Count  |  Mean (mins)  |  p50 (mins)  |  p90 (mins)  |  p99 (mins)  |  Max (mins)  |" << std::endl;
+    output << "------------------------------------------------------------------------------------------------------" << std::endl;
+
+    output << std::setprecision(2) << std::fixed;
+    std::vector<std::pair<const char*, const Histogram*>> rows = { { "Qing Time", &QingLaps }, { "Charge Time", &ChargingLaps } };
+    if(OutageLaps.Count() > 0)
+        rows.push_back({ "Outage Time", &OutageLaps });
+
+    for(auto const& [name, hist] : rows)
+    {
+        output << "|"    << std::right << std::setw(18) << std::setfill(' ') << name;
+        output << "  |" << std::setw(7)  << hist->Count();
+        output << "  |" << std::setw(13) << hist->Mean()            / 1000.0;
+        output << "  |" << std::setw(12) << hist->Percentile(50.0)  / 1000.0;
+        output << "  |" << std::setw(12) << hist->Percentile(90.0)  / 1000.0;
+        output << "  |" << std::setw(12) << hist->Percentile(99.0)  / 1000.0;
+        output << "  |" << std::setw(12) << hist->Max()             / 1000.0;
+        output << "  |" << std::endl;
+    }
+    output << "------------------------------------------------------------------------------------------------------" << std::endl;
+
+    PrintToConsole(output);
+}
+
+/**
+ * @brief Charges the current vehicle for the remainder of its RechargeTime().
+ *        A charge cut short by an outage gives the vehicle the energy 
+ *        charged so far and hands it back to rejoin a queue in service
+ *        at the front.
+ * 
+ */
+void Charger::ChargeAction()
+{
+    PROFILE_SCOPE("Charger::Charge");
+
+    int64_t ttc = _vehicle->RechargeTime();
+
+    if(Verbose())
+    {
+        std::stringstream ss;
+        ss << "Charging Vehicle " << _vehicle->Name() << " for " << ttc << " mins";
+        PrintToConsole(ss);
+    }
+
+    // Blocks for desired seconds, until the next outage OR thread exits
+    const std::chrono::milliseconds remaining = std::chrono::seconds(ttc) - _vehicle->ChargingTime.Elapsed();
+    const std::chrono::milliseconds outage    = UntilOutage();
+    bool exited = WaitFor(std::min(remaining, outage));
+
+    if(outage < remaining && !exited)
+    {
+        if(Verbose())
+        {
+            std::stringstream ss;
+            ss << "Outage, requeueing " << _vehicle->Name();
+            PrintToConsole(ss);
+        }
+
+        std::shared_lock<std::shared_mutex> freeze(_context.FreezeLock);
+
+        // Vehicle keeps the energy charged and needs charged again, it 
+        // rejoins a queue in service next in line
+        _vehicle->AddCharge(_vehicle->ChargingTime.Tok());
+        _vehicle->Requeue();
+
+        _vehicle = nullptr;
+        _busy = false;
+        _interrupted.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if(Verbose())
+    {
+        std::stringstream ss;
+        ss << "Charged " << _vehicle->Name();
+        PrintToConsole(ss);
+    }
+
+    std::shared_lock<std::shared_mutex> freeze(_context.FreezeLock);
+
+    // Save vehicle charge stop time
+    std::chrono::milliseconds lap = _vehicle->ChargingTime.Tok();
+
+    // Charges cut short by the end of the simulation are not recorded
+    if(!exited)
+    {
+        _vehicle->ChargingLaps.Record(lap.count());
+        ChargingLaps.Record(lap.count());
+    }
+
+    // Vehicle is charged
+    _vehicle->ChangeState(CHARGED);
+    _vehicle = nullptr;
+    _busy = false;
+}
+
+/**
+ * @brief Takes the charger out of service for its next outage.  The
+ *        queue is redistributed when no charger of the site is left.
+ * 
+ * @return true  Simulation ended during the outage.
+ * @return false Charger is back in service.
+ */
+bool Charger::OutageAction()
+{
+    const ChargerOutage outage = _outages.front();
+    _outages.pop_front();
+    if(outage.random)
+        DrawFailure(outage.start_mins + outage.duration_mins);
+
+    if(Verbose())
+    {
+        std::stringstream ss;
+        ss << "Out of service for " << outage.duration_mins << " mins";
+        PrintToConsole(ss);
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> freeze(_context.FreezeLock);
+        _down = true;
+        if(_site.ChargerDown())
+            Redistribute();
+    }
+
+    // Blocks until the repair (an outage may start late, after a charge) OR thread exits
+    const std::chrono::steady_clock::time_point t1  = std::chrono::steady_clock::now();
+    const std::chrono::steady_clock::time_point end = _started + std::chrono::seconds(outage.start_mins + outage.duration_mins);
+    bool exited = WaitFor(std::max(std::chrono::steady_clock::duration::zero(), end - t1));
+
+    if(Verbose())
+    {
+        std::stringstream ss;
+        ss << "Back in service";
+        PrintToConsole(ss);
+    }
+
+    std::shared_lock<std::shared_mutex> freeze(_context.FreezeLock);
+    _site.ChargerUp();
+    _down = false;
+
+    // Outages cut short by the end of the simulation are not recorded
+    if(!exited)
+        OutageLaps.Record(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t1).count());
+
+    return exited;
+}
+
+/**
+ * @brief Moves the vehicles waiting at this charger's site to the 
+ *        nearest site with a charger in service, in one lock of each
+ *        queue, as many as its queue has room for.  The rest wait here
+ *        for the repair.  Called with the FreezeLock held.
+ * 
+ */
+void Charger::Redistribute()
+{
+    // Without a site in service the vehicles wait here for the repair
+    Site& fallback = _site.Fallback();
+    if(&fallback == &_site)
+        return;
+
+    std::vector<std::shared_ptr<Vehicle>> waiting;
+    _site.Queue.try_dequeue_bulk(std::back_inserter(waiting), SIZE_MAX);
+    // Moved before joining, a charger there may take them at once
+    for(auto const& v : waiting)
+        v->MoveTo(fallback);
+
+    // Keeps their order and queueing start times (the hop is not flown)
+    const size_t moved = fallback.JoinBulk(std::make_move_iterator(waiting.begin()), std::make_move_iterator(waiting.end()));
+    _site.CountRedistributed(moved);
+
+    // Those the fallback has no room for stay first in line here, no
+    // vehicle joins a site that is down
+    for(auto v = waiting.begin() + moved; v != waiting.end(); ++v)
+        (*v)->MoveTo(_site);
+    _site.Queue.enqueue_bulk(std::make_move_iterator(waiting.begin() + moved), std::make_move_iterator(waiting.end()));
+}
+
+/**
+ * @brief Schedules an outage.  Must be called before the charger is
+ *        started.
+ * 
+ * @param start_mins Start of the outage (mins since the charger started).
+ * @param duration_mins Length of the outage (mins).
+ */
+void Charger::ScheduleOutage(const int64_t start_mins, const int64_t duration_mins)
+{
+    AddOutage({ start_mins, duration_mins, false });
+}
+
+/**
+ * @brief Fails the charger at random, with exponentially distributed
+ *        times between failures and times to repair.  Must be called
+ *        before the charger is started.
+ * 
+ * @param mtbf_mins Mean time (mins) in service between failures.
+ * @param mttr_mins Mean time (mins) to repair.
+ * @param seed Seed of the charger's random number generator.
+ */
+void Charger::EnableFailures(const double mtbf_mins, const double mttr_mins, const uint32_t seed)
+{
+    _mtbf_mins = mtbf_mins;
+    _mttr_mins = mttr_mins;
+    _gen.seed(seed);
+
+    DrawFailure(0);
+}
+
+/**
+ * @brief Draws the next random failure after a time.
+ * 
+ * @param after_mins Time (mins) the charger is back in service.
+ */
+void Charger::DrawFailure(const int64_t after_mins)
+{
+    std::exponential_distribution<> up(1.0 / _mtbf_mins);
+    std::exponential_distribution<> repair(1.0 / _mttr_mins);
+
+    const int64_t start_mins = after_mins + std::llround(up(_gen));
+    AddOutage({ start_mins, std::max<int64_t>(1, std::llround(repair(_gen))), true });
+}
+
+/**
+ * @brief Adds an outage to those to come, after those starting at the 
+ *        same time.
+ * 
+ * @param outage Outage.
+ */
+void Charger::AddOutage(const ChargerOutage& outage)
+{
+    _outages.insert(std::upper_bound(_outages.begin(), _outages.end(), outage, [](const ChargerOutage& a, const ChargerOutage& b) {
+        return a.start_mins < b.start_mins;
+    }), outage);
+}
+
+/**
+ * @brief Time (ms) until the next outage starts, 0 when it is due.
+ * 
+ * @return std::chrono::milliseconds Time until the outage, max() when none.
+ */
+std::chrono::milliseconds Charger::UntilOutage() const
+{
+    if(_outages.empty())
+        return std::chrono::milliseconds::max();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _started);
+    return std::max(std::chrono::milliseconds(0), std::chrono::seconds(_outages.front().start_mins) - elapsed);
+}
+
+/**
+ * @brief Restores the state of this charger from a snapshot.  Must be
+ *        called before the charger is started.
+ * 
+ * @param vehicle Vehicle being charged, nullptr when idle.
+ */
+void Charger::Restore(std::shared_ptr<Vehicle> vehicle)
+{
+    _vehicle = vehicle;
+    _busy = vehicle != nullptr;
 }
 
 /**
@@ -39,51 +317,66 @@ void Charger::Run()
 {
     std::shared_ptr<Vehicle> v;
 
-    std::stringstream ss;
-    ss << "Running...";
-    PrintToConsole(ss);
+    if(Verbose())
+    {
+        std::stringstream ss;
+        ss << "Running...";
+        PrintToConsole(ss);
+    }
+    PROFILE_THREAD(Header());
+
+    // Outages are timed from here
+    _started = std::chrono::steady_clock::now();
+
+    // Finish charging a restored vehicle
+    if(_vehicle)
+        ChargeAction();
 
     // Charge vehicles
-    while(_thread_state != ThreadState::EXIT)
+    while(!StopRequested())
     {
-        // sleep at every iteration to reduce CPU usage
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        // sleep at every iteration to reduce CPU usage (wakes early on stop)
+        if(WaitFor(std::chrono::milliseconds(1)))
+            break;
+
+        // Goes out of service between charges when an outage is due
+        if(UntilOutage().count() == 0)
+        {
+            if(OutageAction())
+                break;
+            continue;
+        }
 
-        // Check to see if there are any vehicles waiting to be charged
-        if(_charging_q.try_dequeue(v))
         {
+            PROFILE_SCOPE("Charger::Dequeue");
+            std::shared_lock<std::shared_mutex> freeze(_context.FreezeLock);
+
+            // Check to see if there are any vehicles waiting to be charged
+            if(!_site.Queue.try_dequeue(v))
+                continue;
+
             // Vehicle is charging
             v->ChangeState(CHARGING);
             
-            // Save vehicle queue start time
-            v->QingTime.Tok();
-
-            int64_t ttc = v->ChargeTime();
-
-            ss.str("");
-            ss << "Charging Vehicle " << v->Name() << " for " << ttc << " mins";
-            PrintToConsole(ss);
+            // Save vehicle queue stop time
+            std::chrono::milliseconds lap = v->QingTime.Tok();
+            v->QingLaps.Record(lap.count());
+            QingLaps.Record(lap.count());
 
             // Save vehicle charge start time
             v->ChargingTime.Tik();
 
-            // Blocks for desired seconds OR thread exits
-            WaitFor(std::chrono::seconds(ttc));
-
-            // Save vehicle charge stop time
-            v->ChargingTime.Tok();
-
-            ss.str("");
-            ss << "Charged " << v->Name();
-            PrintToConsole(ss);
-
-            // Vehicle is charged
-            v->ChangeState(CHARGED);
+            _vehicle = v;
+            _busy = true;
         }
+
+        ChargeAction();
     }
 
     // Need to handle vehicle queue time for vehicles that are currently in 
-    // the charging queue when the simulation ends
-    while(_charging_q.try_dequeue(v))
-        v->QingTime.Tok();
+    // the charging queue when the simulation ends, drained in one lock
+    std::vector<std::shared_ptr<Vehicle>> waiting;
+    _site.Queue.try_dequeue_bulk(std::back_inserter(waiting), SIZE_MAX);
+    for(auto const& w : waiting)
+        w->QingTime.Tok();
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+#include "ChargingModel.h"
+
+/**
+ * @brief Construct a new ChargingModel object.
+ *
+ * @param num_chargers Number of chargers.
+ * @throws std::invalid_argument No chargers.
+ */
+ChargingModel::ChargingModel(const uint16_t num_chargers) : _num_chargers(num_chargers),
+                                                            _classes()
+{
+    if(num_chargers == 0)
+        throw std::invalid_argument("Charging model needs at least one charger");
+}
+
+/**
+ * @brief Creates a model of a fleet, with one class for each vehicle type.
+ *
+ * @param vehicles Vehicles of the fleet.
+ * @param num_chargers Number of chargers.
+ * @return ChargingModel Model of the fleet.
+ */
+ChargingModel ChargingModel::FromVehicles(const std::vector<std::shared_ptr<Vehicle>>& vehicles,
+                                          const uint16_t                               num_chargers)
+{
+    std::map<std::string, std::vector<std::shared_ptr<Vehicle>>> types;
+    for(auto const& v : vehicles)
+        types[v->Name()].push_back(v);
+
+    // Simulation minutes are StopWatch seconds
+    ChargingModel model(num_chargers);
+    for(auto const& [name, val] : types)
+        model.AddClass(name, val.size(), val[0]->CruiseTime(), val[0]->ChargeTime());
+
+    return model;
+}
+
+/**
+ * @brief Adds a class of identical vehicles.
+ *
+ * @param name Name of vehicle class.
+ * @param population Number of vehicles of this class.
+ * @param cruise_mins Time (mins) cruising between charges.
+ * @param charge_mins Time (mins) to charge.
+ */
+void ChargingModel::AddClass(const std::string& name,
+                             const uint16_t     population,
+                             const double       cruise_mins,
+                             const double       charge_mins)
+{
+    _classes.push_back({ name, population, cruise_mins, charge_mins });
+}
+
+/**
+ * @brief Copy of this model with a different number of chargers.
+ *
+ * @param num_chargers Number of chargers.
+ * @return ChargingModel Model with num_chargers.
+ */
+ChargingModel ChargingModel::WithChargers(const uint16_t num_chargers) const
+{
+    ChargingModel model(num_chargers);
+    model._classes = _classes;
+    return model;
+}
+
+/**
+ * @brief Solves the model.
+ *
+ * @param tolerance Largest change of any queue length between iterations
+ *                  at which the solution has converged.
+ * @param max_iterations Iterations after which the solution is returned
+ *                       even if it has not converged.
+ * @return ChargingEstimate Predicted performance.
+ */
+ChargingEstimate ChargingModel::Solve(const double tolerance, const unsigned max_iterations) const
+{
+    const size_t K = _classes.size();
+    const double c = _num_chargers;
+
+    // Seidmann: c servers of time S ~ one server of time S/c plus a delay of S(c-1)/c
+    std::vector<double> demand(K), delay(K);
+    for(size_t k = 0; k < K; ++k)
+    {
+        demand[k] = _classes[k].charge_mins / c;
+        delay[k]  = _classes[k].cruise_mins + _classes[k].charge_mins * (c - 1) / c;
+    }
+
+    // Vehicles queued or charging, initially half of each class
+    std::vector<double> queued(K), residence(K), throughput(K);
+    for(size_t k = 0; k < K; ++k)
+        queued[k] = _classes[k].population / 2.0;
+
+    ChargingEstimate estimate {};
+    estimate.num_chargers = _num_chargers;
+
+    while(estimate.iterations < max_iterations)
+    {
+        ++estimate.iterations;
+
+        // Work (mins) queued at the chargers
+        double work = 0.0;
+        for(size_t k = 0; k < K; ++k)
+            work += queued[k] * demand[k];
+
+        double change = 0.0;
+        for(size_t k = 0; k < K; ++k)
+        {
+            const double n = _classes[k].population;
+            if(n == 0)
+                continue;
+
+            // Schweitzer: an arriving vehicle sees the queue without itself,
+            // and waits (FCFS) for the work of every vehicle ahead of it
+            residence[k]  = demand[k] + work - queued[k] / n * demand[k];
+            throughput[k] = n / (delay[k] + residence[k]);
+
+            const double q = throughput[k] * residence[k];
+            change = std::max(change, std::fabs(q - queued[k]));
+            queued[k] = q;
+        }
+
+        if(change < tolerance)
+            break;
+    }
+
+    for(size_t k = 0; k < K; ++k)
+    {
+        ClassEstimate ce { _classes[k].name, _classes[k].population, 0.0, 0.0, 0.0 };
+        if(ce.population)
+        {
+            ce.qing_mins  = residence[k] - demand[k];
+            ce.cycle_mins = delay[k] + residence[k];
+            ce.throughput = throughput[k];
+        }
+
+        estimate.utilization  += ce.throughput * _classes[k].charge_mins / c;
+        estimate.queue_length += ce.throughput * ce.qing_mins;
+        estimate.classes.push_back(ce);
+    }
+
+    estimate.utilization = std::min(estimate.utilization, 1.0);
+    return estimate;
+}
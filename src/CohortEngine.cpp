@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "CohortEngine.h"
+
+/**
+ * @brief Construct a new CohortEngine object.
+ *
+ * @param num_vehicles Number of vehicles.
+ * @param num_vehicle_types Number of vehicle types.
+ * @param num_chargers Number of chargers.
+ * @param num_sites Number of sites the vehicles and chargers are spread over.
+ * @param num_threads Number of threads (cohorts), 0 for one per core.
+ */
+CohortEngine::CohortEngine(const uint32_t       num_vehicles,
+                           const unsigned short num_vehicle_types,
+                           const unsigned short num_chargers,
+                           const unsigned short num_sites,
+                           const unsigned       num_threads) : _num_chargers     (num_chargers),
+                                                               _num_vehicles     (num_vehicles),
+                                                               _num_vehicle_types(num_vehicle_types),
+                                                               _num_threads      (num_threads ? num_threads : std::max(1u, std::thread::hardware_concurrency())),
+                                                               _context(),
+                                                               _gen(std::random_device()()),
+                                                               _topology(num_sites),
+                                                               _prototypes(),
+                                                               _types(),
+                                                               _sites(),
+                                                               _lanes_per_cohort(1),
+                                                               _cohorts(),
+                                                               _landed(),
+                                                               _transitions(),
+                                                               _arrivals(),
+                                                               _queues(),
+                                                               _free_ms(),
+                                                               _clock_ms(0)
+{
+    _topology.AssignChargingSites(num_chargers);
+}
+
+/**
+ * @brief Seeds the random number generator, so a run can be repeated.
+ *        Must be called before Create().
+ *
+ * @param seed Seed of the random number generator.
+ */
+void CohortEngine::Seed(const uint32_t seed)
+{
+    _gen.seed(seed);
+}
+
+/**
+ * @brief Creates random vehicles, a lane of a cohort each, and the
+ *        chargers of each site.
+ *
+ * @return size_t Number of vehicles.
+ */
+size_t CohortEngine::Create()
+{
+    for(unsigned short t = 0; t < _num_vehicle_types; ++t)
+        _prototypes.push_back(Vehicle::Create(static_cast<VehicleType>(t), 0, _topology.At(0), _context));
+
+    // Same draws as Simulation::Create(), so a seed gives the same fleet
+    std::uniform_int_distribution<> distr(0, _num_vehicle_types-1);
+
+    _types.reserve(_num_vehicles);
+    _sites.reserve(_num_vehicles);
+    for(uint32_t i = 0; i < _num_vehicles; ++i)
+    {
+        _types.push_back(uint16_t(distr(_gen)));
+        _sites.push_back(uint16_t(i % _topology.Size()));
+    }
+
+    // Consecutive vehicles share a cohort, no more cohorts than vehicles
+    _lanes_per_cohort = std::max<uint32_t>(1, (_num_vehicles + _num_threads - 1) / _num_threads);
+    _cohorts.resize((_num_vehicles + _lanes_per_cohort - 1) / _lanes_per_cohort);
+    _landed.resize(_cohorts.size());
+    _transitions.resize(_cohorts.size(), 0);
+    _arrivals.reserve(_num_vehicles);
+
+    for(uint32_t i = 0; i < _num_vehicles; ++i)
+        _cohorts[CohortOf(i)].Add(*_prototypes[_types[i]]);
+
+    _queues.resize(_topology.Size());
+    _free_ms.resize(_topology.Size());
+    for(unsigned short i = 0; i < _num_chargers; ++i)
+        _free_ms[_topology.SiteOfCharger(i).ID()].push(_clock_ms);
+
+    return _num_vehicles;
+}
+
+/**
+ * @brief Runs the simulation for a further sim_time_secs.
+ *
+ * @param sim_time_secs Duration (seconds) to run, one simulated minute each.
+ * @return size_t Number of transitions of the vehicles.
+ * @throws std::invalid_argument The run would end past COHORT_ENGINE_MAX_MS.
+ */
+size_t CohortEngine::Run(const int64_t sim_time_secs)
+{
+    if(sim_time_secs < 0 || sim_time_secs > (COHORT_ENGINE_MAX_MS - _clock_ms) / 1000)
+        throw std::invalid_argument("Parallel engine runs end within " + std::to_string(COHORT_ENGINE_MAX_MS / 1000) + " secs of simulation time");
+
+    const int32_t end_ms = int32_t(_clock_ms + sim_time_secs * 1000);
+    size_t before = 0;
+    for(size_t t : _transitions)
+        before += t;
+
+    // The last thread to reach the end of a step runs its serial part and
+    // moves the clock on before any thread starts the next step
+    std::barrier step(std::ptrdiff_t(_cohorts.size()), [this, end_ms]() noexcept {
+        const int32_t now_ms = std::min(_clock_ms + COHORT_ENGINE_STEP_MS, end_ms);
+        AssignChargers(now_ms);
+        _clock_ms = now_ms;
+    });
+
+    auto advance = [this, end_ms, &step](const size_t c) {
+        while(_clock_ms < end_ms)
+        {
+            const int32_t now_ms = std::min(_clock_ms + COHORT_ENGINE_STEP_MS, end_ms);
+            _transitions[c] += _cohorts[c].Advance(now_ms, _landed[c]);
+            step.arrive_and_wait();
+        }
+    };
+
+    // The calling thread advances the first cohort
+    std::vector<std::thread> threads;
+    for(size_t c = 1; c < _cohorts.size(); ++c)
+        threads.emplace_back(advance, c);
+    if(!_cohorts.empty())
+        advance(0);
+    else
+        _clock_ms = end_ms;
+
+    for(auto& thread : threads)
+        thread.join();
+
+    size_t after = 0;
+    for(size_t t : _transitions)
+        after += t;
+    return after - before;
+}
+
+/**
+ * @brief Serial part of a step, run by the last thread to reach the end
+ *        of the step: queues the vehicles that landed at their charging
+ *        site and starts the charges due by the end of the step.
+ *
+ * @param now_ms Simulation time (ms) of the end of the step.
+ */
+void CohortEngine::AssignChargers(const int32_t now_ms)
+{
+    // Vehicles that landed during the step, in the order they landed
+    _arrivals.clear();
+    for(size_t c = 0; c < _cohorts.size(); ++c)
+    {
+        for(uint32_t lane : _landed[c])
+            _arrivals.push_back(uint32_t(c * _lanes_per_cohort + lane));
+        _landed[c].clear();
+    }
+
+    auto landed_ms = [this](const uint32_t id) { return _cohorts[CohortOf(id)].NextEvent(id % _lanes_per_cohort); };
+    std::sort(_arrivals.begin(), _arrivals.end(), [&landed_ms](const uint32_t a, const uint32_t b) {
+        return landed_ms(a) != landed_ms(b) ? landed_ms(a) < landed_ms(b) : a < b;
+    });
+
+    // Flew to the next site on its route, queues at the nearest site with chargers
+    for(uint32_t id : _arrivals)
+    {
+        Site& site = _topology.At(_sites[id]).Route(uint16_t(id)).ChargingSite();
+        _sites[id] = site.ID();
+        _queues[site.ID()].push_back(id);
+    }
+
+    // A charge starts when both its charger and its vehicle are ready
+    for(size_t s = 0; s < _queues.size(); ++s)
+    {
+        auto& queue = _queues[s];
+        auto& free  = _free_ms[s];
+        while(!queue.empty() && !free.empty() && free.top() <= now_ms)
+        {
+            const uint32_t id   = queue.front();
+            VehicleCohort& cohort = _cohorts[CohortOf(id)];
+            const uint32_t lane = id % _lanes_per_cohort;
+
+            const int32_t start_ms = std::max(free.top(), cohort.NextEvent(lane));
+            free.pop();
+            queue.pop_front();
+
+            cohort.StartCharging(lane, start_ms);
+            free.push(cohort.NextEvent(lane));
+        }
+    }
+}
+
+/**
+ * @brief Number of vehicles waiting for a charger at every site.
+ *
+ * @return size_t Number of vehicles waiting.
+ */
+size_t CohortEngine::QueueLength() const
+{
+    size_t length = 0;
+    for(auto const& queue : _queues)
+        length += queue.size();
+    return length;
+}
+
+/**
+ * @brief Calculates the results for each vehicle type (VehicleA,
+ *        VehicleB, ...), the same as Simulation does.
+ *
+ * @param sim_time_secs Duration (seconds) the simulation ran.
+ * @return std::vector<VehicleTypeMetrics> Results of each type, by name.
+ */
+std::vector<VehicleTypeMetrics> CohortEngine::MetricsForEachVehicleType(const int64_t sim_time_secs) const
+{
+    // Totals (ms) of cruise, charge and queueing time by type name, including
+    // the part of each vehicle's current state run so far
+    std::map<std::string, std::array<int64_t, 4>> totals;
+    std::map<std::string, const Vehicle*> types;
+    for(uint32_t i = 0; i < _num_vehicles; ++i)
+    {
+        const Vehicle& type = *_prototypes[_types[i]];
+        std::array<int64_t, 4>& t = totals[type.Name()];
+        types[type.Name()] = &type;
+
+        const VehicleCohort& cohort = _cohorts[CohortOf(i)];
+        const uint32_t       lane   = i % _lanes_per_cohort;
+        const int64_t        left   = int64_t(cohort.NextEvent(lane)) - _clock_ms;
+        const VehicleStateType state = cohort.State(lane);
+
+        t[0] += 1;
+        t[1] += cohort.CruisingTotal(lane) + (state == CRUISING      ? type.CruiseTime() * 1000 - left : 0);
+        t[2] += cohort.ChargingTotal(lane) + (state == CHARGING      ? type.ChargeTime() * 1000 - left : 0);
+        t[3] += cohort.QingTotal(lane)     + (state == NEEDS_CHARGED ? -left : 0);
+    }
+
+    std::vector<VehicleTypeMetrics> metrics;
+    for(auto const& [key, t] : totals)
+    {
+        const Vehicle& type = *types[key];
+
+        const double total_cruise = t[1] / 1000.0;
+        const double total_charge = t[2] / 1000.0;
+        const double total_q      = t[3] / 1000.0;
+
+        VehicleTypeMetrics m;
+        m.name         = key;
+        m.num_vehicles = t[0];
+        m.cruise_mins  = total_cruise / m.num_vehicles;
+        m.charge_mins  = total_charge / m.num_vehicles;
+        m.qing_mins    = total_q      / m.num_vehicles;
+        m.cruise_pct   = total_cruise / double(sim_time_secs * m.num_vehicles) * 100.0;
+        m.charge_pct   = total_charge / double(sim_time_secs * m.num_vehicles) * 100.0;
+        m.qing_pct     = total_q      / double(sim_time_secs * m.num_vehicles) * 100.0;
+        m.distance     = type.PassengerCount() * type.CruiseSpeed() * total_cruise / 60;
+        m.max_faults   = sim_time_secs / 60.0 * type.ProbabilityOfFault() * m.num_vehicles;
+        metrics.push_back(m);
+    }
+
+    return metrics;
+}
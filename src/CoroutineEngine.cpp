@@ -0,0 +1,343 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "CoroutineEngine.h"
+
+/**
+ * @brief Construct a new CoroutineEngine object.
+ *
+ * @param num_vehicles Number of vehicles.
+ * @param num_vehicle_types Number of vehicle types.
+ * @param num_chargers Number of chargers.
+ * @param num_sites Number of sites the vehicles and chargers are spread over.
+ */
+CoroutineEngine::CoroutineEngine(const uint32_t       num_vehicles,
+                                 const unsigned short num_vehicle_types,
+                                 const unsigned short num_chargers,
+                                 const unsigned short num_sites) : _num_chargers     (num_chargers),
+                                                                   _num_vehicles     (num_vehicles),
+                                                                   _num_vehicle_types(num_vehicle_types),
+                                                                   _context(),
+                                                                   _gen(std::random_device()()),
+                                                                   _topology(num_sites),
+                                                                   _prototypes(),
+                                                                   _vehicles(),
+                                                                   _queues(),
+                                                                   _technicians(0),
+                                                                   _mean_repair_mins(0.0),
+                                                                   _sample_secs(0),
+                                                                   _maintenance(),
+                                                                   _faults(0),
+                                                                   _repairs(0),
+                                                                   _grounded(0),
+                                                                   _availability(),
+                                                                   _executor()
+{
+    _topology.AssignChargingSites(num_chargers);
+}
+
+/**
+ * @brief Seeds the random number generator, so a run can be repeated.
+ *        Must be called before Create().
+ *
+ * @param seed Seed of the random number generator.
+ */
+void CoroutineEngine::Seed(const uint32_t seed)
+{
+    _gen.seed(seed);
+}
+
+/**
+ * @brief Grounds vehicles that fault in flight until a technician has
+ *        repaired them, with exponentially distributed repair times,
+ *        and samples the fleet's availability.  Must be called before
+ *        Create().
+ *
+ * @param technicians Number of vehicles repaired at the same time.
+ * @param mean_repair_mins Mean time (mins) to repair a vehicle.
+ * @param sample_secs Interval (seconds) availability is sampled at, 0 for none.
+ */
+void CoroutineEngine::EnableMaintenance(const uint16_t technicians, const double mean_repair_mins, const int64_t sample_secs)
+{
+    _technicians      = technicians;
+    _mean_repair_mins = mean_repair_mins;
+    _sample_secs      = sample_secs;
+}
+
+/**
+ * @brief Creates random vehicles and the chargers, and spawns a process
+ *        for each.
+ *
+ * @return size_t Number of processes.
+ */
+size_t CoroutineEngine::Create()
+{
+    for(unsigned short t = 0; t < _num_vehicle_types; ++t)
+        _prototypes.push_back(Vehicle::Create(static_cast<VehicleType>(t), 0, _topology.At(0), _context));
+
+    for(size_t s = 0; s < _topology.Size(); ++s)
+        _queues.push_back(std::make_unique<Channel<CoVehicle*>>(_executor));
+
+    // Same draws as Simulation::Create(), so a seed gives the same fleet
+    std::uniform_int_distribution<> distr(0, _num_vehicle_types-1);
+
+    _vehicles.reserve(_num_vehicles);
+    for(uint32_t i = 0; i < _num_vehicles; ++i)
+    {
+        const uint16_t type = uint16_t(distr(_gen));
+        const uint16_t site = uint16_t(i % _topology.Size());
+        _vehicles.push_back({ i, type, site, INITIAL, 0, 0, 0, 0, 0, nullptr });
+    }
+
+    for(auto& v : _vehicles)
+        _executor.Spawn(VehicleProcess(v));
+
+    for(unsigned short i = 0; i < _num_chargers; ++i)
+        _executor.Spawn(ChargerProcess(*_queues[_topology.SiteOfCharger(i).ID()]));
+
+    if(_technicians > 0)
+    {
+        _maintenance = std::make_unique<Channel<CoVehicle*>>(_executor);
+        for(uint16_t i = 0; i < _technicians; ++i)
+            _executor.Spawn(TechnicianProcess(*_maintenance));
+
+        if(_sample_secs > 0)
+            _executor.Spawn(AvailabilityProcess(_sample_secs * 1000));
+    }
+
+    return _executor.Processes();
+}
+
+/**
+ * @brief Behavior of a vehicle: cruise, queue, charge, repeat.
+ *
+ * @param vehicle Vehicle.
+ * @return Process Process of the vehicle.
+ */
+Process CoroutineEngine::VehicleProcess(CoVehicle& vehicle)
+{
+    const int64_t cruise_ms = _prototypes[vehicle.type]->CruiseTime() * 1000;
+
+    for(;;)
+    {
+        // Flies a full battery to the next site on its route
+        vehicle.state    = CRUISING;
+        vehicle.since_ms = _executor.Now();
+        vehicle.site     = _topology.At(vehicle.site).Route(uint16_t(vehicle.id)).ID();
+        co_await _executor.Delay(cruise_ms);
+        vehicle.cruise_total_ms += cruise_ms;
+
+        // A vehicle that faulted in flight is grounded until repaired
+        if(_maintenance && DrawFault(vehicle, cruise_ms))
+        {
+            vehicle.state    = MAINTENANCE;
+            vehicle.since_ms = _executor.Now();
+            ++_faults;
+            ++_grounded;
+            co_await Serve{ *_maintenance, vehicle };
+            vehicle.maintenance_total_ms += _executor.Now() - vehicle.since_ms;
+            --_grounded;
+        }
+
+        // Queues at the nearest site with chargers until it is charged
+        vehicle.state    = NEEDS_CHARGED;
+        vehicle.since_ms = _executor.Now();
+        vehicle.site     = _topology.At(vehicle.site).ChargingSite().ID();
+        co_await Serve{ *_queues[vehicle.site], vehicle };
+    }
+}
+
+/**
+ * @brief Behavior of a charger: take the next vehicle, charge it, repeat.
+ *
+ * @param queue Charging queue of the charger's site.
+ * @return Process Process of the charger.
+ */
+Process CoroutineEngine::ChargerProcess(Channel<CoVehicle*>& queue)
+{
+    for(;;)
+    {
+        CoVehicle* vehicle = co_await queue.Pop();
+        vehicle->qing_total_ms += _executor.Now() - vehicle->since_ms;
+
+        // The battery is empty after a full battery flight
+        const int64_t charge_ms = _prototypes[vehicle->type]->ChargeTime() * 1000;
+        vehicle->state    = CHARGING;
+        vehicle->since_ms = _executor.Now();
+        co_await _executor.Delay(charge_ms);
+        vehicle->charge_total_ms += charge_ms;
+
+        _executor.Wake(vehicle->handle);
+    }
+}
+
+/**
+ * @brief Behavior of a technician: take the next grounded vehicle,
+ *        repair it, repeat.
+ *
+ * @param queue Maintenance queue.
+ * @return Process Process of the technician.
+ */
+Process CoroutineEngine::TechnicianProcess(Channel<CoVehicle*>& queue)
+{
+    std::exponential_distribution<> repair(1.0 / _mean_repair_mins);
+
+    for(;;)
+    {
+        CoVehicle* vehicle = co_await queue.Pop();
+
+        // One simulated minute is 1000 ms
+        co_await _executor.Delay(std::max<int64_t>(1, std::llround(repair(_gen) * 1000)));
+        ++_repairs;
+
+        _executor.Wake(vehicle->handle);
+    }
+}
+
+/**
+ * @brief Samples the fleet's availability every interval.
+ *
+ * @param interval_ms Sampling interval (ms).
+ * @return Process Process of the sampler.
+ */
+Process CoroutineEngine::AvailabilityProcess(const int64_t interval_ms)
+{
+    for(;;)
+    {
+        _availability.push_back({ _executor.Now(), _grounded, 1.0 - double(_grounded) / _num_vehicles });
+        co_await _executor.Delay(interval_ms);
+    }
+}
+
+/**
+ * @brief Draws whether a flight faults.
+ *
+ * @param vehicle Vehicle flying.
+ * @param cruise_ms Flight time (ms).
+ * @return true  Vehicle faulted and is grounded when it lands.
+ * @return false Vehicle flew without a fault.
+ */
+bool CoroutineEngine::DrawFault(const CoVehicle& vehicle, const int64_t cruise_ms)
+{
+    // Faults arrive at ProbabilityOfFault() per hour of flight (Poisson)
+    const double hours = cruise_ms / 1000.0 / 60.0;
+    std::bernoulli_distribution fault(1.0 - std::exp(-_prototypes[vehicle.type]->ProbabilityOfFault() * hours));
+    return fault(_gen);
+}
+
+/**
+ * @brief Runs the simulation for a further sim_time_secs.
+ *
+ * @param sim_time_secs Duration (seconds) to run, one simulated minute each.
+ * @return size_t Number of times a process was resumed.
+ */
+size_t CoroutineEngine::Run(const int64_t sim_time_secs)
+{
+    return _executor.Run(_executor.Now() + sim_time_secs * 1000);
+}
+
+/**
+ * @brief Number of vehicles waiting for a charger at every site.
+ *
+ * @return size_t Number of vehicles waiting.
+ */
+size_t CoroutineEngine::QueueLength() const
+{
+    size_t length = 0;
+    for(auto const& queue : _queues)
+        length += queue->Size();
+    return length;
+}
+
+/**
+ * @brief Prints the faults, repairs and the fleet's availability over
+ *        the run.  Requires EnableMaintenance().
+ *
+ */
+void CoroutineEngine::PrintMaintenance() const
+{
+    double mean = 0.0, min = 1.0;
+    for(auto const& sample : _availability)
+    {
+        mean += sample.fraction;
+        min   = std::min(min, sample.fraction);
+    }
+    if(!_availability.empty())
+        mean /= _availability.size();
+
+    int64_t maintenance_ms = 0;
+    for(auto const& v : _vehicles)
+        maintenance_ms += v.maintenance_total_ms + (v.state == MAINTENANCE ? _executor.Now() - v.since_ms : 0);
+
+    std::cout << "\n\nMaintenance" << std::endl;
+    std::cout << "----------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|  Technicians  |  Faults  |  Repairs  |  Grounded (mins)  |  Avg Available  |  Min Available  |" << std::endl;
+    std::cout << "----------------------------------------------------------------------------------------------" << std::endl;
+
+    std::cout << std::setprecision(2) << std::fixed;
+    std::cout << "|"   << std::right << std::setw(13) << std::setfill(' ') << _technicians;
+    std::cout << "  |" << std::setw(8)  << _faults;
+    std::cout << "  |" << std::setw(9)  << _repairs;
+    std::cout << "  |" << std::setw(17) << maintenance_ms / 1000.0;
+    std::cout << "  |" << std::setw(13) << mean * 100.0 << " %";
+    std::cout << "  |" << std::setw(13) << min  * 100.0 << " %";
+    std::cout << "  |" << std::endl;
+    std::cout << "----------------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Calculates the results for each vehicle type (VehicleA,
+ *        VehicleB, ...), the same as Simulation does.
+ *
+ * @param sim_time_secs Duration (seconds) the simulation ran.
+ * @return std::vector<VehicleTypeMetrics> Results of each type, by name.
+ */
+std::vector<VehicleTypeMetrics> CoroutineEngine::MetricsForEachVehicleType(const int64_t sim_time_secs) const
+{
+    // Totals (ms) of cruise, charge and queueing time by type name, including
+    // the part of each vehicle's current state run so far
+    std::map<std::string, std::array<int64_t, 4>> totals;
+    std::map<std::string, const Vehicle*> types;
+    for(auto const& v : _vehicles)
+    {
+        const Vehicle& type = *_prototypes[v.type];
+        std::array<int64_t, 4>& t = totals[type.Name()];
+        types[type.Name()] = &type;
+
+        const int64_t elapsed = _executor.Now() - v.since_ms;
+        t[0] += 1;
+        t[1] += v.cruise_total_ms + (v.state == CRUISING      ? elapsed : 0);
+        t[2] += v.charge_total_ms + (v.state == CHARGING      ? elapsed : 0);
+        t[3] += v.qing_total_ms   + (v.state == NEEDS_CHARGED ? elapsed : 0);
+    }
+
+    std::vector<VehicleTypeMetrics> metrics;
+    for(auto const& [key, t] : totals)
+    {
+        const Vehicle& type = *types[key];
+
+        const double total_cruise = t[1] / 1000.0;
+        const double total_charge = t[2] / 1000.0;
+        const double total_q      = t[3] / 1000.0;
+
+        VehicleTypeMetrics m;
+        m.name         = key;
+        m.num_vehicles = t[0];
+        m.cruise_mins  = total_cruise / m.num_vehicles;
+        m.charge_mins  = total_charge / m.num_vehicles;
+        m.qing_mins    = total_q      / m.num_vehicles;
+        m.cruise_pct   = total_cruise / double(sim_time_secs * m.num_vehicles) * 100.0;
+        m.charge_pct   = total_charge / double(sim_time_secs * m.num_vehicles) * 100.0;
+        m.qing_pct     = total_q      / double(sim_time_secs * m.num_vehicles) * 100.0;
+        m.distance     = type.PassengerCount() * type.CruiseSpeed() * total_cruise / 60;
+        m.max_faults   = sim_time_secs / 60.0 * type.ProbabilityOfFault() * m.num_vehicles;
+        metrics.push_back(m);
+    }
+
+    return metrics;
+}
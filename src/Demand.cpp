@@ -0,0 +1,90 @@
+#include <numeric>
+
+#include "Demand.h"
+
+/**
+ * @brief Construct a new Demand object.
+ *
+ * @param topology Sites requests are made between.
+ * @param trips_per_min Mean number of requests per minute over a day.
+ * @param seed Seed of the random number generator.
+ */
+Demand::Demand(const Topology& topology, const double trips_per_min, const uint32_t seed) : _topology(topology),
+                                                                                           _trips_per_min(trips_per_min),
+                                                                                           _profile(),
+                                                                                           _gen(seed),
+                                                                                           _next_id(0)
+{
+    // Quiet nights, morning and evening commuter peaks
+    SetProfile({ 0.1, 0.1, 0.1, 0.1, 0.2, 0.5, 1.2, 2.0, 2.2, 1.5, 1.0, 1.0,
+                 1.1, 1.0, 1.0, 1.2, 1.8, 2.3, 2.1, 1.5, 1.0, 0.7, 0.4, 0.2 });
+}
+
+/**
+ * @brief Replaces the time of day profile.  The profile is normalized so
+ *        its mean is 1, i.e. it shapes the demand but keeps trips_per_min.
+ *
+ * @param hourly Relative demand of each hour of the day, from midnight.
+ */
+void Demand::SetProfile(const std::array<double, DEMAND_HOURS>& hourly)
+{
+    double mean = std::accumulate(hourly.begin(), hourly.end(), 0.0) / DEMAND_HOURS;
+
+    for(size_t h = 0; h < DEMAND_HOURS; ++h)
+        _profile[h] = mean > 0.0 ? hourly[h] / mean : 1.0;
+}
+
+/**
+ * @brief Request rate at a point in time.
+ *
+ * @param clock_ms Simulation time (ms), 0 is midnight.
+ * @return double Requests per minute.
+ */
+double Demand::Rate(const int64_t clock_ms) const
+{
+    // 1 ms realtime == 1 ms of simulated minutes, so an hour is 60000 ms
+    size_t hour = (clock_ms / 60000) % DEMAND_HOURS;
+    return _trips_per_min * _profile[hour];
+}
+
+/**
+ * @brief Generates the requests made in a window of time.
+ *
+ * @param from_ms Start of window (ms simulation time).
+ * @param to_ms End of window (ms simulation time).
+ * @param requests Requests are appended to requests.
+ * @return size_t Number of requests generated.
+ */
+size_t Demand::Generate(const int64_t from_ms, const int64_t to_ms, std::vector<TripRequest>& requests)
+{
+    if(to_ms <= from_ms)
+        return 0;
+
+    // Windows are much shorter than an hour, the rate at the midpoint is used
+    const double minutes = (to_ms - from_ms) / 1000.0;
+    std::poisson_distribution<size_t> count(Rate((from_ms + to_ms) / 2) * minutes);
+    std::uniform_int_distribution<int64_t> when(from_ms, to_ms - 1);
+
+    const uint16_t num_sites = _topology.Size();
+    std::uniform_int_distribution<uint16_t> origin(0, num_sites - 1);
+    std::uniform_int_distribution<uint16_t> other(0, num_sites > 1 ? num_sites - 2 : 0);
+
+    size_t n = count(_gen);
+    requests.reserve(requests.size() + n);
+    for(size_t i = 0; i < n; ++i)
+    {
+        TripRequest request;
+        request.id           = _next_id++;
+        request.origin       = origin(_gen);
+        request.requested_ms = when(_gen);
+
+        // Destination is any other site (the same site when there is only one)
+        request.destination = other(_gen);
+        if(num_sites > 1 && request.destination >= request.origin)
+            ++request.destination;
+
+        requests.push_back(request);
+    }
+
+    return n;
+}
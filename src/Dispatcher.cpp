@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <iomanip>
+
+#include "Dispatcher.h"
+
+/**
+ * @brief Construct a new Dispatcher object.
+ *
+ * @param demand Generates the trip requests.
+ * @param vehicles Vehicles flying trips.
+ * @param topology Sites requests are made between.
+ * @param max_wait_mins Duration (mins) a request waits before it is lost.
+ * @param context State shared by all objects of the simulation.
+ */
+Dispatcher::Dispatcher(Demand&                                      demand,
+                       const std::vector<std::shared_ptr<Vehicle>>& vehicles,
+                       const Topology&                              topology,
+                       const int64_t                                max_wait_mins,
+                       SimulationContext&                           context) : SimulationObject(context),
+                                                                               _demand(demand),
+                                                                               _vehicles(vehicles),
+                                                                               _topology(topology),
+                                                                               _max_wait_ms(max_wait_mins * 1000),
+                                                                               _available(DISPATCH_CELL_MILES),
+                                                                               _backlog(),
+                                                                               _unmatched(),
+                                                                               _last_ms(0),
+                                                                               _clock_offset_ms(0),
+                                                                               _requests(0),
+                                                                               _assigned(0),
+                                                                               _lost(0)
+{ }
+
+/**
+ * @brief String used to uniquely identify this object.
+ *
+ * @return const std::string Header used to uniquely identify dispatcher.
+ */
+const std::string Dispatcher::Header()
+{
+    return "<Dispatcher> ";
+}
+
+/**
+ * @brief Sets the simulation time the next run starts at.  Must be
+ *        called before the dispatcher is started.
+ *
+ * @param clock_offset_ms Simulation time (ms) elapsed before the run.
+ */
+void Dispatcher::Prepare(const int64_t clock_offset_ms)
+{
+    _clock_offset_ms = clock_offset_ms;
+    _last_ms = clock_offset_ms;
+}
+
+/**
+ * @brief Adds a request made outside of the demand model.  It is 
+ *        dispatched by the next tick.
+ *
+ * @param request Trip request.
+ */
+void Dispatcher::Submit(const TripRequest& request)
+{
+    _backlog.push_back(request);
+    ++_requests;
+}
+
+/**
+ * @brief Generates the requests made since the previous tick and assigns
+ *        as many waiting requests as possible to idle vehicles.
+ *
+ * @param clock_ms Simulation time (ms) of the tick.
+ * @return size_t Number of requests assigned.
+ */
+size_t Dispatcher::Dispatch(const int64_t clock_ms)
+{
+    _requests += _demand.Generate(_last_ms, clock_ms, _backlog);
+    _last_ms = std::max(_last_ms, clock_ms);
+
+    // Bring the index of available vehicles up to date; vehicles that did
+    // not leave their cell since the previous tick are only repositioned
+    for(uint32_t i = 0; i < _vehicles.size(); ++i)
+    {
+        const Vehicle& v = *_vehicles[i];
+        if(v.Available())
+            _available.Move(i, v.Location().X(), v.Location().Y());
+        else
+            _available.Remove(i);
+    }
+
+    size_t assigned = 0;
+    _unmatched.clear();
+
+    for(const TripRequest& request : _backlog)
+    {
+        if(clock_ms - request.requested_ms > _max_wait_ms)
+        {
+            ++_lost;
+            continue;
+        }
+
+        Site& origin      = _topology.At(request.origin);
+        Site& destination = _topology.At(request.destination);
+
+        // Nearest idle vehicle with the energy to fly the trip
+        int64_t nearest = _available.Nearest(origin.X(), origin.Y(), [&](uint32_t i) {
+            const Vehicle& v = *_vehicles[i];
+            return v.FlightEnergy(v.TripTime(origin, destination)) <= v.Energy();
+        });
+
+        if(nearest < 0)
+        {
+            _unmatched.push_back(request);
+            continue;
+        }
+
+        Vehicle* vehicle = _vehicles[nearest].get();
+        _available.Remove(uint32_t(nearest));
+
+        // Passenger waits for the dispatch and for the vehicle to fly to the origin
+        float pickup_mins = vehicle->Location().Distance(origin) / vehicle->CruiseSpeed() * 60;
+        WaitLaps.Record(clock_ms - request.requested_ms + int64_t(pickup_mins * 1000));
+
+        vehicle->Assign(origin, destination);
+        ++assigned;
+    }
+
+    _assigned += assigned;
+    _backlog.swap(_unmatched);
+    return assigned;
+}
+
+/**
+ * @brief Prints dispatcher statistics to console.
+ *
+ */
+void Dispatcher::PrintStats()
+{
+    std::stringstream ss;
+    ss << std::setprecision(2) << std::fixed;
+    ss << _requests << " requests, " << _assigned << " assigned, " << _lost << " lost, " << _backlog.size() << " waiting"
+       << " | Wait (mins) mean " << WaitLaps.Mean() / 1000.0
+       << ", p50 " << WaitLaps.Percentile(50.0) / 1000.0
+       << ", p99 " << WaitLaps.Percentile(99.0) / 1000.0;
+    PrintToConsole(ss);
+}
+
+/**
+ * @brief Dispatches once each simulated minute until stopped.
+ *
+ */
+void Dispatcher::Run()
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for(int64_t n = 1; ; ++n)
+    {
+        auto next = start + std::chrono::seconds(n);
+        if(WaitFor(next - std::chrono::steady_clock::now()))
+            break;
+
+        Dispatch(_clock_offset_ms + std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+}
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include "EngineValidation.h"
+
+using namespace std::chrono;
+
+/**
+ * @brief Construct a new EngineValidation object.
+ *
+ * @param num_vehicles Number of vehicles of the scenario.
+ * @param num_vehicle_types Number of vehicle types.
+ * @param num_chargers Number of chargers of the scenario.
+ * @param num_sites Number of sites (vertiports) the chargers are spread over.
+ */
+EngineValidation::EngineValidation(const unsigned short num_vehicles,
+                                   const unsigned short num_vehicle_types,
+                                   const unsigned short num_chargers,
+                                   const unsigned short num_sites) : _num_vehicles(num_vehicles),
+                                                                     _num_vehicle_types(num_vehicle_types),
+                                                                     _num_chargers(num_chargers),
+                                                                     _num_sites(num_sites),
+                                                                     _tolerance_pct(ENGINE_VALIDATION_TOLERANCE_PCT),
+                                                                     _sim_time_secs(0),
+                                                                     _results()
+{ }
+
+/**
+ * @brief Runs the scenario on every engine, the threaded engine first.
+ *
+ * @param sim_time_secs Duration (seconds) to run each engine.
+ * @param seed Seed of the scenario, the same fleet on every engine.
+ * @param tolerance_pct Largest difference of a metric accepted (percentage points).
+ * @return true  Every engine agrees with the threaded engine.
+ * @return false An engine differs by more than tolerance_pct.
+ */
+bool EngineValidation::Run(const int64_t  sim_time_secs,
+                           const uint32_t seed,
+                           const double   tolerance_pct)
+{
+    _tolerance_pct = tolerance_pct;
+    _sim_time_secs = sim_time_secs;
+    _results.clear();
+
+    for(auto engine : { SimulationEngine::THREADED, SimulationEngine::SERIAL, SimulationEngine::PARALLEL })
+        _results.push_back(RunEngine(engine, sim_time_secs, seed));
+
+    const EngineResult& reference = _results.front();
+    for(auto& result : _results)
+    {
+        result.speedup       = reference.wall_secs / std::max(result.wall_secs, 1e-9);
+        result.max_error_pct = MaxError(reference.metrics, result.metrics);
+    }
+
+    return Passed();
+}
+
+/**
+ * @brief Runs the scenario on one engine.
+ *
+ * @param engine Engine.
+ * @param sim_time_secs Duration (seconds) to run.
+ * @param seed Seed of the scenario.
+ * @return EngineResult Results, not yet compared.
+ */
+EngineResult EngineValidation::RunEngine(const SimulationEngine engine, const int64_t sim_time_secs, const uint32_t seed) const
+{
+    Simulation sim(_num_vehicles, _num_vehicle_types, _num_chargers, _num_sites);
+    sim.SelectEngine(engine);
+    sim.EnableQuiet();
+    sim.Seed(seed);
+    sim.Create();
+
+    const steady_clock::time_point start = steady_clock::now();
+    sim.Simulate(sim_time_secs);
+    const double wall_secs = duration_cast<duration<double>>(steady_clock::now() - start).count();
+
+    return { engine, wall_secs, 1.0, 0.0, sim.MetricsForEachVehicleType(sim_time_secs) };
+}
+
+/**
+ * @brief Largest difference of the flight, charge and queueing time of
+ *        a vehicle type between two runs.  A type missing from either
+ *        run, or with a different number of vehicles, differs by 100.
+ *
+ * @param reference Results of the threaded engine.
+ * @param metrics Results of the engine compared.
+ * @return double Largest difference (percentage points).
+ */
+double EngineValidation::MaxError(const std::vector<VehicleTypeMetrics>& reference,
+                                  const std::vector<VehicleTypeMetrics>& metrics)
+{
+    if(reference.size() != metrics.size())
+        return 100.0;
+
+    double max_error = 0.0;
+    for(auto const& r : reference)
+    {
+        auto m = std::find_if(metrics.begin(), metrics.end(), [&r](const VehicleTypeMetrics& m) { return m.name == r.name; });
+        if(m == metrics.end() || m->num_vehicles != r.num_vehicles)
+            return 100.0;
+
+        max_error = std::max({ max_error,
+                               std::abs(m->cruise_pct - r.cruise_pct),
+                               std::abs(m->charge_pct - r.charge_pct),
+                               std::abs(m->qing_pct   - r.qing_pct) });
+    }
+
+    return max_error;
+}
+
+/**
+ * @brief Checks to see if every engine of the last Run() agreed with
+ *        the threaded engine.
+ *
+ * @return true  Every engine agreed.
+ * @return false An engine differed by more than the tolerance.
+ */
+bool EngineValidation::Passed() const
+{
+    return !_results.empty() && std::all_of(_results.begin(), _results.end(), [this](const EngineResult& r) { return r.max_error_pct <= _tolerance_pct; });
+}
+
+/**
+ * @brief Name of an engine.
+ *
+ * @param engine Engine.
+ * @return std::string Name ("threaded", "serial" or "parallel").
+ */
+std::string EngineValidation::Name(const SimulationEngine engine)
+{
+    switch(engine)
+    {
+        case SimulationEngine::THREADED: return "threaded";
+        case SimulationEngine::SERIAL:   return "serial";
+        case SimulationEngine::PARALLEL: return "parallel";
+    }
+    return "";
+}
+
+/**
+ * @brief Prints the metrics of each vehicle type on each engine, and
+ *        the realtime, speedup and largest difference of each engine.
+ *
+ */
+void EngineValidation::PrintResults() const
+{
+    std::cout << "\n\nEngine Validation: " << _sim_time_secs << " mins" << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|    Engine  |  Vehicle  |  Num Vehicles  |  Flight Time (%)  |  Charge Time (%)  |  Qing Time (%)  |" << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------------------" << std::endl;
+
+    std::cout << std::setprecision(2) << std::fixed;
+    for(auto const& result : _results)
+    {
+        for(auto const& m : result.metrics)
+        {
+            std::cout << "|"   << std::right << std::setw(10) << std::setfill(' ') << Name(result.engine);
+            std::cout << "  |" << std::setw(9)  << m.name;
+            std::cout << "  |" << std::setw(14) << m.num_vehicles;
+            std::cout << "  |" << std::setw(17) << m.cruise_pct;
+            std::cout << "  |" << std::setw(17) << m.charge_pct;
+            std::cout << "  |" << std::setw(15) << m.qing_pct;
+            std::cout << "  |" << std::endl;
+        }
+    }
+    std::cout << "-----------------------------------------------------------------------------------------------------" << std::endl;
+
+    std::cout << "\n\nEngines (tolerance " << std::setprecision(2) << _tolerance_pct << " %)" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|    Engine  |  Realtime (s)  |     Speedup  |  Max Difference (%)  |  Result  |" << std::endl;
+    std::cout << "--------------------------------------------------------------------------------" << std::endl;
+
+    for(auto const& result : _results)
+    {
+        std::cout << "|"   << std::right << std::setw(10) << std::setfill(' ') << Name(result.engine);
+        std::cout << "  |" << std::setw(14) << std::setprecision(6) << result.wall_secs;
+        std::cout << "  |" << std::setw(12) << std::setprecision(1) << result.speedup;
+        std::cout << "  |" << std::setw(20) << std::setprecision(2) << result.max_error_pct;
+        std::cout << "  |" << std::setw(8)  << (result.max_error_pct <= _tolerance_pct ? "pass" : "FAIL");
+        std::cout << "  |" << std::endl;
+    }
+    std::cout << "--------------------------------------------------------------------------------" << std::endl;
+}
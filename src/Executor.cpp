@@ -0,0 +1,94 @@
+#include <algorithm>
+
+#include "Executor.h"
+#include "TimingWheel.h"
+
+/**
+ * @brief Construct a new Executor object.
+ *
+ * @param scheduler Scheduler of the wake up events (a TimingWheel when null).
+ */
+Executor::Executor(std::unique_ptr<EventScheduler> scheduler) : _scheduler(std::move(scheduler)),
+                                                                 _now(0),
+                                                                 _processes(),
+                                                                 _waking(),
+                                                                 _free()
+{
+    if(!_scheduler)
+        _scheduler = std::make_unique<TimingWheel>();
+}
+
+/**
+ * @brief Destroy the Executor object and the frames of its processes.
+ *
+ */
+Executor::~Executor()
+{
+    for(auto handle : _processes)
+        handle.destroy();
+}
+
+/**
+ * @brief Takes a process and starts it at the current time.
+ *
+ * @param process Process to run.
+ */
+void Executor::Spawn(Process process)
+{
+    std::coroutine_handle<> handle = process.Release();
+    _processes.push_back(handle);
+    Wake(handle);
+}
+
+/**
+ * @brief Resumes a suspended process at a time.
+ *
+ * @param handle Process to resume.
+ * @param time_ms Simulation time (ms) to resume it at, now when earlier.
+ */
+void Executor::Wake(std::coroutine_handle<> handle, const int64_t time_ms)
+{
+    uint32_t target;
+    if(_free.empty())
+    {
+        target = uint32_t(_waking.size());
+        _waking.push_back(handle);
+    }
+    else
+    {
+        target = _free.back();
+        _free.pop_back();
+        _waking[target] = handle;
+    }
+
+    _scheduler->Schedule({ std::max(time_ms, _now), target, 0 });
+}
+
+/**
+ * @brief Resumes every process due by a time, in time order, and moves
+ *        the clock to that time.
+ *
+ * @param until_ms Simulation time (ms) to run to.
+ * @return size_t Number of times a process was resumed.
+ */
+size_t Executor::Run(const int64_t until_ms)
+{
+    size_t resumed = 0;
+
+    ScheduledEvent event;
+    while(_scheduler->PopDue(event, until_ms))
+    {
+        _now = event.time_ms;
+        _free.push_back(event.target);
+
+        // Processes that end stay suspended at their final point until the
+        // executor is destroyed
+        std::coroutine_handle<> handle = _waking[event.target];
+        if(!handle.done())
+            handle.resume();
+        ++resumed;
+    }
+
+    _now = std::max(_now, until_ms);
+    return resumed;
+}
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include "FleetSampler.h"
+
+/**
+ * @brief Construct a new FleetSampler object.
+ *
+ * @param interval_secs Duration (seconds) between samples.
+ * @param vehicles Vehicles to sample.
+ * @param chargers Chargers to sample.
+ * @param topology Sites holding the charging queues.
+ * @param context State shared by all objects of the simulation.
+ */
+FleetSampler::FleetSampler(const int64_t                                interval_secs,
+                           const std::vector<std::shared_ptr<Vehicle>>& vehicles,
+                           const std::vector<std::shared_ptr<Charger>>& chargers,
+                           const Topology&                              topology,
+                           SimulationContext&                           context) : SimulationObject(context),
+                                                                                   _interval_secs(std::max<int64_t>(interval_secs, 1)),
+                                                                                   _vehicles(vehicles),
+                                                                                   _chargers(chargers),
+                                                                                   _topology(topology),
+                                                                                   _clock_offset_ms(0),
+                                                                                   _dropped(0)
+{ }
+
+/**
+ * @brief String used to uniquely identify this object.
+ *
+ * @return const std::string Header used to uniquely identify sampler.
+ */
+const std::string FleetSampler::Header()
+{
+    return "<Sampler> ";
+}
+
+/**
+ * @brief Clears previous samples and preallocates the columns for a run.
+ *        Must be called before the sampler is started.
+ *
+ * @param sim_time_secs Duration (seconds) of the run.
+ * @param clock_offset_ms Simulation time (ms) elapsed before the run.
+ */
+void FleetSampler::Prepare(const int64_t sim_time_secs, const int64_t clock_offset_ms)
+{
+    // One sample at the start and one per interval
+    size_t capacity = sim_time_secs / _interval_secs + 1;
+
+    _clock_offset_ms = clock_offset_ms;
+    _dropped = 0;
+
+    _time_ms.clear();
+    _time_ms.reserve(capacity);
+    _queue_length.clear();
+    _queue_length.reserve(capacity);
+    _busy_chargers.clear();
+    _busy_chargers.reserve(capacity);
+    for(auto& column : _vehicles_in_state)
+    {
+        column.clear();
+        column.reserve(capacity);
+    }
+}
+
+/**
+ * @brief Takes one sample.
+ *
+ * @param clock_ms Simulation time (ms) of the sample.
+ */
+void FleetSampler::Sample(const int64_t clock_ms)
+{
+    // Columns are never reallocated while running
+    if(_time_ms.size() == _time_ms.capacity())
+    {
+        ++_dropped;
+        return;
+    }
+
+    std::array<uint32_t, FLEET_SAMPLER_STATES> in_state {};
+    for(auto const& v : _vehicles)
+        ++in_state[v->State()];
+
+    uint32_t busy = 0;
+    for(auto const& c : _chargers)
+        busy += c->Busy();
+
+    _time_ms.push_back(clock_ms);
+    _queue_length.push_back(_topology.QueueLength());
+    _busy_chargers.push_back(busy);
+    for(size_t i = 0; i < FLEET_SAMPLER_STATES; ++i)
+        _vehicles_in_state[i].push_back(in_state[i]);
+}
+
+/**
+ * @brief Writes the samples as a CSV time series.
+ *
+ * @param path Output file.
+ * @throws std::runtime_error File could not be written.
+ */
+void FleetSampler::WriteCsv(const std::string& path) const
+{
+    std::ofstream out(path);
+    if(!out)
+        throw std::runtime_error("Unable to write time series " + path);
+
+    out << "time_mins,queue_length,busy_chargers,initial,cruising,needs_charged,charging,charged,idle\n";
+    for(size_t i = 0; i < _time_ms.size(); ++i)
+    {
+        out << _time_ms[i] / 1000.0 << ',' << _queue_length[i] << ',' << _busy_chargers[i];
+        for(auto const& column : _vehicles_in_state)
+            out << ',' << column[i];
+        out << '\n';
+    }
+}
+
+/**
+ * @brief Prints sampler statistics to console.
+ *
+ */
+void FleetSampler::PrintStats()
+{
+    std::stringstream ss;
+    ss << _time_ms.size() << " samples every " << _interval_secs << " mins";
+    if(_dropped)
+        ss << " (" << _dropped << " dropped)";
+    PrintToConsole(ss);
+}
+
+/**
+ * @brief Samples the fleet every interval until stopped.
+ *
+ */
+void FleetSampler::Run()
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    auto clock = [&]() {
+        return _clock_offset_ms + std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    Sample(clock());
+
+    // Sample at fixed points in time so the interval does not drift
+    for(int64_t n = 1; ; ++n)
+    {
+        auto next = start + std::chrono::seconds(n * _interval_secs);
+        if(WaitFor(next - std::chrono::steady_clock::now()))
+            break;
+
+        Sample(clock());
+    }
+}
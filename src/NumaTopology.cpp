@@ -0,0 +1,103 @@
+#include <sched.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "NumaTopology.h"
+
+/**
+ * @brief Construct a new NumaTopology object.
+ *
+ * @param sysfs_root Directory holding the node0, node1, ... entries.
+ */
+NumaTopology::NumaTopology(const std::string& sysfs_root) : _cpus()
+{
+    // Nodes by number, memory only nodes (no CPUs) are skipped
+    std::map<int, std::vector<int>> nodes;
+
+    std::error_code ec;
+    for(auto const& entry : std::filesystem::directory_iterator(sysfs_root, ec))
+    {
+        const std::string name = entry.path().filename().string();
+        if(name.rfind("node", 0) != 0 || name.size() == 4 || !std::all_of(name.begin() + 4, name.end(), ::isdigit))
+            continue;
+
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        std::getline(file, list);
+
+        std::vector<int> cpus = ParseCpuList(list);
+        if(!cpus.empty())
+            nodes[std::stoi(name.substr(4))] = cpus;
+    }
+
+    for(auto& [id, cpus] : nodes)
+        _cpus.push_back(std::move(cpus));
+
+    // No NUMA information, every CPU is on one node
+    if(_cpus.empty())
+    {
+        std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+        for(size_t i = 0; i < cpus.size(); ++i)
+            cpus[i] = int(i);
+        _cpus.push_back(cpus);
+    }
+}
+
+/**
+ * @brief Restricts a thread to a set of CPUs.  Fails quietly (e.g. when
+ *        the process is confined to other CPUs) and the thread keeps
+ *        running wherever the kernel puts it.
+ *
+ * @param thread Thread to pin.
+ * @param cpus CPUs the thread may run on.
+ * @return true  Thread was pinned.
+ * @return false Thread was not pinned.
+ */
+bool NumaTopology::Pin(const pthread_t thread, const std::vector<int>& cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(int cpu : cpus)
+    {
+        if(cpu >= 0 && cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+    }
+
+    if(CPU_COUNT(&set) == 0)
+        return false;
+
+    return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+}
+
+/**
+ * @brief Parses a sysfs CPU list, e.g. "0-3,8-11".
+ *
+ * @param list CPU list.
+ * @return std::vector<int> CPUs in the list.
+ */
+std::vector<int> NumaTopology::ParseCpuList(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+
+    while(std::getline(ss, range, ','))
+    {
+        int first = 0, last = 0;
+        char dash = 0;
+        std::istringstream rs(range);
+        if(!(rs >> first))
+            continue;
+        if(!(rs >> dash >> last) || dash != '-')
+            last = first;
+
+        for(int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
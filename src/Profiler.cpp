@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+#include "Profiler.h"
+
+/**
+ * @brief Writes a string as a JSON string.
+ *
+ * @param out Stream written to.
+ * @param s String.
+ */
+static void WriteJsonString(std::ostream& out, const std::string& s)
+{
+    out << '"';
+    for(char c : s)
+    {
+        if(c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+/**
+ * @brief Profiler of the process.
+ *
+ * @return Profiler& Profiler.
+ */
+Profiler& Profiler::Instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+/**
+ * @brief Construct a new Profiler object.
+ *
+ */
+Profiler::Profiler() : _epoch(std::chrono::steady_clock::now()),
+                       _buffers(),
+                       _taken(0),
+                       _buffers_lock()
+{ }
+
+/**
+ * @brief Buffer of the calling thread, created the first time it records.
+ *
+ * @return ThreadBuffer& Buffer.
+ */
+Profiler::ThreadBuffer& Profiler::Local()
+{
+    thread_local ThreadBuffer* buffer = nullptr;
+    if(buffer)
+        return *buffer;
+
+    std::lock_guard<std::mutex> lock(_buffers_lock);
+    const uint32_t tid = uint32_t(_buffers.size());
+    _buffers.push_back(std::make_unique<ThreadBuffer>(ThreadBuffer{ tid, "Thread " + std::to_string(tid), {}, {}, 0, 0 }));
+    buffer = _buffers.back().get();
+    return *buffer;
+}
+
+/**
+ * @brief Records a timed scope of the calling thread.
+ *
+ * @param name Name of the scope (string literal).
+ * @param category Category of the scope (string literal).
+ * @param start_ns Start (ns), from Now().
+ * @param end_ns End (ns), from Now().
+ * @param cycles CPU cycles spent.
+ */
+void Profiler::Record(const char* name, const char* category, const int64_t start_ns, const int64_t end_ns, const uint64_t cycles)
+{
+    ThreadBuffer& buffer = Local();
+    const int64_t dur_ns = end_ns - start_ns;
+
+    auto totals = std::find_if(buffer.totals.begin(), buffer.totals.end(), [name](const ProfileTotals& t) { return t.name == name; });
+    if(totals == buffer.totals.end())
+        totals = buffer.totals.insert(buffer.totals.end(), ProfileTotals{ name, category, 0, 0, 0, 0 });
+
+    ++totals->count;
+    totals->total_ns += dur_ns;
+    totals->max_ns    = std::max(totals->max_ns, dur_ns);
+    totals->cycles   += cycles;
+
+    // Takes more of the budget once the thread's share is spent
+    if(buffer.reserved == 0 && _taken.load(std::memory_order_relaxed) < PROFILER_MAX_EVENTS)
+    {
+        const size_t taken = _taken.fetch_add(PROFILER_EVENTS_PER_RESERVE, std::memory_order_relaxed);
+        if(taken < PROFILER_MAX_EVENTS)
+            buffer.reserved = std::min(PROFILER_EVENTS_PER_RESERVE, PROFILER_MAX_EVENTS - taken);
+    }
+
+    if(buffer.reserved > 0)
+    {
+        buffer.events.push_back({ name, category, start_ns, dur_ns, cycles });
+        --buffer.reserved;
+    }
+    else
+        ++buffer.dropped;
+}
+
+/**
+ * @brief Names the calling thread in the trace.
+ *
+ * @param name Name of the thread.
+ */
+void Profiler::NameThread(const std::string& name)
+{
+    Local().name = name;
+}
+
+/**
+ * @brief Writes the events of every thread as Chrome trace-event JSON.
+ *        Must be called once the profiled threads have been joined.
+ *
+ * @param path Path of the trace file.
+ * @throws std::runtime_error File could not be written.
+ */
+void Profiler::WriteTrace(const std::string& path) const
+{
+    std::ofstream out(path);
+    if(!out)
+        throw std::runtime_error("Unable to write trace " + path);
+
+    std::lock_guard<std::mutex> lock(_buffers_lock);
+
+    // Complete ("X") events, timestamps and durations in microseconds
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char* sep = "\n";
+    out << std::fixed << std::setprecision(3);
+    for(auto const& buffer : _buffers)
+    {
+        out << sep << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+        WriteJsonString(out, buffer->name);
+        out << "}}";
+        sep = ",\n";
+
+        for(auto const& e : buffer->events)
+        {
+            out << sep << "{\"name\":";
+            WriteJsonString(out, e.name);
+            out << ",\"cat\":";
+            WriteJsonString(out, e.category);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":"  << e.start_ns / 1000.0
+                << ",\"dur\":" << e.dur_ns   / 1000.0
+                << ",\"args\":{\"cycles\":" << e.cycles << "}}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+/**
+ * @brief Totals of each scope of each thread, by thread.
+ *
+ * @return std::vector<std::vector<ProfileTotals>> Totals of each thread.
+ */
+std::vector<std::vector<ProfileTotals>> Profiler::Totals() const
+{
+    std::lock_guard<std::mutex> lock(_buffers_lock);
+
+    std::vector<std::vector<ProfileTotals>> totals;
+    for(auto const& buffer : _buffers)
+        totals.push_back(buffer->totals);
+    return totals;
+}
+
+/**
+ * @brief Number of events kept for the trace.
+ *
+ * @return size_t Number of events.
+ */
+size_t Profiler::Events() const
+{
+    std::lock_guard<std::mutex> lock(_buffers_lock);
+
+    size_t events = 0;
+    for(auto const& buffer : _buffers)
+        events += buffer->events.size();
+    return events;
+}
+
+/**
+ * @brief Number of events not kept for the trace, the budget was spent.
+ *
+ * @return uint64_t Number of events.
+ */
+uint64_t Profiler::Dropped() const
+{
+    std::lock_guard<std::mutex> lock(_buffers_lock);
+
+    uint64_t dropped = 0;
+    for(auto const& buffer : _buffers)
+        dropped += buffer->dropped;
+    return dropped;
+}
+
+/**
+ * @brief Clears the events and totals of every thread.  Must not be
+ *        called while profiled threads run.
+ *
+ */
+void Profiler::Reset()
+{
+    std::lock_guard<std::mutex> lock(_buffers_lock);
+
+    for(auto const& buffer : _buffers)
+    {
+        buffer->events.clear();
+        buffer->totals.clear();
+        buffer->dropped  = 0;
+        buffer->reserved = 0;
+    }
+    _taken.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Prints the totals of each scope, summed over the threads, with
+ *        the busiest thread's share.  Must be called once the profiled
+ *        threads have been joined.
+ *
+ */
+void Profiler::PrintStats() const
+{
+    struct Sum { const char* category; size_t threads; uint64_t count; int64_t total_ns; int64_t max_ns; int64_t thread_max_ns; uint64_t cycles; };
+    std::map<std::string, Sum> sums;
+    const uint64_t dropped = Dropped();
+
+    for(auto const& thread : Totals())
+    {
+        for(auto const& t : thread)
+        {
+            Sum& sum = sums.try_emplace(t.name, Sum{ t.category, 0, 0, 0, 0, 0, 0 }).first->second;
+            ++sum.threads;
+            sum.count        += t.count;
+            sum.total_ns     += t.total_ns;
+            sum.max_ns        = std::max(sum.max_ns, t.max_ns);
+            sum.thread_max_ns = std::max(sum.thread_max_ns, t.total_ns);
+            sum.cycles       += t.cycles;
+        }
+    }
+    std::cout << "\n\nProfile" << (dropped ? " (" + std::to_string(dropped) + " events not traced)" : "") << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|                 Scope  |   Cat  |  Threads  |      Count  |  Total (ms)  |  Thread Max (ms)  |  Max (ms)  |      Mcycles  |" << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------------------------------------------" << std::endl;
+
+    std::cout << std::setprecision(2) << std::fixed;
+    for(auto const& [name, sum] : sums)
+    {
+        std::cout << "|"   << std::right << std::setw(22) << std::setfill(' ') << name;
+        std::cout << "  |" << std::setw(6)  << sum.category;
+        std::cout << "  |" << std::setw(9)  << sum.threads;
+        std::cout << "  |" << std::setw(11) << sum.count;
+        std::cout << "  |" << std::setw(12) << sum.total_ns      / 1e6;
+        std::cout << "  |" << std::setw(17) << sum.thread_max_ns / 1e6;
+        std::cout << "  |" << std::setw(10) << sum.max_ns        / 1e6;
+        std::cout << "  |" << std::setw(13) << sum.cycles        / 1e6;
+        std::cout << "  |" << std::endl;
+    }
+    std::cout << "-----------------------------------------------------------------------------------------------------------------------------" << std::endl;
+}
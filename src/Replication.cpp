@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Replication.h"
+#include "Simulation.h"
+
+/**
+ * @brief Construct a new Replication object.
+ *
+ * @param num_vehicles Number of vehicles of each replica.
+ * @param num_vehicle_types Number of vehicle types.
+ * @param num_chargers Number of chargers of each replica.
+ * @param num_sites Number of sites (vertiports) the chargers are spread over.
+ * @param trips_per_min Trip requests per minute (0 flies full battery flights).
+ */
+Replication::Replication(const unsigned short num_vehicles,
+                         const unsigned short num_vehicle_types,
+                         const unsigned short num_chargers,
+                         const unsigned short num_sites,
+                         const double         trips_per_min) : _num_vehicles(num_vehicles),
+                                                               _num_vehicle_types(num_vehicle_types),
+                                                               _num_chargers(num_chargers),
+                                                               _num_sites(num_sites),
+                                                               _trips_per_min(trips_per_min),
+                                                               _mutex(),
+                                                               _replicas(0),
+                                                               _metrics()
+{ }
+
+/**
+ * @brief Runs replicas until the confidence interval of every metric is
+ *        within rel_width of its mean, or max_replicas have run.
+ *        Replica k is seeded from (seed, k), so a replication can be
+ *        repeated.
+ *
+ * @param sim_time_secs Duration (seconds) to run each replica.
+ * @param max_replicas Largest number of replicas to run.
+ * @param rel_width Target half width of the intervals relative to the mean.
+ * @param parallel Number of replicas run at once.
+ * @param seed Seed of the replication.
+ * @return size_t Number of replicas run.
+ */
+size_t Replication::Run(const int64_t  sim_time_secs,
+                        const size_t   max_replicas,
+                        const double   rel_width,
+                        const size_t   parallel,
+                        const uint32_t seed)
+{
+    std::atomic<size_t> next(0);
+    std::atomic<bool>   done(false);
+
+    // Each worker takes the next replica until the intervals are narrow
+    // enough; replicas already running when that happens still count
+    auto worker = [&]() {
+        while(!done)
+        {
+            const size_t k = next++;
+            if(k >= max_replicas)
+                break;
+
+            std::seed_seq seq { seed, uint32_t(k) };
+            uint32_t replica_seed;
+            seq.generate(&replica_seed, &replica_seed + 1);
+
+            RunReplica(sim_time_secs, replica_seed);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if(_replicas >= REPLICATION_MIN_REPLICAS && Converged(rel_width))
+                done = true;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(size_t i = 0; i < std::max<size_t>(parallel, 1); ++i)
+        workers.emplace_back(worker);
+    for(auto& w : workers)
+        w.join();
+
+    return _replicas;
+}
+
+/**
+ * @brief Runs one replica and adds its results.
+ *
+ * @param sim_time_secs Duration (seconds) to run the replica.
+ * @param seed Seed of the replica.
+ */
+void Replication::RunReplica(const int64_t sim_time_secs, const uint32_t seed)
+{
+    Simulation sim(_num_vehicles, _num_vehicle_types, _num_chargers, _num_sites);
+    sim.Seed(seed);
+    sim.Create();
+
+    // Only the aggregates of a replica are reported
+    sim.EnableQuiet();
+
+    if(_trips_per_min > 0.0)
+        sim.EnableTrips(_trips_per_min, 30);
+
+    sim.Simulate(sim_time_secs);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(auto const& m : sim.MetricsForEachVehicleType(sim_time_secs))
+    {
+        ReplicatedMetrics& r = _metrics[m.name];
+        r.cruise_pct.Add(m.cruise_pct);
+        r.charge_pct.Add(m.charge_pct);
+        r.qing_pct.Add(m.qing_pct);
+        r.qing_mins.Add(m.qing_mins);
+    }
+    ++_replicas;
+}
+
+/**
+ * @brief Checks to see if every interval is within rel_width of its mean.
+ *
+ * @param rel_width Target half width of the intervals relative to the mean.
+ * @return true  Every interval is narrow enough.
+ * @return false More replicas are needed.
+ */
+bool Replication::Converged(const double rel_width) const
+{
+    if(_metrics.empty())
+        return false;
+
+    // A metric that is the same in every replica (e.g. no queueing) has a
+    // zero width interval and is converged
+    auto narrow = [&](const RunningStat& s) { return s.HalfWidth() <= rel_width * std::abs(s.Mean()); };
+
+    for(auto const& [name, m] : _metrics)
+    {
+        if(!narrow(m.cruise_pct) || !narrow(m.charge_pct) || !narrow(m.qing_pct) || !narrow(m.qing_mins))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Prints the mean and 95% confidence interval of each metric of
+ *        each vehicle type to console.
+ *
+ */
+void Replication::PrintStats() const
+{
+    std::cout << "\n\nReplicas: " << _replicas << " (mean +/- 95% confidence interval)" << std::endl;
+    std::cout << "------------------------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|  Vehicle  |  Replicas  |  Flight Time (%)  |  Charge Time (%)  |   Qing Time (%)   | Avg Qing Time (mins) |" << std::endl;
+    std::cout << "------------------------------------------------------------------------------------------------------------" << std::endl;
+
+    auto interval = [](const RunningStat& s) {
+        std::stringstream ss;
+        ss << std::setprecision(2) << std::fixed << s.Mean() << " +/- ";
+        if(std::isinf(s.HalfWidth()))
+            ss << "-";
+        else
+            ss << s.HalfWidth();
+        return ss.str();
+    };
+
+    for(auto const& [name, m] : _metrics)
+    {
+        std::cout << "|"   << std::right << std::setw(9) << std::setfill(' ') << name;
+        std::cout << "  |" << std::setw(10) << m.cruise_pct.Count();
+        std::cout << "  |" << std::setw(17) << interval(m.cruise_pct);
+        std::cout << "  |" << std::setw(17) << interval(m.charge_pct);
+        std::cout << "  |" << std::setw(17) << interval(m.qing_pct);
+        std::cout << "  |" << std::setw(20) << interval(m.qing_mins);
+        std::cout << " |" << std::endl;
+        std::cout << "------------------------------------------------------------------------------------------------------------" << std::endl;
+    }
+}
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ResultsPublisher.h"
+
+/**
+ * @brief Copies results a word at a time with relaxed atomic stores, so a
+ *        concurrent reader's copy is racy only in value, never undefined.
+ *
+ * @param dst Results in the segment.
+ * @param src Results copied.
+ */
+static void StoreResults(SharedResults& dst, const SharedResults& src)
+{
+    uint64_t*       d = reinterpret_cast<uint64_t*>(&dst);
+    const uint64_t* s = reinterpret_cast<const uint64_t*>(&src);
+    for(size_t i = 0; i < sizeof(SharedResults) / sizeof(uint64_t); ++i)
+        __atomic_store_n(d + i, s[i], __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Copies results a word at a time with relaxed atomic loads.
+ *
+ * @param dst Copy of the results.
+ * @param src Results in the segment.
+ */
+static void LoadResults(SharedResults& dst, const SharedResults& src)
+{
+    uint64_t*       d = reinterpret_cast<uint64_t*>(&dst);
+    const uint64_t* s = reinterpret_cast<const uint64_t*>(&src);
+    for(size_t i = 0; i < sizeof(SharedResults) / sizeof(uint64_t); ++i)
+        d[i] = __atomic_load_n(s + i, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Construct a new ResultsPublisher object and creates its segment.
+ *        A segment of the same name is never taken over, readers of
+ *        another run would see its results change under them.
+ *
+ * @param name Name of the shared memory segment, e.g. "/evtol_results".
+ * @param interval_ms Duration (ms of realtime) between publications.
+ * @param context State shared by all objects of the simulation.
+ * @throws std::runtime_error Segment already exists or could not be created.
+ */
+ResultsPublisher::ResultsPublisher(const std::string& name,
+                                   const int64_t      interval_ms,
+                                   SimulationContext& context) : SimulationObject(context),
+                                                                 _name(name),
+                                                                 _interval_ms(std::max<int64_t>(interval_ms, 1)),
+                                                                 _segment(nullptr),
+                                                                 _types(),
+                                                                 _results(),
+                                                                 _clock_offset_ms(0)
+{
+    int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(fd < 0 && errno == EEXIST)
+        throw std::runtime_error("Results segment " + _name + " already exists, another run is publishing to it or it was left by one that crashed (remove /dev/shm" + _name + ")");
+    if(fd < 0)
+        throw std::runtime_error("Unable to create results segment " + _name);
+
+    if(ftruncate(fd, sizeof(SharedResultsSegment)) != 0)
+    {
+        close(fd);
+        shm_unlink(_name.c_str());
+        throw std::runtime_error("Unable to resize results segment " + _name);
+    }
+
+    void* data = mmap(nullptr, sizeof(SharedResultsSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED)
+    {
+        shm_unlink(_name.c_str());
+        throw std::runtime_error("Unable to map results segment " + _name);
+    }
+
+    // No results yet (sequence 0), the header is written last so readers
+    // never take a segment being set up for a results segment
+    _segment = static_cast<SharedResultsSegment*>(data);
+    _segment->sequence.store(0, std::memory_order_relaxed);
+    StoreResults(_segment->results, _results);
+    _segment->version = SHARED_RESULTS_VERSION;
+    _segment->size    = sizeof(SharedResultsSegment);
+    std::atomic_thread_fence(std::memory_order_release);
+    __atomic_store_n(&_segment->magic, SHARED_RESULTS_MAGIC, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Unmaps and unlinks the segment.
+ *
+ */
+ResultsPublisher::~ResultsPublisher()
+{
+    munmap(_segment, sizeof(SharedResultsSegment));
+    shm_unlink(_name.c_str());
+}
+
+/**
+ * @brief String used to uniquely identify this object.
+ *
+ * @return const std::string Header used to uniquely identify publisher.
+ */
+const std::string ResultsPublisher::Header()
+{
+    return "<Publisher> ";
+}
+
+/**
+ * @brief Takes the vehicle types of the run.  Must be called after the
+ *        vehicles are created, before the publisher is started.
+ *
+ * @param clock_offset_ms Simulation time (ms) elapsed before the run.
+ */
+void ResultsPublisher::Prepare(const int64_t clock_offset_ms)
+{
+    _clock_offset_ms = clock_offset_ms;
+    _types           = _context.Stats.Types();
+
+    // Parameters of the types do not change during the run
+    _results.num_types = uint32_t(_types.size());
+    for(size_t t = 0; t < _types.size(); ++t)
+    {
+        auto const& info = _types[t].second;
+        SharedTypeResults& r = _results.types[t];
+
+        std::memset(r.name, 0, sizeof(r.name));
+        std::strncpy(r.name, info.name.c_str(), sizeof(r.name) - 1);
+        r.num_vehicles            = info.num_vehicles;
+        r.passenger_miles_per_min = info.passenger_miles_per_min;
+        r.faults_per_min          = info.faults_per_min;
+    }
+}
+
+/**
+ * @brief Publishes the totals so far.  Only called by one thread at a
+ *        time, the publisher's own while it runs.
+ *
+ * @param clock_ms Simulation time (ms) of the totals.
+ * @param done These are the final results of the run.
+ */
+void ResultsPublisher::Publish(const int64_t clock_ms, const bool done)
+{
+    // Totals are read before the sequence is taken, so readers are locked
+    // out only for the copy
+    for(size_t t = 0; t < _types.size(); ++t)
+    {
+        for(size_t kind = 0; kind < NUM_TYPE_STAT_KINDS; ++kind)
+            _results.types[t].totals[kind] = _context.Stats.Totals(_types[t].first, static_cast<TypeStatKind>(kind));
+    }
+    _results.clock_ms = clock_ms;
+    _results.done     = done ? 1 : 0;
+    ++_results.publications;
+
+    const uint64_t sequence = _segment->sequence.load(std::memory_order_relaxed);
+    _segment->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    StoreResults(_segment->results, _results);
+
+    _segment->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Prints publisher statistics to console.
+ *
+ */
+void ResultsPublisher::PrintStats()
+{
+    std::stringstream ss;
+    ss << _results.publications << " results published to " << _name << " every " << _interval_ms << " ms";
+    PrintToConsole(ss);
+}
+
+/**
+ * @brief Publishes the totals every interval until stopped.
+ *
+ */
+void ResultsPublisher::Run()
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    auto clock = [&]() {
+        return _clock_offset_ms + std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    Publish(clock(), false);
+
+    // Publish at fixed points in time so the interval does not drift
+    for(int64_t n = 1; ; ++n)
+    {
+        auto next = start + std::chrono::milliseconds(n * _interval_ms);
+        if(WaitFor(next - std::chrono::steady_clock::now()))
+            break;
+
+        Publish(clock(), false);
+    }
+}
+
+/**
+ * @brief Construct a new ResultsReader object and maps the segment
+ *        (read-only).
+ *
+ * @param name Name of the shared memory segment.
+ * @throws std::runtime_error Segment could not be mapped or is not a results segment.
+ */
+ResultsReader::ResultsReader(const std::string& name) : _segment(nullptr)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if(fd < 0)
+        throw std::runtime_error("Unable to open results segment " + name);
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || size_t(st.st_size) != sizeof(SharedResultsSegment))
+    {
+        close(fd);
+        throw std::runtime_error("Invalid results segment " + name);
+    }
+
+    void* data = mmap(nullptr, sizeof(SharedResultsSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED)
+        throw std::runtime_error("Unable to map results segment " + name);
+
+    _segment = static_cast<const SharedResultsSegment*>(data);
+    const bool valid = __atomic_load_n(&_segment->magic, __ATOMIC_RELAXED) == SHARED_RESULTS_MAGIC;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(!valid || _segment->version != SHARED_RESULTS_VERSION || _segment->size != sizeof(SharedResultsSegment))
+    {
+        munmap(const_cast<SharedResultsSegment*>(_segment), sizeof(SharedResultsSegment));
+        throw std::runtime_error("Invalid results segment " + name);
+    }
+}
+
+/**
+ * @brief Unmaps the segment.
+ *
+ */
+ResultsReader::~ResultsReader()
+{
+    munmap(const_cast<SharedResultsSegment*>(_segment), sizeof(SharedResultsSegment));
+}
+
+/**
+ * @brief Copies the latest results, once.
+ *
+ * @param results Copy of the results, consistent only when true is returned.
+ * @return true  Copy is consistent.
+ * @return false A publication overlapped the copy.
+ */
+bool ResultsReader::TryRead(SharedResults& results) const
+{
+    const uint64_t before = _segment->sequence.load(std::memory_order_acquire);
+    if(before & 1)
+        return false;
+
+    LoadResults(results, _segment->results);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return _segment->sequence.load(std::memory_order_relaxed) == before;
+}
+
+/**
+ * @brief Copies the latest results, retrying until the copy is consistent.
+ *
+ * @return SharedResults Copy of the results.
+ */
+SharedResults ResultsReader::Read() const
+{
+    SharedResults results;
+    while(!TryRead(results))
+        std::this_thread::yield();
+    return results;
+}
@@ -1,9 +1,15 @@
+#include <array>
 #include <iomanip>
+#include <limits>
 #include <map>
 #include <memory>
 #include <random>
+#include <sstream>
+#include <stdexcept>
 #include <vector>
 
+#include "CohortEngine.h"
+#include "CoroutineEngine.h"
 #include "Simulation.h"
 #include "Vehicle.h"
 
@@ -15,39 +21,541 @@ using namespace std::chrono;
  * @param num_vehicles Number of vehicles to run in simulation.
  * @param num_vehicle_types Number of vehicle types to run in simulation.
  * @param num_chargers Number of chargers to run in simulation.
+ * @param num_sites Number of sites (vertiports) the chargers are spread over.
  */
 Simulation::Simulation(const unsigned short num_vehicles,
                        const unsigned short num_vehicle_types,
-                       const unsigned short num_chargers) : _num_chargers     (num_chargers),
+                       const unsigned short num_chargers,
+                       const unsigned short num_sites) : _num_chargers     (num_chargers),
                                                             _num_vehicles     (num_vehicles),
                                                             _num_vehicle_types(num_vehicle_types),
+                                                            _context(),
+                                                            _seed(std::random_device()()),
+                                                            _gen(_seed),
+                                                            _clock_offset_ms(0),
+                                                            _run_start(),
+                                                            _snapshot_writer(),
+                                                            _image(),
+                                                            _checkpoint_interval_secs(0),
+                                                            _checkpoint_generation(0),
+                                                            _sampler(),
+                                                            _sampler_path(),
+                                                            _publisher(),
+                                                            _demand(),
+                                                            _dispatcher(),
                                                             _sim_objs(),
-                                                            _vehicle_charging_q()
+                                                            _vehicles(),
+                                                            _chargers(),
+                                                            _topology(num_sites),
+                                                            _numa(),
+                                                            _outages(false),
+                                                            _technicians(0),
+                                                            _mean_repair_mins(0.0),
+                                                            _engine(SimulationEngine::THREADED),
+                                                            _serial(),
+                                                            _parallel()
 {
-
+    _topology.AssignChargingSites(_num_chargers);
 }
 
+/**
+ * @brief Destroy the Simulation object.
+ * 
+ */
+Simulation::~Simulation() = default;
+
 /**
  * @brief Creates random vehicles and chargers simulation objects.  
  * 
  */
 size_t Simulation::Create()
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    // The other engines create a fleet of their own from the same seed
+    if(_engine == SimulationEngine::SERIAL)
+    {
+        _serial = std::make_unique<CoroutineEngine>(_num_vehicles, _num_vehicle_types, _num_chargers, uint16_t(_topology.Size()));
+        _serial->Seed(_seed);
+        if(_technicians > 0)
+            _serial->EnableMaintenance(_technicians, _mean_repair_mins, 1);
+        return _serial->Create();
+    }
+    if(_engine == SimulationEngine::PARALLEL)
+    {
+        _parallel = std::make_unique<CohortEngine>(_num_vehicles, _num_vehicle_types, _num_chargers, uint16_t(_topology.Size()));
+        _parallel->Seed(_seed);
+        return _parallel->Create();
+    }
+
     std::uniform_int_distribution<> distr(0, _num_vehicle_types-1);
 
-    // Create N random vehicles from M types
-    for(int i = 0; i < _num_vehicles; ++i)
-        _sim_objs.push_back(Vehicle::Create(static_cast<VehicleType>(distr(gen)), i, _vehicle_charging_q));
+    // Types of N random vehicles from M types, drawn up front so the fleet
+    // does not depend on the order the nodes are created in
+    std::vector<VehicleType> types(_num_vehicles);
+    for(auto& type : types)
+        type = static_cast<VehicleType>(distr(_gen));
+
+    _vehicles.resize(_num_vehicles);
+    _chargers.resize(_num_chargers);
+
+    // Vehicles and chargers whose home site is on a node, chargers spread over the sites
+    auto create = [&](uint16_t node) {
+        for(int i = 0; i < _num_vehicles; ++i)
+        {
+            if(_topology.SiteOfVehicle(i).Node() == node)
+                _vehicles[i] = Vehicle::Create(types[i], i, _topology.SiteOfVehicle(i), _context);
+        }
+        for(int i = 0; i < _num_chargers; ++i)
+        {
+            if(_topology.SiteOfCharger(i).Node() == node)
+                _chargers[i] = std::make_shared<Charger>(i, _topology.SiteOfCharger(i), _context);
+        }
+    };
+
+    // Each node's objects are allocated by a thread on that node (first touch)
+    if(_numa)
+    {
+        for(uint16_t node = 0; node < _numa->Nodes(); ++node)
+            _numa->RunOn(node, [&]() { create(node); });
+        PinToNodes();
+    }
+    else
+    {
+        create(0);
+    }
+
+    _sim_objs.insert(_sim_objs.end(), _vehicles.begin(), _vehicles.end());
+    _sim_objs.insert(_sim_objs.end(), _chargers.begin(), _chargers.end());
+
+    return _sim_objs.size();
+}
+
+/**
+ * @brief Pins each vehicle and charger thread to the NUMA node of its home
+ *        site, with the sites spread over the nodes.  Degrades to a single
+ *        node on hosts without NUMA.  Must be called before Create() for
+ *        objects to be allocated on their node.
+ * 
+ */
+void Simulation::EnableNuma()
+{
+    _numa = std::make_unique<NumaTopology>();
+
+    for(size_t s = 0; s < _topology.Size(); ++s)
+        _topology.At(s).SetNode(s % _numa->Nodes());
+
+    // Objects already created (or restored) are pinned but stay where they are
+    PinToNodes();
+}
+
+/**
+ * @brief Bounds the charging queue of every site.  A vehicle finding
+ *        its queue full waits, diverts or holds as policy says.  Holding
+ *        needs EnableTrips(), full battery flights land with no energy
+ *        to circle on.
+ * 
+ * @param capacity Maximum number of vehicles waiting at a site, 0 for no limit.
+ * @param policy What a vehicle does when the queue is full.
+ */
+void Simulation::BoundQueues(const size_t capacity, const QueueFullPolicy policy)
+{
+    for(size_t s = 0; s < _topology.Size(); ++s)
+        _topology.At(s).SetQueueCapacity(capacity, policy);
+}
+
+/**
+ * @brief Fails each charger at random, with exponentially distributed
+ *        times between failures and times to repair.  Must be called
+ *        after Create().
+ * 
+ * @param mtbf_mins Mean time (mins) a charger is in service between failures.
+ * @param mttr_mins Mean time (mins) to repair a charger.
+ */
+void Simulation::EnableOutages(const double mtbf_mins, const double mttr_mins)
+{
+    for(auto const& c : _chargers)
+        c->EnableFailures(mtbf_mins, mttr_mins, _gen());
+    _outages = true;
+}
+
+/**
+ * @brief Schedules an outage of a charger, e.g. maintenance.  Must be 
+ *        called after Create().
+ * 
+ * @param charger Id of the charger.
+ * @param start_mins Start of the outage (mins into the run).
+ * @param duration_mins Length of the outage (mins).
+ */
+void Simulation::ScheduleOutage(const uint16_t charger, const int64_t start_mins, const int64_t duration_mins)
+{
+    _chargers.at(charger)->ScheduleOutage(start_mins, duration_mins);
+    _outages = true;
+}
+
+/**
+ * @brief Grounds vehicles that fault in flight until a technician has 
+ *        repaired them, and samples the fleet's availability each 
+ *        simulated minute.  Only the serial engine models maintenance,
+ *        Simulate() rejects it on the others.  Must be called before 
+ *        Create().
+ * 
+ * @param technicians Number of vehicles repaired at the same time.
+ * @param mean_repair_mins Mean time (mins) to repair a vehicle.
+ */
+void Simulation::EnableMaintenance(const uint16_t technicians, const double mean_repair_mins)
+{
+    _technicians      = technicians;
+    _mean_repair_mins = mean_repair_mins;
+}
+
+/**
+ * @brief Sets the affinity of each vehicle and charger to the node of its
+ *        home site.
+ * 
+ */
+void Simulation::PinToNodes()
+{
+    for(auto const& v : _vehicles)
+    {
+        uint16_t node = _topology.SiteOfVehicle(v->ID()).Node();
+        v->SetAffinity(node, _numa->Cpus(node));
+    }
+
+    for(auto const& c : _chargers)
+    {
+        uint16_t node = c->Location().Node();
+        c->SetAffinity(node, _numa->Cpus(node));
+    }
+}
+
+/**
+ * @brief Seeds the random number generator, so a run can be repeated.
+ *        Must be called before Create().
+ * 
+ * @param seed Seed of the random number generator.
+ */
+void Simulation::Seed(const uint32_t seed)
+{
+    _seed = seed;
+    _gen.seed(seed);
+}
+
+/**
+ * @brief Creates a simulation restored from a snapshot file, ready to Run().
+ * 
+ * @param path Snapshot file.
+ * @return std::shared_ptr<Simulation> Restored simulation.
+ * @throws std::runtime_error Snapshot could not be loaded, or holds more 
+ *                            vehicles, chargers or sites than a simulation.
+ */
+std::shared_ptr<Simulation> Simulation::Resume(const std::string& path)
+{
+    std::shared_ptr<const Snapshot> snapshot = Snapshot::Load(path);
+    const SnapshotHeader& header = snapshot->Header();
+
+    constexpr uint32_t max = std::numeric_limits<unsigned short>::max();
+    if(header.num_vehicles > max || header.num_chargers > max || header.num_sites > max)
+        throw std::runtime_error("Snapshot " + path + " holds more vehicles, chargers or sites than a simulation");
+
+    auto sim = std::make_shared<Simulation>(header.num_vehicles, header.num_vehicle_types, header.num_chargers, header.num_sites);
+    sim->Restore(*snapshot);
+    return sim;
+}
+
+/**
+ * @brief Creates a variant of a warmed up simulation with a different 
+ *        number of chargers, ready to Run().  The variant's snapshot image
+ *        shares the records of base copy-on-write, so its checkpoints only
+ *        copy the records it changes.  The running objects are not shared:
+ *        every variant restores the whole fleet, a vehicle and a thread per
+ *        vehicle and charger, so creating one costs as much as Resume().
+ * 
+ * @param base Snapshot returned by Warmup() (or loaded from a file).
+ * @param num_chargers Number of chargers to run in the variant.
+ * @return std::shared_ptr<Simulation> Variant simulation.
+ */
+std::shared_ptr<Simulation> Simulation::Fork(const std::shared_ptr<const Snapshot>& base,
+                                             const unsigned short num_chargers)
+{
+    const SnapshotHeader& header = base->Header();
+
+    auto sim = std::make_shared<Simulation>(header.num_vehicles, header.num_vehicle_types, num_chargers, header.num_sites);
+    sim->Restore(*base);
+    sim->_image = base->Fork(num_chargers);
+    return sim;
+}
+
+/**
+ * @brief Runs the simulation for sim_time_secs without printing stats and 
+ *        captures its state, to be used as the base of Fork().
+ * 
+ * @param sim_time_secs Duration (seconds) to run simulation.
+ * @return std::shared_ptr<const Snapshot> State of the simulation at sim_time_secs.
+ */
+std::shared_ptr<const Snapshot> Simulation::Warmup(const int64_t sim_time_secs)
+{
+    std::cout << "Warming up simulation ... \n";
+
+    Start();
+    std::this_thread::sleep_until(_run_start + seconds(sim_time_secs));
+    std::shared_ptr<const Snapshot> base = Capture();
+    Stop();
+
+    // Forks share the base image, later captures must not modify it
+    _image = nullptr;
+    return base;
+}
+
+/**
+ * @brief Creates vehicles and chargers simulation objects in the state 
+ *        saved by snapshot.  Alternative to Create().  The running totals
+ *        count the intervals of this run only.
+ * 
+ * @param snapshot Snapshot to restore.
+ * @return size_t Number of simulation objects created.
+ * @throws std::invalid_argument Snapshot does not match the simulation configuration.
+ */
+size_t Simulation::Restore(const Snapshot& snapshot)
+{
+    const SnapshotHeader& header = snapshot.Header();
+
+    if(header.num_vehicles != _num_vehicles || header.num_sites != _topology.Size())
+        throw std::invalid_argument("Snapshot does not match simulation configuration");
 
-    // Create chargers
-    for(int i = 0; i < _num_chargers; ++i)
-        _sim_objs.push_back(std::make_shared<Charger>(i, _vehicle_charging_q));
+    // Random number generator
+    std::stringstream rng;
+    for(uint32_t i = 0; i < header.rng_words; ++i)
+        rng << header.rng[i] << ' ';
+    rng >> _gen;
+
+    _clock_offset_ms = header.clock_ms;
+
+    // Vehicles
+    for(uint32_t i = 0; i < header.num_vehicles; ++i)
+    {
+        const VehicleRecord& rec = snapshot.VehicleAt(i);
+
+        auto v = Vehicle::Create(static_cast<VehicleType>(rec.type), rec.id, _topology.At(rec.site), _context);
+        v->Restore(static_cast<VehicleStateType>(rec.state), _topology.At(rec.site), rec.energy, rec.leg_mins);
+        v->CruisingTime.Restore(rec.cruising.total_secs, rec.cruising.elapsed_ms >= 0, milliseconds(rec.cruising.elapsed_ms));
+        v->ChargingTime.Restore(rec.charging.total_secs, rec.charging.elapsed_ms >= 0, milliseconds(rec.charging.elapsed_ms));
+        v->QingTime.Restore    (rec.qing.total_secs,     rec.qing.elapsed_ms     >= 0, milliseconds(rec.qing.elapsed_ms));
+        _vehicles.push_back(v);
+    }
+
+    // Chargers and the vehicles they are charging
+    for(uint32_t i = 0; i < _num_chargers; ++i)
+    {
+        auto c = std::make_shared<Charger>(i, _topology.SiteOfCharger(i), _context);
+        if(i < header.num_chargers && snapshot.ChargerAt(i).vehicle_id >= 0)
+            c->Restore(_vehicles.at(snapshot.ChargerAt(i).vehicle_id));
+        _chargers.push_back(c);
+    }
+
+    // Vehicles on chargers that no longer exist go back to the front of their site's queue
+    for(uint32_t i = _num_chargers; i < header.num_chargers; ++i)
+    {
+        if(snapshot.ChargerAt(i).vehicle_id < 0)
+            continue;
+
+        auto v = _vehicles.at(snapshot.ChargerAt(i).vehicle_id);
+        v->ChargingTime.Restore(v->ChargingTime.Total() + duration_cast<seconds>(v->ChargingTime.Elapsed()).count(), false, {});
+        v->QingTime.Tik();
+        v->Location().Queue.enqueue(v);
+    }
+
+    // Totals restored with the vehicles count towards the running totals.
+    // The snapshot keeps no intervals, so the running count, shortest
+    // and longest interval only cover this run
+    for(auto const& v : _vehicles)
+    {
+        _context.Stats.AddTotal(v->Type(), CRUISE_STAT, v->CruisingTime.Total());
+        _context.Stats.AddTotal(v->Type(), CHARGE_STAT, v->ChargingTime.Total());
+        _context.Stats.AddTotal(v->Type(), QING_STAT,   v->QingTime.Total());
+    }
+
+    // Vehicles waiting to be charged, each at its own site
+    for(uint32_t i = 0; i < header.queue_length; ++i)
+    {
+        auto v = _vehicles.at(snapshot.QueueAt(i));
+        v->Location().Queue.enqueue(v);
+    }
+
+    if(_numa)
+        PinToNodes();
+
+    _sim_objs.insert(_sim_objs.end(), _vehicles.begin(), _vehicles.end());
+    _sim_objs.insert(_sim_objs.end(), _chargers.begin(), _chargers.end());
 
     return _sim_objs.size();
 }
 
+/**
+ * @brief Captures the full state of the simulation.  State transitions of
+ *        the simulation objects are paused only while the state is copied.
+ * 
+ * @return std::shared_ptr<Snapshot> Captured state.
+ */
+std::shared_ptr<Snapshot> Simulation::Capture()
+{
+    if(!_image)
+        _image = std::make_shared<Snapshot>(_vehicles.size(), _chargers.size());
+
+    SnapshotHeader& header = _image->Header();
+
+    header.num_vehicle_types = _num_vehicle_types;
+    header.num_sites         = _topology.Size();
+
+    // Random number generator
+    std::stringstream rng;
+    rng << _gen;
+    for(header.rng_words = 0; header.rng_words < SNAPSHOT_RNG_WORDS && rng >> header.rng[header.rng_words]; ++header.rng_words);
+
+    auto save = [](StopWatch& sw) -> StopWatchRecord {
+        return { sw.Total(), sw.Running() ? sw.Elapsed().count() : -1 };
+    };
+
+    // Pause state transitions while state is copied
+    std::unique_lock<std::shared_mutex> freeze(_context.FreezeLock);
+
+    header.clock_ms = Clock();
+
+    // Records are only written when changed so shared (forked) records stay shared
+    for(size_t i = 0; i < _vehicles.size(); ++i)
+    {
+        Vehicle& v = *_vehicles[i];
+        VehicleRecord rec = {};
+
+        rec.id       = v.ID();
+        rec.type     = v.Type();
+        rec.state    = v.State();
+        rec.site     = v.Location().ID();
+        rec.energy   = v.Energy();
+        rec.leg_mins = v.LegTime();
+        rec.cruising = save(v.CruisingTime);
+        rec.charging = save(v.ChargingTime);
+        rec.qing     = save(v.QingTime);
+        _image->Set(i, rec);
+    }
+
+    for(size_t i = 0; i < _chargers.size(); ++i)
+    {
+        std::shared_ptr<Vehicle> v = _chargers[i]->ChargingVehicle();
+        ChargerRecord rec = {};
+
+        rec.id         = _chargers[i]->ID();
+        rec.site       = _chargers[i]->Location().ID();
+        rec.vehicle_id = v ? v->ID() : -1;
+        _image->Set(i, rec);
+    }
+
+    header.queue_length = 0;
+    for(size_t s = 0; s < _topology.Size(); ++s)
+    {
+        for(auto const& v : _topology.At(s).Queue.Items())
+            _image->Set(header.queue_length++, uint32_t(v->ID()));
+    }
+
+    return _image;
+}
+
+/**
+ * @brief Captures the state of the simulation and writes the changes 
+ *        since the previous checkpoint to the checkpoint file.
+ * 
+ * @return size_t Number of bytes written.
+ */
+size_t Simulation::Checkpoint()
+{
+    if(!_snapshot_writer)
+        return 0;
+
+    std::shared_ptr<Snapshot> snapshot = Capture();
+    snapshot->Header().generation = ++_checkpoint_generation;
+    return _snapshot_writer->Write(*snapshot);
+}
+
+/**
+ * @brief Periodically writes checkpoints while the simulation runs.
+ * 
+ * @param path Checkpoint file.
+ * @param interval_secs Duration (seconds) between checkpoints.
+ */
+void Simulation::EnableCheckpoints(const std::string& path, const int64_t interval_secs)
+{
+    _snapshot_writer = std::make_unique<SnapshotWriter>(path);
+    _checkpoint_interval_secs = interval_secs;
+}
+
+/**
+ * @brief Samples the fleet while the simulation runs and writes the 
+ *        samples as a CSV time series once the run completes.
+ * 
+ * @param path Time series file.
+ * @param interval_secs Duration (seconds) between samples.
+ * @return std::shared_ptr<const FleetSampler> Sampler holding the samples of the last run.
+ */
+std::shared_ptr<const FleetSampler> Simulation::EnableSampling(const std::string& path, const int64_t interval_secs)
+{
+    _sampler = std::make_shared<FleetSampler>(interval_secs, _vehicles, _chargers, _topology, _context);
+    _sampler_path = path;
+    return _sampler;
+}
+
+/**
+ * @brief Publishes the running totals of each vehicle type into a POSIX
+ *        shared memory segment while the simulation runs, for local 
+ *        readers (ResultsReader) to poll.  The final totals are 
+ *        published once the run stops.  Must be called after the 
+ *        vehicles are created (or restored).
+ * 
+ * @param name Name of the shared memory segment, e.g. "/evtol_results".
+ * @param interval_ms Duration (ms of realtime) between publications.
+ * @return std::shared_ptr<const ResultsPublisher> Publisher of the results.
+ * @throws std::runtime_error Segment could not be created.
+ */
+std::shared_ptr<const ResultsPublisher> Simulation::EnablePublishing(const std::string& name, const int64_t interval_ms)
+{
+    _publisher = std::make_shared<ResultsPublisher>(name, interval_ms, _context);
+    return _publisher;
+}
+
+/**
+ * @brief Vehicles fly passenger trips assigned by a dispatcher instead of
+ *        flying until their battery is empty.  Must be called after the 
+ *        vehicles are created (or restored).
+ * 
+ * @param trips_per_min Mean number of trip requests per minute over a day.
+ * @param max_wait_mins Duration (mins) a request waits before it is lost.
+ * @return std::shared_ptr<const Dispatcher> Dispatcher assigning the trips.
+ */
+std::shared_ptr<const Dispatcher> Simulation::EnableTrips(const double trips_per_min, const int64_t max_wait_mins)
+{
+    for(auto const& v : _vehicles)
+        v->EnableTrips();
+
+    _demand = std::make_unique<Demand>(_topology, trips_per_min, _gen());
+    _dispatcher = std::make_shared<Dispatcher>(*_demand, _vehicles, _topology, max_wait_mins, _context);
+    return _dispatcher;
+}
+
+/**
+ * @brief Simulation time elapsed including time elapsed before a restore.
+ * 
+ * @return int64_t Simulation time elapsed (ms).
+ */
+int64_t Simulation::Clock() const
+{
+    if(_serial)
+        return _serial->Clock();
+    if(_parallel)
+        return _parallel->Clock();
+
+    if(_run_start == steady_clock::time_point())
+        return _clock_offset_ms;
+
+    return _clock_offset_ms + duration_cast<milliseconds>(steady_clock::now() - _run_start).count();
+}
+
 /**
  * @brief Prints the stats for each simulation object (Vehicle, Charger) to the console.
  * 
@@ -58,6 +566,54 @@ void Simulation::PrintStatsForEachSimObject() const
         so->PrintStats();
 }
 
+/**
+ * @brief Calculates the results of each vehicle type (VehicleA, VehicleB, ...)
+ *        from the running totals of the types, O(types) however large the
+ *        fleet, so it can be called at any time during a run.
+ *          * Avg Flight Time (mins)
+ *          * Flight Time (%)
+ *          * Avg Charge Time (mins)
+ *          * Charge Time (%)
+ *          * Avg Qing Time (mins)
+ *          * Qing Time (%)
+ *          * Max Faults
+ * 
+ * @param sim_time_secs Duration (seconds) to run simulation.
+ */
+std::vector<VehicleTypeMetrics> Simulation::MetricsForEachVehicleType(const int64_t sim_time_secs) const
+{
+    if(_serial)
+        return _serial->MetricsForEachVehicleType(sim_time_secs);
+    if(_parallel)
+        return _parallel->MetricsForEachVehicleType(sim_time_secs);
+
+    // Running totals of each type, kept up to date as the vehicles run
+    const TypeStats& stats = _context.Stats;
+
+    std::vector<VehicleTypeMetrics> metrics;
+    for(auto const& [type, info] : stats.Types())
+    {
+        const int64_t total_cruise = stats.Totals(type, CRUISE_STAT).total_secs;
+        const int64_t total_charge = stats.Totals(type, CHARGE_STAT).total_secs;
+        const int64_t total_q      = stats.Totals(type, QING_STAT).total_secs;
+
+        VehicleTypeMetrics m;
+        m.name         = info.name;
+        m.num_vehicles = info.num_vehicles;
+        m.cruise_mins  = double(total_cruise) / m.num_vehicles;
+        m.charge_mins  = double(total_charge) / m.num_vehicles;
+        m.qing_mins    = double(total_q)      / m.num_vehicles;
+        m.cruise_pct   = double(total_cruise) / double(sim_time_secs * m.num_vehicles) * 100.0;
+        m.charge_pct   = double(total_charge) / double(sim_time_secs * m.num_vehicles) * 100.0;
+        m.qing_pct     = double(total_q)      / double(sim_time_secs * m.num_vehicles) * 100.0;
+        m.distance     = info.passenger_miles_per_min * total_cruise;
+        m.max_faults   = sim_time_secs * info.faults_per_min * m.num_vehicles;
+        metrics.push_back(m);
+    }
+
+    return metrics;
+}
+
 /**
  * @brief Calculates and prints stats for each vehicle type (VehicleA, VehicleB, ...).
  *          * Avg Flight Time (mins)
@@ -75,65 +631,336 @@ void Simulation::PrintStatsForEachVehicleType(const int64_t sim_time_secs) const
     // Ideally the results would be saved to a file in a known format (i.e. csv) 
     // and have some external tool plot/graph/display results.  Please do not judge me.
 
-    // Find all Vehicle objects (downcast)
-    std::map<std::string, std::vector<std::shared_ptr<Vehicle>>> vehicle_stats;
-    for(auto const& so : _sim_objs)
-    {
-        std::shared_ptr<Vehicle> v = std::dynamic_pointer_cast<Vehicle>(so);
-        if(v)
-            vehicle_stats[v->Name()].push_back(v);
-    }
-
     std::cout << "\n\nTotal Simulation Time: " << sim_time_secs << " mins" << std::endl;
     std::cout << "----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------" << std::endl;
     std::cout << "|  Vehicle  |  Num Vehicles  |  Avg Flight Time (mins)  |  Flight Time (%)  |  Avg Charge Time (mins)  |  Charge Time (%)  |  Avg Qing Time (mins)  |  Qing Time (%)  |  Total Distance (miles)  | Max Faults  |" << std::endl;
     std::cout << "----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------" << std::endl;
 
-    // Calculate all vehicle stats and print to console
-    for(auto const& [key, val] : vehicle_stats)
+    // Print the stats of each vehicle type to console
+    for(auto const& m : MetricsForEachVehicleType(sim_time_secs))
     {
-        int64_t total_cruise   = 0;
-        int64_t total_charge   = 0;
-        int64_t total_q        = 0;
-        float   total_distance = 0.0;
+        std::cout << std::setprecision(2) << std::fixed;
+        std::cout << "|"   << std::right << std::setw(9) << std::setfill(' ') << m.name;
+        std::cout << "  |" << std::setw(14) << m.num_vehicles;
+        std::cout << "  |" << std::setw(24) << int64_t(m.cruise_mins);
+        std::cout << "  |" << std::setw(17) << float(m.cruise_pct);
+        std::cout << "  |" << std::setw(24) << int64_t(m.charge_mins);
+        std::cout << "  |" << std::setw(17) << float(m.charge_pct);
+        std::cout << "  |" << std::setw(22) << int64_t(m.qing_mins);
+        std::cout << "  |" << std::setw(15) << float(m.qing_pct);
+        std::cout << "  |" << std::setw(24) << float(m.distance);
+        std::cout << "  |" << std::setw(11) << float(m.max_faults);
+        std::cout << "  |" << std::endl;
+        std::cout << "----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------" << std::endl;
+    }
+}
+
+/**
+ * @brief Merges the latency histograms of each vehicle type (VehicleA, 
+ *        VehicleB, ...) and prints their distribution.
+ *          * Flight Time
+ *          * Charge Time
+ *          * Qing Time
+ * 
+ */
+void Simulation::PrintLatencyForEachVehicleType() const
+{
+    // Merge histograms of each vehicle type (threads have been joined)
+    std::map<std::string, std::array<Histogram, 3>> type_hists;
+    for(auto const& v : _vehicles)
+    {
+        std::array<Histogram, 3>& hists = type_hists[v->Name()];
+        hists[0].Merge(v->CruisingLaps);
+        hists[1].Merge(v->ChargingLaps);
+        hists[2].Merge(v->QingLaps);
+    }
+
+    const char* metrics[] = { "Flight Time", "Charge Time", "Qing Time" };
 
-        for(auto const& vehicle : val)
+    std::cout << "\n\nLatency Distribution (mins)" << std::endl;
+    std::cout << "----------------------------------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|  Vehicle  |     Metric     |  Count  |  Mean (mins)  |  p50 (mins)  |  p90 (mins)  |  p99 (mins)  |  Max (mins)  |" << std::endl;
+    std::cout << "----------------------------------------------------------------------------------------------------------------------" << std::endl;
+
+    for(auto const& [key, hists] : type_hists)
+    {
+        for(size_t i = 0; i < hists.size(); ++i)
         {
-            total_cruise += vehicle->CruisingTime.Total();
-            total_charge += vehicle->ChargingTime.Total();
-            total_q      += vehicle->QingTime.Total();
-            total_distance += vehicle->TotalDistance();
+            std::cout << std::setprecision(2) << std::fixed;
+            std::cout << "|"   << std::right << std::setw(9) << std::setfill(' ') << key;
+            std::cout << "  |" << std::setw(14) << metrics[i];
+            std::cout << "  |" << std::setw(7)  << hists[i].Count();
+            std::cout << "  |" << std::setw(13) << hists[i].Mean()           / 1000.0;
+            std::cout << "  |" << std::setw(12) << hists[i].Percentile(50.0) / 1000.0;
+            std::cout << "  |" << std::setw(12) << hists[i].Percentile(90.0) / 1000.0;
+            std::cout << "  |" << std::setw(12) << hists[i].Percentile(99.0) / 1000.0;
+            std::cout << "  |" << std::setw(12) << hists[i].Max()            / 1000.0;
+            std::cout << "  |" << std::endl;
         }
+        std::cout << "----------------------------------------------------------------------------------------------------------------------" << std::endl;
+    }
+}
+
+/**
+ * @brief Merges the histograms of the chargers of each site and prints 
+ *        the number of charges and the distribution of queueing time.
+ * 
+ */
+void Simulation::PrintStatsForEachSite() const
+{
+    std::vector<std::array<Histogram, 2>> site_hists(_topology.Size());
+    std::vector<size_t> site_chargers(_topology.Size());
+    for(auto const& c : _chargers)
+    {
+        site_hists[c->Location().ID()][0].Merge(c->ChargingLaps);
+        site_hists[c->Location().ID()][1].Merge(c->QingLaps);
+        ++site_chargers[c->Location().ID()];
+    }
+
+    std::cout << "\n\nSite Stats" << std::endl;
+    std::cout << "------------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|      Site  |  Chargers  |  Charges  |  Avg Qing (mins)  |  p99 Qing (mins)  |  Max Qing (mins)  |" << std::endl;
+    std::cout << "------------------------------------------------------------------------------------------------" << std::endl;
+
+    for(size_t s = 0; s < _topology.Size(); ++s)
+    {
+        const Histogram& qing = site_hists[s][1];
+
+        std::cout << std::setprecision(2) << std::fixed;
+        std::cout << "|"   << std::right << std::setw(10) << std::setfill(' ') << _topology.At(s).Name();
+        std::cout << "  |" << std::setw(10) << site_chargers[s];
+        std::cout << "  |" << std::setw(9)  << site_hists[s][0].Count();
+        std::cout << "  |" << std::setw(17) << qing.Mean()           / 1000.0;
+        std::cout << "  |" << std::setw(17) << qing.Percentile(99.0) / 1000.0;
+        std::cout << "  |" << std::setw(17) << qing.Max()            / 1000.0;
+        std::cout << "  |" << std::endl;
+    }
+    std::cout << "------------------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Prints the vehicles and chargers pinned to each NUMA node and how
+ *        many charging queue arrivals came from vehicles on other nodes.
+ * 
+ */
+void Simulation::PrintStatsForEachNode() const
+{
+    const size_t num_nodes = _numa->Nodes();
+    std::vector<size_t> vehicles(num_nodes), chargers(num_nodes);
+    std::vector<uint64_t> local(num_nodes), remote(num_nodes);
+
+    for(auto const& v : _vehicles)
+        ++vehicles[v->Node()];
+    for(auto const& c : _chargers)
+        ++chargers[c->Node()];
+    for(size_t s = 0; s < _topology.Size(); ++s)
+    {
+        const Site& site = _topology.At(s);
+        local[site.Node()]  += site.LocalArrivals();
+        remote[site.Node()] += site.RemoteArrivals();
+    }
+
+    std::cout << "\n\nNUMA Nodes: " << num_nodes << std::endl;
+    std::cout << "-------------------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|  Node  |  CPUs  |  Vehicles  |  Chargers  |  Local Arrivals  |  Remote Arrivals  |  Cross-node (%)  |" << std::endl;
+    std::cout << "-------------------------------------------------------------------------------------------------------" << std::endl;
+
+    std::cout << std::setprecision(2) << std::fixed;
+    for(size_t n = 0; n < num_nodes; ++n)
+    {
+        const uint64_t arrivals = local[n] + remote[n];
+        std::cout << "|"   << std::right << std::setw(6) << std::setfill(' ') << n;
+        std::cout << "  |" << std::setw(6)  << _numa->Cpus(n).size();
+        std::cout << "  |" << std::setw(10) << vehicles[n];
+        std::cout << "  |" << std::setw(10) << chargers[n];
+        std::cout << "  |" << std::setw(16) << local[n];
+        std::cout << "  |" << std::setw(17) << remote[n];
+        std::cout << "  |" << std::setw(16) << (arrivals ? 100.0 * remote[n] / arrivals : 0.0);
+        std::cout << "  |" << std::endl;
+    }
+    std::cout << "-------------------------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Prints the capacity of each site's charging queue and how many
+ *        vehicles found it full and waited, diverted or held.  Requires
+ *        BoundQueues().
+ * 
+ */
+void Simulation::PrintOverflowForEachSite() const
+{
+    static const char* POLICIES[] = { "Block", "Divert", "Hold" };
+
+    std::cout << "\n\nCharging Queue Overflow" << std::endl;
+    std::cout << "----------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|      Site  |  Capacity  |  Policy  |  Arrivals  |   Blocked  |  Diverted  |    Held  |" << std::endl;
+    std::cout << "----------------------------------------------------------------------------------------" << std::endl;
+
+    for(size_t s = 0; s < _topology.Size(); ++s)
+    {
+        const Site& site = _topology.At(s);
+
+        std::cout << "|"   << std::right << std::setw(10) << std::setfill(' ') << site.Name();
+        std::cout << "  |" << std::setw(10) << site.QueueCapacity();
+        std::cout << "  |" << std::setw(8)  << POLICIES[site.FullPolicy()];
+        std::cout << "  |" << std::setw(10) << site.LocalArrivals() + site.RemoteArrivals();
+        std::cout << "  |" << std::setw(10) << site.Blocked();
+        std::cout << "  |" << std::setw(10) << site.Diverted();
+        std::cout << "  |" << std::setw(8)  << site.Held();
+        std::cout << "  |" << std::endl;
+    }
+    std::cout << "----------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Prints the outages of the chargers of each site, the charges
+ *        they cut short and the vehicles moved to other sites.  
+ *        Requires EnableOutages() or ScheduleOutage().
+ * 
+ */
+void Simulation::PrintOutagesForEachSite() const
+{
+    std::vector<Histogram> outages(_topology.Size());
+    std::vector<uint64_t> interrupted(_topology.Size());
+    for(auto const& c : _chargers)
+    {
+        outages[c->Location().ID()].Merge(c->OutageLaps);
+        interrupted[c->Location().ID()] += c->Interrupted();
+    }
 
-        float probability_fault = val[0]->ProbabilityOfFault();
-        
-        int64_t num_vehicles_in_sim = val.size();
+    std::cout << "\n\nCharger Outages" << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|      Site  |  Outages  |  Down (mins)  |  Max (mins)  |  Interrupted  |  Redistributed  |" << std::endl;
+    std::cout << "-----------------------------------------------------------------------------------------" << std::endl;
 
-        int64_t avg_cruise_mins = total_cruise / num_vehicles_in_sim;
-        int64_t avg_charge_mins = total_charge / num_vehicles_in_sim;
-        int64_t avg_q_mins      = total_q      / num_vehicles_in_sim;
+    for(size_t s = 0; s < _topology.Size(); ++s)
+    {
+        const Site& site = _topology.At(s);
 
-        float max_num_faults    = float(sim_time_secs / 60.0f) * probability_fault * num_vehicles_in_sim;
+        std::cout << std::setprecision(2) << std::fixed;
+        std::cout << "|"   << std::right << std::setw(10) << std::setfill(' ') << site.Name();
+        std::cout << "  |" << std::setw(9)  << outages[s].Count();
+        std::cout << "  |" << std::setw(13) << outages[s].Mean() * outages[s].Count() / 1000.0;
+        std::cout << "  |" << std::setw(12) << outages[s].Max() / 1000.0;
+        std::cout << "  |" << std::setw(13) << interrupted[s];
+        std::cout << "  |" << std::setw(15) << site.Redistributed();
+        std::cout << "  |" << std::endl;
+    }
+    std::cout << "-----------------------------------------------------------------------------------------" << std::endl;
+}
 
-        float cruise_percentage = float(total_cruise) / float(sim_time_secs * num_vehicles_in_sim) * 100.0f;
-        float charge_percentage = float(total_charge) / float(sim_time_secs * num_vehicles_in_sim) * 100.0f;
-        float q_percentage      = float(total_q)      / float(sim_time_secs * num_vehicles_in_sim) * 100.0f;
+/**
+ * @brief Prints the contention of the lock of each site's charging 
+ *        queue.  Requires a build with EVTOL_LOCK_STATS.
+ * 
+ */
+void Simulation::PrintLockStatsForEachSite() const
+{
+    std::cout << "\n\nCharging Queue Lock Contention" << std::endl;
+    std::cout << "----------------------------------------------------------------------------------------------------------------" << std::endl;
+    std::cout << "|      Site  |  Acquisitions  |  Contended (%)  |  Avg Wait (us)  |  Max Wait (us)  |   Wakeups  |  Spurious  |" << std::endl;
+    std::cout << "----------------------------------------------------------------------------------------------------------------" << std::endl;
 
-        //float total_distance = val[0]->PassengerCount() * val[0]->CruiseSpeed() * float(total_cruise) / 60;
+    for(size_t s = 0; s < _topology.Size(); ++s)
+    {
+        const Site& site = _topology.At(s);
+        const LockStatsTotals t = site.Queue.LockTotals();
 
         std::cout << std::setprecision(2) << std::fixed;
-        std::cout << "|"   << std::right << std::setw(9) << std::setfill(' ') << key;
-        std::cout << "  |" << std::setw(14) << num_vehicles_in_sim;
-        std::cout << "  |" << std::setw(24) << avg_cruise_mins;
-        std::cout << "  |" << std::setw(17) << cruise_percentage;
-        std::cout << "  |" << std::setw(24) << avg_charge_mins;
-        std::cout << "  |" << std::setw(17) << charge_percentage;
-        std::cout << "  |" << std::setw(22) << avg_q_mins;
-        std::cout << "  |" << std::setw(15) << q_percentage;
-        std::cout << "  |" << std::setw(24) << total_distance;
-        std::cout << "  |" << std::setw(11) << max_num_faults;
+        std::cout << "|"   << std::right << std::setw(10) << std::setfill(' ') << site.Name();
+        std::cout << "  |" << std::setw(14) << t.acquisitions;
+        std::cout << "  |" << std::setw(15) << (t.acquisitions ? 100.0 * t.contended / t.acquisitions : 0.0);
+        std::cout << "  |" << std::setw(15) << (t.contended ? t.total_wait_ns / 1e3 / t.contended : 0.0);
+        std::cout << "  |" << std::setw(15) << t.max_wait_ns / 1e3;
+        std::cout << "  |" << std::setw(10) << t.wakeups;
+        std::cout << "  |" << std::setw(10) << t.spurious_wakeups;
+        std::cout << "  |" << std::endl;
+    }
+    std::cout << "----------------------------------------------------------------------------------------------------------------" << std::endl;
+}
+
+/**
+ * @brief Analytical model of this simulation's fleet and chargers.
+ * 
+ * @return ChargingModel Model of the charging system.
+ */
+ChargingModel Simulation::Model() const
+{
+    return ChargingModel::FromVehicles(_vehicles, _num_chargers);
+}
+
+/**
+ * @brief Prints the queueing time of each vehicle type (VehicleA, 
+ *        VehicleB, ...) and charger utilization predicted by Model() 
+ *        next to the measured values.
+ * 
+ * @param sim_time_secs Duration (seconds) the simulation ran.
+ */
+void Simulation::PrintModelForEachVehicleType(const int64_t sim_time_secs) const
+{
+    if(_num_chargers == 0 || sim_time_secs <= 0)
+        return;
+
+    ChargingEstimate estimate = Model().Solve();
+
+    // Measured queueing time of completed waits for each vehicle type
+    std::map<std::string, Histogram> type_qing;
+    int64_t total_charge = 0;
+    for(auto const& v : _vehicles)
+    {
+        type_qing[v->Name()].Merge(v->QingLaps);
+        total_charge += v->ChargingTime.Total();
+    }
+
+    float utilization = float(total_charge) / float(sim_time_secs * _num_chargers) * 100.0f;
+
+    std::cout << "\n\nModel (steady state) vs Simulation (" << _num_chargers << " chargers)" << std::endl;
+    std::cout << "-----------------------------------------------------------------------" << std::endl;
+    std::cout << "|  Vehicle  |  Predicted Qing (mins)  |  Measured Qing (mins)  |  Count  |" << std::endl;
+    std::cout << "-----------------------------------------------------------------------" << std::endl;
+
+    for(auto const& ce : estimate.classes)
+    {
+        const Histogram& measured = type_qing[ce.name];
+
+        std::cout << std::setprecision(2) << std::fixed;
+        std::cout << "|"   << std::right << std::setw(9) << std::setfill(' ') << ce.name;
+        std::cout << "  |" << std::setw(23) << ce.qing_mins;
+        std::cout << "  |" << std::setw(22) << measured.Mean() / 1000.0;
+        std::cout << "  |" << std::setw(7)  << measured.Count();
+        std::cout << "  |" << std::endl;
+    }
+    std::cout << "-----------------------------------------------------------------------" << std::endl;
+    std::cout << "Charger Utilization (%): predicted " << estimate.utilization * 100.0 << ", measured " << utilization << std::endl;
+}
+
+/**
+ * @brief Prints the predicted charger utilization and queueing time of 
+ *        each vehicle type for 1 to max_chargers chargers, without 
+ *        running the simulation.
+ * 
+ * @param max_chargers Largest number of chargers to predict.
+ */
+void Simulation::PrintChargerSizing(const unsigned short max_chargers) const
+{
+    if(_vehicles.empty() || max_chargers == 0)
+        return;
+
+    ChargingModel model = ChargingModel::FromVehicles(_vehicles, 1);
+
+    std::cout << "\n\nPredicted Charger Sizing (Avg Qing Time in mins)" << std::endl;
+
+    for(unsigned short chargers = 1; chargers <= max_chargers; ++chargers)
+    {
+        ChargingEstimate estimate = model.WithChargers(chargers).Solve();
+
+        std::cout << std::setprecision(2) << std::fixed;
+        std::cout << "|  Chargers " << std::right << std::setw(4) << std::setfill(' ') << chargers;
+        std::cout << "  |  Utilization (%) " << std::setw(6) << estimate.utilization * 100.0;
+        std::cout << "  |  Queue Length " << std::setw(6) << estimate.queue_length;
+        for(auto const& ce : estimate.classes)
+            std::cout << "  |  " << ce.name << " " << std::setw(7) << ce.qing_mins;
         std::cout << "  |" << std::endl;
-        std::cout << "----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------" << std::endl;
     }
 }
 
@@ -141,32 +968,36 @@ void Simulation::PrintStatsForEachVehicleType(const int64_t sim_time_secs) const
  * @brief Runs the simulation for sim_time_secs. Each second that passes in 
  *        realtime is equivalent to one minute of simulation time, i.e. 180s
  *        of realtime is 3 hours for simulation time.  Prints stats of each
- *        vehicle type.
+ *        vehicle type.  The serial and parallel engines run as fast as
+ *        they can instead.
  * 
  * @param sim_time_secs Duration (seconds) to run simulation.
  */
-void Simulation::Run(const int64_t sim_time_secs) const
+void Simulation::Run(const int64_t sim_time_secs)
 {
-    std::cout << "Starting simulation ... \n";
+    if(!_context.Quiet)
+        std::cout << "Starting simulation ... \n";
 
     high_resolution_clock::time_point t1 = high_resolution_clock::now();
 
-    // Start simulation
-    for(auto const& so : _sim_objs)
-        so->Start();
-
-    // Run simulation for secs
-    std::this_thread::sleep_for(std::chrono::seconds(sim_time_secs));
-
-    std::cout << "Stopping simulation ...\n";
-
-    // Stop simulation
-    for(auto const& so : _sim_objs)
-        so->Stop();
+    Simulate(sim_time_secs);
 
     high_resolution_clock::time_point t2 = high_resolution_clock::now();
     duration<double> time_span = duration_cast<duration<double>>(t2 - t1);
-    std::cout << "Simulation ran for " << time_span.count() << " seconds.\n";
+    if(!_context.Quiet)
+        std::cout << "Simulation ran for " << time_span.count() << " seconds.\n";
+
+    // Headless runs print the results of each vehicle type only, files are still written.
+    // The other engines keep no more than those results.
+    if(_context.Quiet || _engine != SimulationEngine::THREADED)
+    {
+        PrintStatsForEachVehicleType(sim_time_secs + _clock_offset_ms / 1000);
+        if(_serial && _technicians > 0)
+            _serial->PrintMaintenance();
+        if(_sampler && !_sampler_path.empty())
+            _sampler->WriteCsv(_sampler_path);
+        return;
+    }
 
     std::cout << "Calculating statistics ...\n";
 
@@ -174,5 +1005,163 @@ void Simulation::Run(const int64_t sim_time_secs) const
     PrintStatsForEachSimObject();
 
     // Stats for each vehicle type (VehicleA, VehicleB, ...)
-    PrintStatsForEachVehicleType(sim_time_secs);
+    PrintStatsForEachVehicleType(sim_time_secs + _clock_offset_ms / 1000);
+
+    // Latency distribution for each vehicle type
+    PrintLatencyForEachVehicleType();
+
+    // Stats for each site
+    if(_topology.Size() > 1)
+        PrintStatsForEachSite();
+
+    // Vehicles that found a bounded charging queue full
+    if(_topology.At(0).QueueCapacity() > 0)
+        PrintOverflowForEachSite();
+
+    // Chargers out of service and the vehicles they displaced
+    if(_outages)
+        PrintOutagesForEachSite();
+
+    // Contention of the charging queue locks
+    if(ChargingQLockStats::ENABLED)
+        PrintLockStatsForEachSite();
+
+    // Charging queue traffic within and across NUMA nodes
+    if(_numa)
+        PrintStatsForEachNode();
+
+    // Trips dispatched, or the analytical prediction of full battery flights
+    if(_dispatcher)
+        _dispatcher->PrintStats();
+    else
+        PrintModelForEachVehicleType(sim_time_secs);
+
+    // Time series of the fleet
+    if(_sampler)
+    {
+        _sampler->PrintStats();
+        if(!_sampler_path.empty())
+            _sampler->WriteCsv(_sampler_path);
+    }
+
+    // Results published to shared memory
+    if(_publisher)
+        _publisher->PrintStats();
+}
+
+/**
+ * @brief Runs the simulation for sim_time_secs, checkpointing when 
+ *        enabled, without printing stats.  Run() prints the stats
+ *        afterwards; replications collect the metrics instead.
+ * 
+ * @param sim_time_secs Duration (seconds) to run simulation.
+ * @throws std::logic_error Features the selected engine does not run are enabled,
+ *         or vehicles hold without trips.
+ */
+void Simulation::Simulate(const int64_t sim_time_secs)
+{
+    if(_technicians > 0 && _engine != SimulationEngine::SERIAL)
+        throw std::logic_error("Maintenance needs the serial engine");
+
+    if(_topology.At(0).FullPolicy() == HOLD && _topology.At(0).QueueCapacity() > 0 && !_dispatcher)
+        throw std::logic_error("Holding needs trips, full battery flights land empty");
+
+    if(_engine != SimulationEngine::THREADED)
+    {
+        if(_dispatcher || _outages || _snapshot_writer || _sampler || _publisher || _topology.At(0).QueueCapacity() > 0)
+            throw std::logic_error("Trips, outages, bounded queues, checkpoints, sampling and publishing need the threaded engine");
+
+        if(_serial)
+            _serial->Run(sim_time_secs);
+        if(_parallel)
+            _parallel->Run(sim_time_secs);
+        return;
+    }
+
+    // Columns are allocated up front so sampling never allocates
+    if(_sampler)
+        _sampler->Prepare(sim_time_secs, _clock_offset_ms);
+
+    if(_dispatcher)
+        _dispatcher->Prepare(_clock_offset_ms);
+
+    if(_publisher)
+        _publisher->Prepare(_clock_offset_ms);
+
+    // Start simulation
+    Start();
+
+    // Run simulation for secs, checkpointing periodically
+    const steady_clock::time_point end = _run_start + seconds(sim_time_secs);
+    if(_snapshot_writer && _checkpoint_interval_secs > 0)
+    {
+        for(auto next = _run_start + seconds(_checkpoint_interval_secs); next < end; next += seconds(_checkpoint_interval_secs))
+        {
+            std::this_thread::sleep_until(next);
+            Checkpoint();
+        }
+    }
+    std::this_thread::sleep_until(end);
+
+    // Final checkpoint is taken before stopping so the run can be resumed
+    Checkpoint();
+
+    // Stop simulation
+    Stop();
+}
+
+/**
+ * @brief Starts all simulation objects.
+ * 
+ */
+void Simulation::Start()
+{
+    _context.Shutdown = StopSource();
+
+    _run_start = steady_clock::now();
+    for(auto const& so : _sim_objs)
+        so->Start(_context.Shutdown.Token());
+
+    if(_sampler)
+        _sampler->Start(_context.Shutdown.Token());
+
+    if(_dispatcher)
+        _dispatcher->Start(_context.Shutdown.Token());
+
+    if(_publisher)
+        _publisher->Start(_context.Shutdown.Token());
+}
+
+/**
+ * @brief Stops all simulation objects.  The stop is broadcast to every 
+ *        object first so all objects exit concurrently, then each is joined.
+ * 
+ */
+void Simulation::Stop()
+{
+    _context.Shutdown.RequestStop();
+
+    for(auto const& so : _sim_objs)
+        so->Join();
+
+    // Vehicles refused by a full queue (or handed back by an outage) are 
+    // waiting outside any queue, the chargers only drained the queued ones
+    for(auto const& v : _vehicles)
+    {
+        if(v->State() == NEEDS_CHARGED && v->QingTime.Running())
+            v->QingTime.Tok();
+    }
+
+    if(_sampler)
+        _sampler->Join();
+
+    if(_dispatcher)
+        _dispatcher->Join();
+
+    // Every vehicle has recorded its last interval, these are the final totals
+    if(_publisher)
+    {
+        _publisher->Join();
+        _publisher->Publish(Clock(), true);
+    }
 }
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include "NumaTopology.h"
 #include "SimulationThread.h"
 
 /**
@@ -11,6 +12,9 @@ void SimulationThread::Join()
         _thread->join();
         _thread = nullptr;
     }
+
+    _on_parent_stop = nullptr;
+    _on_stop = nullptr;
 }
 
 /**
@@ -23,11 +27,27 @@ void SimulationThread::Run()
 /**
  * @brief Starts the thread.
  * 
+ * @param parent Token shared by a group of threads, a stop requested on 
+ *               it also stops this thread.
  */
-void SimulationThread::Start()
+void SimulationThread::Start(const StopToken& parent)
 {
-    _thread.reset(new std::thread(SimulationThread::run, this));
+    _stop_source  = StopSource();
     _thread_state = ThreadState::RUNNING;
+
+    _on_stop = std::make_unique<StopCallback>(_stop_source.Token(), [this]() {
+        {
+            std::unique_lock<std::mutex> lock(_cs);
+            _thread_state = ThreadState::EXIT;
+        }
+        _cv.notify_all();
+    });
+
+    _on_parent_stop = std::make_unique<StopCallback>(parent, [this]() {
+        _stop_source.RequestStop();
+    });
+
+    _thread.reset(new std::thread(SimulationThread::run, this));
 }
 
 /**
@@ -36,11 +56,31 @@ void SimulationThread::Start()
  */
 void SimulationThread::Stop()
 {
-    _thread_state = ThreadState::EXIT;
-    _cv.notify_all();
+    RequestStop();
     Join();
 }
 
+/**
+ * @brief Requests the thread to stop without waiting for it to exit.
+ * 
+ */
+void SimulationThread::RequestStop()
+{
+    _stop_source.RequestStop();
+}
+
+/**
+ * @brief Pins the thread to the CPUs of a NUMA node from the next Start().
+ * 
+ * @param node NUMA node of the thread.
+ * @param cpus CPUs of the node.
+ */
+void SimulationThread::SetAffinity(const uint16_t node, const std::vector<int>& cpus)
+{
+    _node = node;
+    _cpus = cpus;
+}
+
 /**
  * @brief Thread of execution to run.
  * 
@@ -48,5 +88,10 @@ void SimulationThread::Stop()
  */
 void SimulationThread::run(SimulationThread* st)
 {
+    // Pinned before Run() touches its stack or allocates, so the thread's
+    // own memory is first touched on its node
+    if(!st->_cpus.empty())
+        NumaTopology::Pin(pthread_self(), st->_cpus);
+
     st->Run();
 }
\ No newline at end of file
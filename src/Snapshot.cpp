@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Snapshot.h"
+
+/**
+ * @brief Granularity (bytes) at which successive images are compared.
+ *
+ */
+constexpr size_t SNAPSHOT_BLOCK_SIZE = 64;
+
+/**
+ * @brief Number of records of each type per copy-on-write segment.
+ *
+ */
+constexpr size_t SNAPSHOT_VEHICLES_PER_SEGMENT = 64;
+constexpr size_t SNAPSHOT_CHARGERS_PER_SEGMENT = 64;
+constexpr size_t SNAPSHOT_QUEUE_PER_SEGMENT    = 1024;
+
+/**
+ * @brief Allocates a zeroed segment.
+ *
+ * @param size Size of segment in bytes.
+ * @return std::shared_ptr<uint8_t> Segment.
+ */
+static std::shared_ptr<uint8_t> AllocateSegment(size_t size)
+{
+    return std::shared_ptr<uint8_t>(new uint8_t[size](), std::default_delete<uint8_t[]>());
+}
+
+/**
+ * @brief Construct a new, zeroed Snapshot object.
+ *
+ * @param num_vehicles Number of vehicle records.
+ * @param num_chargers Number of charger records.
+ */
+Snapshot::Snapshot(const uint32_t num_vehicles,
+                   const uint32_t num_chargers) : Snapshot(num_vehicles, num_chargers, nullptr)
+{
+    SnapshotHeader& header = Header();
+    header.magic        = SNAPSHOT_MAGIC;
+    header.version      = SNAPSHOT_VERSION;
+    header.num_vehicles = num_vehicles;
+    header.num_chargers = num_chargers;
+    header.num_sites    = 1;
+}
+
+/**
+ * @brief Construct a Snapshot object whose segments view a contiguous 
+ *        image (a mapped file), or are zeroed when image is nullptr.
+ *
+ * @param num_vehicles Number of vehicle records.
+ * @param num_chargers Number of charger records.
+ * @param image Contiguous image or nullptr.
+ */
+Snapshot::Snapshot(const uint32_t num_vehicles,
+                   const uint32_t num_chargers,
+                   const std::shared_ptr<uint8_t>& image) : _num_vehicles(num_vehicles),
+                                                            _num_chargers(num_chargers),
+                                                            _segments(),
+                                                            _vehicle_segs(),
+                                                            _charger_segs(),
+                                                            _queue_segs()
+{
+    // Header is never shared
+    _segments.push_back({ 0, sizeof(SnapshotHeader), AllocateSegment(sizeof(SnapshotHeader)) });
+    if(image)
+        std::memcpy(_segments[0].data.get(), image.get(), sizeof(SnapshotHeader));
+
+    _vehicle_segs = AddRegion(num_vehicles, sizeof(VehicleRecord), SNAPSHOT_VEHICLES_PER_SEGMENT, image);
+    _charger_segs = AddRegion(num_chargers, sizeof(ChargerRecord), SNAPSHOT_CHARGERS_PER_SEGMENT, image);
+    _queue_segs   = AddRegion(num_vehicles, sizeof(uint32_t),      SNAPSHOT_QUEUE_PER_SEGMENT,    image);
+}
+
+/**
+ * @brief Construct a copy-on-write fork of base.
+ *
+ * @param base Snapshot to fork.
+ * @param num_chargers Number of charger records of the fork.
+ */
+Snapshot::Snapshot(const Snapshot& base,
+                   const uint32_t  num_chargers) : _num_vehicles(base._num_vehicles),
+                                                   _num_chargers(num_chargers),
+                                                   _segments(),
+                                                   _vehicle_segs(),
+                                                   _charger_segs(),
+                                                   _queue_segs()
+{
+    _segments.push_back({ 0, sizeof(SnapshotHeader), AllocateSegment(sizeof(SnapshotHeader)) });
+    std::memcpy(_segments[0].data.get(), base._segments[0].data.get(), sizeof(SnapshotHeader));
+    Header().num_chargers = num_chargers;
+
+    // Vehicle records are shared
+    _vehicle_segs = { _segments.size(), base._vehicle_segs.per_segment };
+    _segments.insert(_segments.end(),
+                     base._segments.begin() + base._vehicle_segs.first,
+                     base._segments.begin() + base._charger_segs.first);
+
+    // Charger records are copied
+    _charger_segs = AddRegion(num_chargers, sizeof(ChargerRecord), SNAPSHOT_CHARGERS_PER_SEGMENT, nullptr);
+    for(uint32_t i = 0; i < num_chargers; ++i)
+    {
+        ChargerRecord& rec = *MutableRecord<ChargerRecord>(_charger_segs, i);
+        if(i < base._num_chargers)
+            rec = base.ChargerAt(i);
+        else
+            rec = { uint16_t(i), uint16_t(i % std::max<uint32_t>(Header().num_sites, 1)), -1 };
+    }
+
+    // Queue entries are shared
+    _queue_segs = { _segments.size(), base._queue_segs.per_segment };
+    _segments.insert(_segments.end(),
+                     base._segments.begin() + base._queue_segs.first,
+                     base._segments.end());
+
+    Layout();
+}
+
+/**
+ * @brief Size (bytes) of an image holding the requested number of records.
+ *
+ * @param num_vehicles Number of vehicle records.
+ * @param num_chargers Number of charger records.
+ * @return size_t Size of image in bytes.
+ */
+size_t Snapshot::ImageSize(const uint32_t num_vehicles,
+                           const uint32_t num_chargers)
+{
+    return sizeof(SnapshotHeader)
+         + num_vehicles * sizeof(VehicleRecord)
+         + num_chargers * sizeof(ChargerRecord)
+         + num_vehicles * sizeof(uint32_t);
+}
+
+/**
+ * @brief Maps a snapshot file into memory (read-only), the slot holding
+ *        the latest snapshot whose checksum is intact.
+ *
+ * @param path Snapshot file.
+ * @return std::shared_ptr<const Snapshot> Loaded snapshot.
+ * @throws std::runtime_error File could not be mapped or has no valid snapshot.
+ */
+std::shared_ptr<const Snapshot> Snapshot::Load(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        throw std::runtime_error("Unable to open snapshot " + path);
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || size_t(st.st_size) < SNAPSHOT_SLOTS * sizeof(SnapshotHeader))
+    {
+        close(fd);
+        throw std::runtime_error("Invalid snapshot " + path);
+    }
+
+    size_t size = st.st_size;
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED)
+        throw std::runtime_error("Unable to map snapshot " + path);
+
+    // Mapping lives as long as any segment (of this snapshot or its forks) views it
+    std::shared_ptr<uint8_t> file(static_cast<uint8_t*>(data), [size](uint8_t* p) { munmap(p, size); });
+
+    int slot = LatestSlot(file.get(), size);
+    if(slot < 0)
+        throw std::runtime_error("Invalid snapshot " + path);
+
+    std::shared_ptr<uint8_t> image(file, file.get() + slot * (size / SNAPSHOT_SLOTS));
+    const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(image.get());
+    return std::shared_ptr<const Snapshot>(new Snapshot(header->num_vehicles, header->num_chargers, image));
+}
+
+/**
+ * @brief Distance (bytes) between the slots of a snapshot file holding
+ *        images of size bytes (rounded up to a page, so each slot can be
+ *        mapped on its own).
+ *
+ * @param size Size of image in bytes.
+ * @return size_t Size of a slot in bytes.
+ */
+size_t Snapshot::SlotSize(const size_t size)
+{
+    const size_t page = size_t(sysconf(_SC_PAGESIZE));
+    return (size + page - 1) / page * page;
+}
+
+/**
+ * @brief Finds the slot of a snapshot file holding the latest valid
+ *        snapshot: magic, version, size and checksum all match.
+ *
+ * @param file Contents of the file.
+ * @param file_size Size of the file in bytes.
+ * @return int Slot (-1 when no slot is valid).
+ */
+int Snapshot::LatestSlot(const uint8_t* file, const size_t file_size)
+{
+    const size_t slot_size = file_size / SNAPSHOT_SLOTS;
+    if(file_size % SNAPSHOT_SLOTS != 0 || slot_size < sizeof(SnapshotHeader))
+        return -1;
+
+    int latest = -1;
+    uint64_t latest_sequence = 0;
+    for(size_t slot = 0; slot < SNAPSHOT_SLOTS; ++slot)
+    {
+        const uint8_t* image = file + slot * slot_size;
+
+        SnapshotHeader header;
+        std::memcpy(&header, image, sizeof(SnapshotHeader));
+        if(header.magic   != SNAPSHOT_MAGIC   ||
+           header.version != SNAPSHOT_VERSION ||
+           SlotSize(ImageSize(header.num_vehicles, header.num_chargers)) != slot_size)
+            continue;
+
+        // A slot torn by a crash fails its checksum
+        const size_t size = ImageSize(header.num_vehicles, header.num_chargers);
+        if(Checksum([&](auto f) { f(0, image, size); }) != header.checksum)
+            continue;
+
+        if(latest < 0 || header.sequence > latest_sequence)
+        {
+            latest          = int(slot);
+            latest_sequence = header.sequence;
+        }
+    }
+
+    return latest;
+}
+
+/**
+ * @brief Creates a copy-on-write fork of this snapshot.  Vehicle and queue
+ *        records are shared until changed; charger records are resized to
+ *        num_chargers (new chargers are idle).
+ *
+ * @param num_chargers Number of charger records of the fork.
+ * @return std::shared_ptr<Snapshot> Forked snapshot.
+ */
+std::shared_ptr<Snapshot> Snapshot::Fork(const uint32_t num_chargers) const
+{
+    return std::shared_ptr<Snapshot>(new Snapshot(*this, num_chargers));
+}
+
+/**
+ * @brief Number of bytes of records still shared with another snapshot.
+ *
+ * @return size_t Number of shared bytes.
+ */
+size_t Snapshot::SharedBytes() const
+{
+    size_t shared = 0;
+    for(auto const& seg : _segments)
+        if(seg.data.use_count() > 1)
+            shared += seg.size;
+
+    return shared;
+}
+
+/**
+ * @brief Appends segments holding count records.  Segments view image at
+ *        the current end of the layout, or are zeroed when image is nullptr.
+ *
+ * @param count Number of records.
+ * @param size Size of a record.
+ * @param per_segment Records per segment.
+ * @param image Contiguous image or nullptr.
+ * @return Region Region of the appended segments.
+ */
+Snapshot::Region Snapshot::AddRegion(size_t count, size_t size, size_t per_segment, const std::shared_ptr<uint8_t>& image)
+{
+    Region region = { _segments.size(), per_segment };
+
+    size_t offset = _segments.back().offset + _segments.back().size;
+    for(size_t i = 0; i < count; i += per_segment)
+    {
+        size_t len = std::min(per_segment, count - i) * size;
+        if(image)
+            _segments.push_back({ offset, len, std::shared_ptr<uint8_t>(image, image.get() + offset) });
+        else
+            _segments.push_back({ offset, len, AllocateSegment(len) });
+        offset += len;
+    }
+
+    return region;
+}
+
+/**
+ * @brief Recalculates the offset of each segment.
+ *
+ */
+void Snapshot::Layout()
+{
+    size_t offset = 0;
+    for(auto& seg : _segments)
+    {
+        seg.offset = offset;
+        offset += seg.size;
+    }
+}
+
+/**
+ * @brief Replaces a shared segment with a private copy.
+ *
+ * @param seg Segment to copy.
+ */
+void Snapshot::Unshare(Segment& seg)
+{
+    std::shared_ptr<uint8_t> copy = AllocateSegment(seg.size);
+    std::memcpy(copy.get(), seg.data.get(), seg.size);
+    seg.data = copy;
+}
+
+/**
+ * @brief Construct a new SnapshotWriter object.
+ *
+ * @param path Snapshot file (created if missing).  A valid snapshot
+ *             already in the file is kept until the first write is synced.
+ * @throws std::runtime_error File could not be opened.
+ */
+SnapshotWriter::SnapshotWriter(const std::string& path) : _path(path),
+                                                          _fd(open(path.c_str(), O_RDWR | O_CREAT, 0644)),
+                                                          _previous(),
+                                                          _sequence(0)
+{
+    if(_fd < 0)
+        throw std::runtime_error("Unable to create snapshot " + path);
+}
+
+/**
+ * @brief Destroy the SnapshotWriter object.  Closes the file.
+ *
+ */
+SnapshotWriter::~SnapshotWriter()
+{
+    if(_fd >= 0)
+        close(_fd);
+}
+
+/**
+ * @brief Writes the records of snapshot that differ from the snapshot
+ *        last written to the next slot, syncs them, then writes the
+ *        header and syncs the file.
+ *
+ * @param snapshot Snapshot to write.
+ * @return size_t Number of bytes written.
+ * @throws std::runtime_error Write failed.
+ */
+size_t SnapshotWriter::Write(const Snapshot& snapshot)
+{
+    const size_t size      = snapshot.Size();
+    const size_t slot_size = Snapshot::SlotSize(size);
+    size_t written = 0;
+
+    // First write (or layout changed): keep the latest valid snapshot of
+    // the file, if it has the same layout, and write to the other slot
+    if(std::none_of(_previous.begin(), _previous.end(), [size](const std::vector<uint8_t>& p) { return p.size() == size; }))
+    {
+        _sequence = 0;
+
+        struct stat st;
+        if(fstat(_fd, &st) == 0 && size_t(st.st_size) == SNAPSHOT_SLOTS * slot_size)
+        {
+            std::vector<uint8_t> file(st.st_size);
+            if(pread(_fd, file.data(), file.size(), 0) == ssize_t(file.size()))
+            {
+                int latest = Snapshot::LatestSlot(file.data(), file.size());
+                if(latest >= 0)
+                    _sequence = reinterpret_cast<const SnapshotHeader*>(file.data() + latest * slot_size)->sequence;
+            }
+        }
+        else if(ftruncate(_fd, SNAPSHOT_SLOTS * slot_size) != 0)
+        {
+            throw std::runtime_error("Unable to resize snapshot " + _path);
+        }
+
+        for(auto& previous : _previous)
+            previous.clear();
+    }
+
+    const uint64_t sequence = _sequence + 1;
+    const size_t   slot     = sequence % SNAPSHOT_SLOTS;
+    const size_t   origin   = slot * slot_size;
+
+    // Slot not yet written by this writer, write all records
+    const bool full = _previous[slot].size() != size;
+    if(full)
+        _previous[slot].assign(size, 0);
+
+    // Write each run of changed blocks following the header
+    snapshot.ForEachSegment([&](size_t base, const uint8_t* data, size_t len) {
+        if(base == 0)
+            return;
+
+        uint8_t* previous = _previous[slot].data() + base;
+        for(size_t offset = 0; offset < len; )
+        {
+            size_t block = std::min(SNAPSHOT_BLOCK_SIZE, len - offset);
+            if(!full && std::memcmp(data + offset, previous + offset, block) == 0)
+            {
+                offset += block;
+                continue;
+            }
+
+            size_t start = offset;
+            while(offset < len && (full || std::memcmp(data + offset, previous + offset, std::min(SNAPSHOT_BLOCK_SIZE, len - offset)) != 0))
+                offset += std::min(SNAPSHOT_BLOCK_SIZE, len - offset);
+
+            WriteRange(data + start, origin + base + start, offset - start);
+            std::memcpy(previous + start, data + start, offset - start);
+            written += offset - start;
+        }
+    });
+
+    // Records are on disk before the header that describes them
+    Sync();
+
+    SnapshotHeader header = snapshot.Header();
+    header.sequence = sequence;
+    header.checksum = 0;
+    header.checksum = Snapshot::Checksum([&](auto f) {
+        snapshot.ForEachSegment([&](size_t base, const uint8_t* data, size_t len) {
+            f(base, base == 0 ? reinterpret_cast<const uint8_t*>(&header) : data, len);
+        });
+    });
+
+    WriteRange(reinterpret_cast<const uint8_t*>(&header), origin, sizeof(SnapshotHeader));
+    written += sizeof(SnapshotHeader);
+    Sync();
+
+    _sequence = sequence;
+    return written;
+}
+
+/**
+ * @brief Syncs the data written to the file.
+ *
+ */
+void SnapshotWriter::Sync()
+{
+    if(fdatasync(_fd) != 0)
+        throw std::runtime_error("Unable to sync snapshot " + _path);
+}
+
+/**
+ * @brief Writes a range of the image to an offset in the file.
+ *
+ * @param data Start of range.
+ * @param offset Offset in file.
+ * @param size Number of bytes to write.
+ */
+void SnapshotWriter::WriteRange(const uint8_t* data, size_t offset, size_t size)
+{
+    while(size > 0)
+    {
+        ssize_t n = pwrite(_fd, data, size, offset);
+        if(n < 0)
+            throw std::runtime_error("Unable to write snapshot " + _path);
+
+        data   += n;
+        offset += n;
+        size   -= n;
+    }
+}
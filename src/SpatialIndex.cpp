@@ -0,0 +1,93 @@
+#include "SpatialIndex.h"
+
+/**
+ * @brief Construct a new SpatialIndex object.
+ *
+ * @param cell_size Width of a grid cell (miles).  Queries are fastest when
+ *                  a cell holds a few points.
+ */
+SpatialIndex::SpatialIndex(const float cell_size) : _cell_size(cell_size > 0.0f ? cell_size : 1.0f),
+                                                    _points(),
+                                                    _cells(),
+                                                    _size(0),
+                                                    _min_cx(std::numeric_limits<int32_t>::max()),
+                                                    _max_cx(std::numeric_limits<int32_t>::min()),
+                                                    _min_cy(std::numeric_limits<int32_t>::max()),
+                                                    _max_cy(std::numeric_limits<int32_t>::min())
+{ }
+
+/**
+ * @brief Adds a point, or moves it when already present.
+ *
+ * @param id Point identification.
+ * @param x Position east (miles).
+ * @param y Position north (miles).
+ */
+void SpatialIndex::Insert(const uint32_t id, const float x, const float y)
+{
+    if(id >= _points.size())
+        _points.resize(id + 1, Point { 0.0f, 0.0f, 0, 0, false });
+
+    const int32_t cx = CellOf(x);
+    const int32_t cy = CellOf(y);
+    const int64_t key = Key(cx, cy);
+
+    Point& p = _points[id];
+    if(p.present)
+    {
+        // Moving within its cell only updates the position
+        if(p.cell == key)
+        {
+            p.x = x;
+            p.y = y;
+            return;
+        }
+        Remove(id);
+    }
+
+    std::vector<uint32_t>& cell = _cells[key];
+    p = { x, y, key, uint32_t(cell.size()), true };
+    cell.push_back(id);
+    ++_size;
+
+    _min_cx = std::min(_min_cx, cx);
+    _max_cx = std::max(_max_cx, cx);
+    _min_cy = std::min(_min_cy, cy);
+    _max_cy = std::max(_max_cy, cy);
+}
+
+/**
+ * @brief Removes a point (no-op when not present).
+ *
+ * @param id Point identification.
+ */
+void SpatialIndex::Remove(const uint32_t id)
+{
+    if(!Contains(id))
+        return;
+
+    Point& p = _points[id];
+    std::vector<uint32_t>& cell = _cells[p.cell];
+
+    // Swap with the last point of the cell
+    const uint32_t last = cell.back();
+    cell[p.slot] = last;
+    _points[last].slot = p.slot;
+    cell.pop_back();
+
+    p.present = false;
+    --_size;
+}
+
+/**
+ * @brief Removes every point.
+ *
+ */
+void SpatialIndex::Clear()
+{
+    _points.clear();
+    _cells.clear();
+    _size = 0;
+    _min_cx = _min_cy = std::numeric_limits<int32_t>::max();
+    _max_cx = _max_cy = std::numeric_limits<int32_t>::min();
+}
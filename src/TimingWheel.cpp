@@ -0,0 +1,194 @@
+#include <algorithm>
+
+#include "TimingWheel.h"
+
+/**
+ * @brief Construct a new TimingWheel object.
+ *
+ * @param start_ms Simulation time (ms) the wheel starts at.
+ */
+TimingWheel::TimingWheel(const int64_t start_ms) : _now(start_ms),
+                                                   _size(0),
+                                                   _levels(),
+                                                   _ready(),
+                                                   _overflow(),
+                                                   _scratch()
+{
+    for(auto& level : _levels)
+        level.occupied.fill(0);
+}
+
+/**
+ * @brief Adds an event.
+ *
+ * @param event Event to add.  Events due before the last event popped
+ *              are due immediately.
+ */
+void TimingWheel::Schedule(const ScheduledEvent& event)
+{
+    ScheduledEvent e = event;
+    e.time_ms = std::max(e.time_ms, _now);
+
+    Place(e);
+    ++_size;
+}
+
+/**
+ * @brief Puts an event in the slot of the lowest level spanning it.
+ *
+ * @param event Event to place.
+ */
+void TimingWheel::Place(const ScheduledEvent& event)
+{
+    // The highest bit the event's time differs from now in picks the level,
+    // so an event always sits in the current turn of its level
+    const uint64_t diff = uint64_t(event.time_ms) ^ uint64_t(_now);
+
+    for(int l = 0; l < LEVELS; ++l)
+    {
+        const int shift = l * SLOT_BITS;
+        if(diff < (uint64_t(1) << (shift + SLOT_BITS)))
+        {
+            const size_t slot = (uint64_t(event.time_ms) >> shift) & (SLOTS - 1);
+            _levels[l].slots[slot].push_back(event);
+            _levels[l].occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+            return;
+        }
+    }
+
+    _overflow.push_back(event);
+}
+
+/**
+ * @brief First slot holding events at or after a slot.
+ *
+ * @param level Level to search.
+ * @param from First slot searched.
+ * @return int Slot, -1 when none.
+ */
+int TimingWheel::NextOccupied(const int level, const size_t from) const
+{
+    const std::array<uint64_t, SLOTS / 64>& occupied = _levels[level].occupied;
+
+    for(size_t w = from / 64; w < occupied.size(); ++w)
+    {
+        uint64_t bits = occupied[w];
+        if(w == from / 64)
+            bits &= ~uint64_t(0) << (from % 64);
+        if(bits)
+            return int(w * 64 + __builtin_ctzll(bits));
+    }
+    return -1;
+}
+
+/**
+ * @brief Turns the wheel to the next due events and moves them to the
+ *        ready list, without turning past a time.
+ *
+ * @param until_ms Simulation time (ms) the wheel may turn to.
+ * @return true  Events are ready.
+ * @return false No events due by until_ms.
+ */
+bool TimingWheel::Turn(const int64_t until_ms)
+{
+    if(!_ready.empty())
+        return _now <= until_ms;
+    if(_size == 0)
+        return false;
+
+    for(;;)
+    {
+        // Next ms of the current turn of level 0 with events
+        int slot = NextOccupied(0, uint64_t(_now) & (SLOTS - 1));
+        if(slot >= 0)
+        {
+            const int64_t due = (_now & ~int64_t(SLOTS - 1)) | slot;
+            if(due > until_ms)
+                return false;
+            _now = due;
+
+            std::vector<ScheduledEvent>& events = _levels[0].slots[slot];
+            _ready.insert(_ready.end(), events.begin(), events.end());
+            events.clear();
+            _levels[0].occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+            return true;
+        }
+
+        // Level 0 is empty: turn to the next slot of the lowest level with
+        // events and move its events down
+        bool moved = false;
+        for(int l = 1; l < LEVELS && !moved; ++l)
+        {
+            const int shift = l * SLOT_BITS;
+            slot = NextOccupied(l, ((uint64_t(_now) >> shift) & (SLOTS - 1)) + 1);
+            if(slot < 0)
+                continue;
+
+            // Slots of higher levels start later still, nothing is due
+            const int64_t span  = int64_t(1) << (shift + SLOT_BITS);
+            const int64_t start = (_now & ~(span - 1)) | (int64_t(slot) << shift);
+            if(start > until_ms)
+                return false;
+            _now = start;
+
+            _scratch.swap(_levels[l].slots[slot]);
+            _levels[l].occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+            for(auto const& e : _scratch)
+                Place(e);
+            _scratch.clear();
+            moved = true;
+        }
+
+        // Every level is empty: jump to the earliest overflow event
+        if(!moved)
+        {
+            if(_overflow.empty())
+                return false;
+
+            auto earliest = std::min_element(_overflow.begin(), _overflow.end(), [](const ScheduledEvent& a, const ScheduledEvent& b) {
+                return a.time_ms < b.time_ms;
+            });
+            if(earliest->time_ms > until_ms)
+                return false;
+            _now = earliest->time_ms;
+
+            _scratch.swap(_overflow);
+            for(auto const& e : _scratch)
+                Place(e);
+            _scratch.clear();
+        }
+    }
+}
+
+/**
+ * @brief Removes the earliest event.
+ *
+ * @param event Earliest event.
+ * @return true  An event was popped.
+ * @return false No events pending.
+ */
+bool TimingWheel::Pop(ScheduledEvent& event)
+{
+    return PopDue(event, INT64_MAX);
+}
+
+/**
+ * @brief Removes the earliest event if it is due by a time.  The wheel
+ *        never turns past until_ms, so events due after it can still
+ *        be added.
+ *
+ * @param event Earliest event.
+ * @param until_ms Simulation time (ms) the event must be due by.
+ * @return true  An event was popped.
+ * @return false No events due by until_ms.
+ */
+bool TimingWheel::PopDue(ScheduledEvent& event, const int64_t until_ms)
+{
+    if(!Turn(until_ms))
+        return false;
+
+    event = _ready.front();
+    _ready.pop_front();
+    --_size;
+    return true;
+}
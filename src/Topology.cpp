@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cmath>
+
+#include "SpatialIndex.h"
+#include "Topology.h"
+
+/**
+ * @brief Construct a ring of sites evenly spaced on a circle, with routes
+ *        to the neighbouring site on either side.
+ *
+ * @param num_sites Number of sites.
+ * @param radius_miles Radius (miles) of the circle.
+ */
+Topology::Topology(const uint16_t num_sites, const float radius_miles) : _sites()
+{
+    const uint16_t n = std::max<uint16_t>(num_sites, 1);
+
+    for(uint16_t i = 0; i < n; ++i)
+    {
+        const double angle = 2.0 * M_PI * i / n;
+        _sites.push_back(std::make_unique<Site>(i, radius_miles * std::cos(angle), radius_miles * std::sin(angle)));
+    }
+
+    // A single site has no routes, vehicles land where they took off
+    if(n == 2)
+    {
+        _sites[0]->AddRoute(*_sites[1]);
+        _sites[1]->AddRoute(*_sites[0]);
+    }
+    else if(n > 2)
+    {
+        for(uint16_t i = 0; i < n; ++i)
+        {
+            _sites[i]->AddRoute(*_sites[(i + 1) % n]);
+            _sites[i]->AddRoute(*_sites[(i + n - 1) % n]);
+        }
+    }
+}
+
+/**
+ * @brief Points the sites without chargers at the nearest site with
+ *        chargers, and gives each site with chargers the others to divert
+ *        to, nearest first.  Must be called before the simulation is started.
+ *
+ * @param num_chargers Number of chargers spread over the sites.
+ */
+void Topology::AssignChargingSites(const uint16_t num_chargers)
+{
+    // Sites are a few tens of miles apart, a cell holds about one site
+    SpatialIndex charging(10.0f);
+    std::vector<Site*> chargers;
+    for(uint16_t i = 0; i < num_chargers; ++i)
+    {
+        Site& site = SiteOfCharger(i);
+        if(charging.Contains(site.ID()))
+            continue;
+        charging.Insert(site.ID(), site.X(), site.Y());
+        chargers.push_back(&site);
+    }
+
+    for(Site* site : chargers)
+    {
+        std::vector<Site*> others;
+        for(Site* other : chargers)
+        {
+            if(other != site)
+                others.push_back(other);
+        }
+
+        std::stable_sort(others.begin(), others.end(), [site](const Site* a, const Site* b) {
+            return site->Distance(*a) < site->Distance(*b);
+        });
+        for(Site* other : others)
+            site->AddDivertSite(*other);
+    }
+
+    for(auto const& site : _sites)
+    {
+        int64_t nearest = charging.Nearest(site->X(), site->Y());
+        site->SetChargingSite(nearest < 0 ? *site : *_sites[nearest]);
+    }
+}
+
+/**
+ * @brief Total number of vehicles waiting for a charger at every site,
+ *        read without taking the queues' locks.
+ *
+ * @return size_t Number of vehicles waiting.
+ */
+size_t Topology::QueueLength() const
+{
+    size_t length = 0;
+    for(auto const& site : _sites)
+        length += site->Queue.ApproxSize();
+    return length;
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <thread>
+
+#include "TypeStats.h"
+
+/**
+ * @brief Construct a new TypeStats object.
+ *
+ * @param shards Number of shards, rounded up to a power of 2 (one per
+ *               hardware thread when 0).  CPUs beyond the shards share
+ *               them.
+ */
+TypeStats::TypeStats(size_t shards) : _shards(),
+                                      _types(),
+                                      _types_lock()
+{
+    if(shards == 0)
+        shards = std::max(1u, std::thread::hardware_concurrency());
+
+    size_t n = 1;
+    while(n < shards)
+        n <<= 1;
+
+    for(size_t i = 0; i < n; ++i)
+        _shards.push_back(std::make_unique<Shard>());
+}
+
+/**
+ * @brief Counts a vehicle of a type.  Called once per vehicle created.
+ *
+ * @param type Vehicle type (0 to TYPE_STATS_MAX_TYPES - 1).
+ * @param name Vehicle type name.
+ * @param passenger_miles_per_min Passenger miles per minute cruising.
+ * @param faults_per_min Probability of fault per minute.
+ */
+void TypeStats::AddVehicle(const size_t type, const std::string& name, const double passenger_miles_per_min, const double faults_per_min)
+{
+    std::lock_guard<std::mutex> lock(_types_lock);
+
+    TypeInfo& info = _types.at(type);
+    info.name                    = name;
+    info.passenger_miles_per_min = passenger_miles_per_min;
+    info.faults_per_min          = faults_per_min;
+    ++info.num_vehicles;
+}
+
+/**
+ * @brief Adds time to a total without counting an interval, e.g. the
+ *        totals of vehicles restored from a snapshot.
+ *
+ * @param type Vehicle type.
+ * @param kind What was timed.
+ * @param secs Time (secs) added to the total.
+ */
+void TypeStats::AddTotal(const size_t type, const TypeStatKind kind, const int64_t secs)
+{
+    Local().aggregates[type][kind].total_secs.fetch_add(secs, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Aggregate of a kind for a type, summed over the shards.
+ *
+ * @param type Vehicle type.
+ * @param kind What was timed.
+ * @return TypeStatTotals Aggregate so far.
+ */
+TypeStatTotals TypeStats::Totals(const size_t type, const TypeStatKind kind) const
+{
+    TypeStatTotals totals = { 0, 0, INT64_MAX, 0 };
+
+    for(auto const& shard : _shards)
+    {
+        const Aggregate& a = shard->aggregates.at(type)[kind];
+        totals.count      += a.count.load(std::memory_order_relaxed);
+        totals.total_secs += a.total_secs.load(std::memory_order_relaxed);
+        totals.min_ms      = std::min(totals.min_ms, a.min_ms.load(std::memory_order_relaxed));
+        totals.max_ms      = std::max(totals.max_ms, a.max_ms.load(std::memory_order_relaxed));
+    }
+
+    if(totals.count == 0)
+        totals.min_ms = 0;
+
+    return totals;
+}
+
+/**
+ * @brief Vehicle types with at least one vehicle, ordered by name.
+ *
+ * @return std::vector<std::pair<size_t, TypeInfo>> Each type and its parameters.
+ */
+std::vector<std::pair<size_t, TypeStats::TypeInfo>> TypeStats::Types() const
+{
+    std::lock_guard<std::mutex> lock(_types_lock);
+
+    std::vector<std::pair<size_t, TypeInfo>> types;
+    for(size_t t = 0; t < _types.size(); ++t)
+    {
+        if(_types[t].num_vehicles > 0)
+            types.push_back({ t, _types[t] });
+    }
+
+    std::sort(types.begin(), types.end(), [](const auto& a, const auto& b) { return a.second.name < b.second.name; });
+    return types;
+}
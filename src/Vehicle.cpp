@@ -1,10 +1,19 @@
+#include <algorithm>
+#include <cmath>
 #include <random>
 
 #include "Vehicle.h"
 
+/**
+ * @brief Fraction of the battery kept in reserve by vehicles flying trips.
+ * 
+ */
+constexpr float VEHICLE_RESERVE = 0.2f;
+
 /**
  * @brief Construct a new Vehicle object.
  * 
+ * @param type Type of vehicle.
  * @param n Name of vehicle.
  * @param bc Battery capacity (kWh).
  * @param cs Cruise speed (mph)
@@ -13,9 +22,11 @@
  * @param pof Probability of fault (fault/hr).
  * @param ttc Time to charge (hr)
  * @param id Identification of this vehicle
- * @param chargingQ Vehicle charging queue.
+ * @param site Site the vehicle starts at.
+ * @param context State shared by all objects of the simulation.
  */
-Vehicle::Vehicle(const std::string& n,
+Vehicle::Vehicle(const VehicleType  type,
+                 const std::string& n,
                  const uint16_t     bc,
                  const uint16_t     cs,
                  const uint16_t     pc,
@@ -23,19 +34,35 @@ Vehicle::Vehicle(const std::string& n,
                  const float        pof,
                  const float        ttc,
                  const uint16_t     id,
-                 ChargingQ& chargingQ) : _battery_capacity    (bc),
-                                         _cruise_speed        (cs),
-                                         _energy_use_at_cruise(eac),
-                                         _header("<Vehicle " + n + std::to_string(id) + "> "),
-                                         _id                  (id),
-                                         _name                (n),
-                                         _passenger_count     (pc),
-                                         _prob_of_fault       (pof),
-                                         _time_to_charge      (ttc),
-                                         _charging_q { chargingQ },
-                                         _state(INITIAL)
+                 Site&              site,
+                 SimulationContext& context) : SimulationObject(context),
+                                               _battery_capacity    (bc),
+                                               _cruise_speed        (cs),
+                                               _energy_use_at_cruise(eac),
+                                               _header("<Vehicle " + n + std::to_string(id) + "> "),
+                                               _id                  (id),
+                                               _name                (n),
+                                               _passenger_count     (pc),
+                                               _prob_of_fault       (pof),
+                                               _time_to_charge      (ttc),
+                                               _type                (type),
+                                               _site { &site },
+                                               _energy(bc),
+                                               _leg_mins(0),
+                                               _on_demand(false),
+                                               _queue_full(false),
+                                               _requeue(false),
+                                               _trip_pending(false),
+                                               _trip_origin(nullptr),
+                                               _trip_destination(nullptr),
+                                               _state(INITIAL)
 { 
-
+    // Every interval timed is added to the running statistics of the type
+    TypeStats& stats = context.Stats;
+    stats.AddVehicle(type, n, double(pc) * cs / 60, pof / 60.0);
+    CruisingTime.Attach(stats, type, CRUISE_STAT);
+    ChargingTime.Attach(stats, type, CHARGE_STAT);
+    QingTime.Attach    (stats, type, QING_STAT);
 }
 
 /**
@@ -43,25 +70,27 @@ Vehicle::Vehicle(const std::string& n,
  * 
  * @param type 
  * @param id 
- * @param chargingQ 
+ * @param site 
+ * @param context 
  * @return std::shared_ptr<Vehicle> 
  */
 std::shared_ptr<Vehicle> Vehicle::Create(VehicleType type, 
                                          const uint16_t id,
-                                         ChargingQ& chargingQ)
+                                         Site& site,
+                                         SimulationContext& context)
 {
     switch(type)
     {
         case VehicleType::A:
-            return std::make_shared<Vehicle>("A", 320, 120, 4, 1.6, 0.25, 0.60, id, chargingQ);
+            return std::make_shared<Vehicle>(type, "A", 320, 120, 4, 1.6, 0.25, 0.60, id, site, context);
         case VehicleType::B:
-            return std::make_shared<Vehicle>("B", 100, 100, 5, 1.5, 0.10, 0.20, id, chargingQ);
+            return std::make_shared<Vehicle>(type, "B", 100, 100, 5, 1.5, 0.10, 0.20, id, site, context);
         case VehicleType::C:
-            return std::make_shared<Vehicle>("C", 220, 160, 3, 2.2, 0.05, 0.80, id, chargingQ);
+            return std::make_shared<Vehicle>(type, "C", 220, 160, 3, 2.2, 0.05, 0.80, id, site, context);
         case VehicleType::D:
-            return std::make_shared<Vehicle>("D", 120,  90, 2, 0.8, 0.22, 0.62, id, chargingQ);
+            return std::make_shared<Vehicle>(type, "D", 120,  90, 2, 0.8, 0.22, 0.62, id, site, context);
         case VehicleType::E:
-            return std::make_shared<Vehicle>("E", 150,  30, 2, 5.8, 0.61, 0.30, id, chargingQ);
+            return std::make_shared<Vehicle>(type, "E", 150,  30, 2, 5.8, 0.61, 0.30, id, site, context);
         default:
             return nullptr;
     }
@@ -74,27 +103,62 @@ std::shared_ptr<Vehicle> Vehicle::Create(VehicleType type,
  */
 void Vehicle::ChangeState(VehicleStateType state)
 {
+    if(state == CHARGED)
+        _energy = _battery_capacity;
+
     _state = state;
 }
 
 /**
  * @brief Simulates a vehicle cruising by blocking thread for CruiseTime().
+ *        A restored vehicle only cruises for the remainder of CruiseTime().
+ *        The vehicle flies to the next site on its route, where it then 
+ *        needs charged.  A vehicle flying trips instead flies its trip
+ *        and only needs charged once its battery reaches the reserve.
  * 
  */
 void Vehicle::CruiseAction()
 {
-    int64_t cruise_time = CruiseTime();
+    int64_t cruise_time = _on_demand ? _leg_mins : CruiseTime();
 
-    std::stringstream ss;
-    ss << "Cruising for " << cruise_time << " mins";
-    PrintToConsole(ss);
+    if(Verbose())
+    {
+        std::stringstream ss;
+        ss << "Cruising for " << cruise_time << " mins";
+        PrintToConsole(ss);
+    }
 
-    CruisingTime.Tik();
+    {
+        std::shared_lock<std::shared_mutex> freeze(_context.FreezeLock);
+        if(!CruisingTime.Running())
+        {
+            CruisingTime.Tik();
+            _leg_mins = cruise_time;
+            if(!_on_demand)
+                _site = &_site->Route(_id);
+        }
+    }
 
     // Blocks for desired seconds OR thread exits
-    WaitFor(std::chrono::seconds(cruise_time));
+    bool exited = WaitFor(std::chrono::seconds(cruise_time) - CruisingTime.Elapsed());
+
+    std::shared_lock<std::shared_mutex> freeze(_context.FreezeLock);
+    std::chrono::milliseconds lap = CruisingTime.Tok();
 
-    CruisingTime.Tok();
+    if(_on_demand)
+    {
+        _energy = std::max(0.0f, _energy - FlightEnergy(cruise_time));
+        ChangeState(_energy < VEHICLE_RESERVE * _battery_capacity ? NEEDS_CHARGED : IDLE);
+    }
+    else
+    {
+        _energy = 0.0f;
+        ChangeState(NEEDS_CHARGED);
+    }
+
+    // Flights cut short by the end of the simulation are not recorded
+    if(!exited)
+        CruisingLaps.Record(lap.count());
 }
 
 /**
@@ -118,16 +182,187 @@ int64_t Vehicle::ChargeTime() const
 }
 
 /**
- * @brief Pushes vehicle to charging queue.
+ * @brief Calculates the time to charge the energy used since the last
+ *        charge, converted to simulation time.
+ * 
+ * @return int64_t Time to recharge in seconds.
+ */
+int64_t Vehicle::RechargeTime() const
+{
+    float used = 1.0f - _energy / _battery_capacity;
+
+    // Tolerance keeps a full charge from rounding up past ChargeTime()
+    return std::clamp<int64_t>(ceil(_time_to_charge * 60 * used - 1e-3), 0, ChargeTime());
+}
+
+/**
+ * @brief Calculates the flight time of a trip, including the flight 
+ *        from the vehicle's site to the trip's origin.
+ * 
+ * @param origin Site the trip departs from.
+ * @param destination Site the trip flies to.
+ * @return int64_t Flight time (mins).
+ */
+int64_t Vehicle::TripTime(const Site& origin, const Site& destination) const
+{
+    float miles = _site->Distance(origin) + origin.Distance(destination);
+    return std::max<int64_t>(1, ceil(miles / _cruise_speed * 60));
+}
+
+/**
+ * @brief Calculates the energy used by a flight.
+ * 
+ * @param flight_mins Flight time (mins).
+ * @return float Energy (kWh).
+ */
+float Vehicle::FlightEnergy(const int64_t flight_mins) const
+{
+    return float(flight_mins) / 60 * _cruise_speed * _energy_use_at_cruise;
+}
+
+/**
+ * @brief Assigns a trip to an idle vehicle.  Called by the dispatcher, 
+ *        the vehicle flies the trip the next time it runs.
+ * 
+ * @param origin Site the trip departs from.
+ * @param destination Site the trip flies to.
+ * @return true  Trip was assigned.
+ * @return false Vehicle has not taken its previous trip yet.
+ */
+bool Vehicle::Assign(Site& origin, Site& destination)
+{
+    // Only the dispatcher assigns, only this vehicle takes
+    if(_trip_pending.load(std::memory_order_acquire))
+        return false;
+
+    _trip_origin      = &origin;
+    _trip_destination = &destination;
+    _trip_pending.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Pushes vehicle to charging queue.  When the queue is full the
+ *        vehicle diverts, or waits and is called again, as its site's
+ *        QueueFullPolicy says.
+ * 
+ * @return true  Vehicle is queued.
+ * @return false Queue is full, vehicle is still waiting for room.
+ */
+bool Vehicle::NeedsChargedAction()
+{
+    // A vehicle still waiting for room keeps its queueing start time
+    if(!QingTime.Running())
+    {
+        // Save vehicle queueing start time
+        QingTime.Tik();
+        _queue_full = false;
+
+        // Sites without chargers hand the vehicle on to the nearest site with
+        // chargers (the hop is not flown, its time and energy are ignored)
+        _site = &_site->ChargingSite();
+    }
+
+    // Every charger here is out of service, the nearest site in service 
+    // takes the vehicle (the hop is not flown either)
+    if(_site->Down())
+        _site = &_site->Fallback();
+
+    // A holding vehicle has circled since it arrived, the charger must see
+    // the energy burned before it takes the vehicle
+    const float energy = _energy;
+    if(_queue_full && _site->FullPolicy() == HOLD)
+        _energy = std::max(0.0f, energy - FlightEnergy(QingTime.Elapsed().count() / 1000));
+
+    // Add this vehicle to the charging queue.  A site whose last charger
+    // went out of service since turns the vehicle away to the next site 
+    // in service.  An interrupted vehicle was counted when it arrived
+    for(;;)
+    {
+        if(_site->Join(shared_from_this(), _requeue))
+        {
+            if(!_requeue)
+                _site->CountArrival(Node());
+            _requeue = false;
+            return true;
+        }
+
+        if(!_site->Down() || &_site->Fallback() == _site)
+            break;
+        _site = &_site->Fallback();
+    }
+
+    // Diverting vehicles try the other sites with chargers, nearest first
+    // (the hop is not flown either)
+    Site* full = _site;
+    if(full->FullPolicy() == DIVERT)
+    {
+        for(Site* other : full->DivertSites())
+        {
+            // Moved before joining, a charger there may take it at once
+            _site = other;
+            if(other->Join(shared_from_this()))
+            {
+                full->CountFull(DIVERT);
+                other->CountArrival(Node());
+                return true;
+            }
+        }
+        _site = full;
+    }
+
+    _energy = energy;
+    if(!_queue_full)
+    {
+        full->CountFull(full->FullPolicy() == HOLD ? HOLD : BLOCK);
+        _queue_full = true;
+    }
+    return false;
+}
+
+/**
+ * @brief Adds the energy charged in part of a charge, e.g. one cut short
+ *        by a charger outage.
  * 
+ * @param charged Time (ms) charged, converted to simulation time.
  */
-void Vehicle::NeedsChargedAction()
+void Vehicle::AddCharge(const std::chrono::milliseconds charged)
 {
-    // Save vehicle queueing start time
+    float energy = _energy + _battery_capacity * charged.count() / (_time_to_charge * 60 * 1000);
+    _energy = std::min(energy, float(_battery_capacity));
+}
+
+/**
+ * @brief Hands back a vehicle whose charge was cut short by an outage.
+ *        It needs charged again and rejoins a charging queue in 
+ *        service first in line.  Called by the charger with the 
+ *        FreezeLock held.
+ * 
+ */
+void Vehicle::Requeue()
+{
+    // Queueing time restarts, the flag is seen with the state change
     QingTime.Tik();
+    _requeue = true;
+    ChangeState(NEEDS_CHARGED);
+}
 
-    // Add this vehicle to the charging queue
-    _charging_q.enqueue(shared_from_this());
+/**
+ * @brief Restores the state of this vehicle from a snapshot.  Must be 
+ *        called before the vehicle is started.
+ * 
+ * @param state State of vehicle.
+ * @param site Site of vehicle.
+ * @param energy Energy (kWh) left in the battery.
+ * @param leg_mins Duration (mins) of the current flight.
+ */
+void Vehicle::Restore(VehicleStateType state, Site& site, float energy, int64_t leg_mins)
+{
+    _state    = state;
+    _site     = &site;
+    _energy   = energy;
+    _leg_mins = leg_mins;
+    _requeue  = false;
 }
 
 /**
@@ -211,34 +446,72 @@ void Vehicle::PrintStats()
  */
 void Vehicle::Run()
 {   
-    std::stringstream ss;
-    ss << "Running...";
-    PrintToConsole(ss);
+    if(Verbose())
+    {
+        std::stringstream ss;
+        ss << "Running...";
+        PrintToConsole(ss);
+    }
+    PROFILE_THREAD(Header());
     
-    while(_thread_state != ThreadState::EXIT)
+    while(!StopRequested())
     {
-        // sleep at every iteration to reduce CPU usage
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        // sleep at every iteration to reduce CPU usage (wakes early on stop)
+        if(WaitFor(std::chrono::milliseconds(1)))
+            break;
 
         switch(_state)
         {
             case INITIAL:
+            {
+                PROFILE_SCOPE("Vehicle::Initial");
+                ChangeState(_on_demand ? IDLE : CRUISING);
+                break;
+            }
+
+            case IDLE:
+            {
+                if(!_trip_pending.load(std::memory_order_acquire))
+                    break;
+
+                // Take the assigned trip, the vehicle is then flying to its destination
+                PROFILE_SCOPE("Vehicle::Idle");
+                std::shared_lock<std::shared_mutex> freeze(_context.FreezeLock);
+                _leg_mins = TripTime(*_trip_origin, *_trip_destination);
+                _site = _trip_destination;
+                _trip_pending.store(false, std::memory_order_release);
                 ChangeState(CRUISING);
                 break;
+            }
 
             case NEEDS_CHARGED:
-                NeedsChargedAction();
-                ChangeState(CHARGING);
+            {
+                // Queue full, tries again next iteration without leaving
+                // NEEDS_CHARGED.  Once queued, a charger may already have
+                // taken (or even charged) the vehicle, its state then stands
+                PROFILE_SCOPE("Vehicle::NeedsCharged");
+                std::shared_lock<std::shared_mutex> freeze(_context.FreezeLock);
+                if(NeedsChargedAction())
+                {
+                    VehicleStateType expected = NEEDS_CHARGED;
+                    _state.compare_exchange_strong(expected, CHARGING);
+                }
                 break;
+            }
 
             case CHARGED:
-                ChangeState(CRUISING);
+            {
+                PROFILE_SCOPE("Vehicle::Charged");
+                ChangeState(_on_demand ? IDLE : CRUISING);
                 break;
+            }
 
             case CRUISING:
+            {
+                PROFILE_SCOPE("Vehicle::Cruise");
                 CruiseAction();
-                ChangeState(NEEDS_CHARGED);
                 break;
+            }
             
             case CHARGING:
             default:
@@ -0,0 +1,223 @@
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COHORT_AVX2
+#include <immintrin.h>
+#endif
+
+#include "VehicleCohort.h"
+
+/**
+ * @brief Adds a lane for a vehicle, cruising from time 0.
+ *
+ * @param vehicle Vehicle the lane takes its type parameters from.
+ * @return uint32_t Lane of the vehicle.
+ */
+uint32_t VehicleCohort::Add(const Vehicle& vehicle)
+{
+    return Add(int32_t(vehicle.CruiseTime() * 1000), int32_t(vehicle.ChargeTime() * 1000), vehicle.BatteryCapacity());
+}
+
+/**
+ * @brief Adds a lane, cruising from time 0.
+ *
+ * @param cruise_ms Duration (ms) of a flight.
+ * @param charge_ms Duration (ms) of a charge.
+ * @param capacity Battery capacity (kWh).
+ * @return uint32_t Lane of the vehicle.
+ */
+uint32_t VehicleCohort::Add(const int32_t cruise_ms, const int32_t charge_ms, const float capacity)
+{
+    // Arrays grow a whole block at a time, so kernels never handle a tail
+    if(_size % COHORT_BLOCK == 0)
+    {
+        const size_t n = _size + COHORT_BLOCK;
+        _state.resize(n, COHORT_PAD);
+        _next_ms.resize(n, std::numeric_limits<int32_t>::max());
+        _cruise_ms.resize(n, 0);
+        _charge_ms.resize(n, 0);
+        _cruise_total.resize(n, 0);
+        _charge_total.resize(n, 0);
+        _qing_total.resize(n, 0);
+        _energy.resize(n, 0.0f);
+        _capacity.resize(n, 0.0f);
+    }
+
+    const uint32_t lane = _size++;
+    _state[lane]     = CRUISING;
+    _next_ms[lane]   = cruise_ms;
+    _cruise_ms[lane] = cruise_ms;
+    _charge_ms[lane] = charge_ms;
+    _energy[lane]    = capacity;
+    _capacity[lane]  = capacity;
+    return lane;
+}
+
+/**
+ * @brief Applies every transition due by now_ms, at most one per vehicle:
+ *        flights that ended need charged, charges that ended start the
+ *        next flight.  Vehicles that need charged are appended to
+ *        needs_charged in lane order, to be queued for a charger.
+ *
+ * @param now_ms Simulation time (ms) of the end of the time bucket.
+ * @param needs_charged Lanes that started needing charged.
+ * @return size_t Number of transitions applied.
+ */
+size_t VehicleCohort::Advance(const int32_t now_ms, std::vector<uint32_t>& needs_charged)
+{
+    static const bool avx2 = HasAvx2();
+    return avx2 ? AdvanceAvx2(now_ms, needs_charged) : AdvanceScalar(now_ms, needs_charged);
+}
+
+/**
+ * @brief Advance() with the scalar kernel.
+ *
+ * @param now_ms Simulation time (ms) of the end of the time bucket.
+ * @param needs_charged Lanes that started needing charged.
+ * @return size_t Number of transitions applied.
+ */
+size_t VehicleCohort::AdvanceScalar(const int32_t now_ms, std::vector<uint32_t>& needs_charged)
+{
+    size_t transitions = 0;
+
+    for(uint32_t i = 0; i < _size; ++i)
+    {
+        // All ones when the transition applies, zero otherwise
+        const int32_t due = -int32_t(_next_ms[i] <= now_ms);
+        const int32_t cru = due & -int32_t(_state[i] == CRUISING);
+        const int32_t chg = due & -int32_t(_state[i] == CHARGING);
+
+        _state[i]         = (_state[i] & ~(cru | chg)) | (NEEDS_CHARGED & cru) | (CRUISING & chg);
+        _energy[i]        = cru ? 0.0f : (chg ? _capacity[i] : _energy[i]);
+        _cruise_total[i] += _cruise_ms[i] & cru;
+        _charge_total[i] += _charge_ms[i] & chg;
+        _next_ms[i]      += _cruise_ms[i] & chg;
+
+        if(cru)
+            needs_charged.push_back(i);
+        transitions += (cru | chg) & 1;
+    }
+
+    return transitions;
+}
+
+#ifdef COHORT_AVX2
+
+/**
+ * @brief Advance() with the AVX2 kernel.  Must only be called when
+ *        HasAvx2() is true.
+ *
+ * @param now_ms Simulation time (ms) of the end of the time bucket.
+ * @param needs_charged Lanes that started needing charged.
+ * @return size_t Number of transitions applied.
+ */
+__attribute__((target("avx2")))
+size_t VehicleCohort::AdvanceAvx2(const int32_t now_ms, std::vector<uint32_t>& needs_charged)
+{
+    const __m256i now       = _mm256_set1_epi32(now_ms);
+    const __m256i cruising  = _mm256_set1_epi32(CRUISING);
+    const __m256i charging  = _mm256_set1_epi32(CHARGING);
+    const __m256i needs     = _mm256_set1_epi32(NEEDS_CHARGED);
+    const __m256  zero      = _mm256_setzero_ps();
+
+    size_t transitions = 0;
+
+    for(size_t b = 0; b < _size; b += COHORT_BLOCK)
+    {
+        __m256i state = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&_state[b]));
+        __m256i next  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&_next_ms[b]));
+
+        // next <= now, i.e. not next > now
+        const __m256i due = _mm256_andnot_si256(_mm256_cmpgt_epi32(next, now), _mm256_set1_epi32(-1));
+        const __m256i cru = _mm256_and_si256(due, _mm256_cmpeq_epi32(state, cruising));
+        const __m256i chg = _mm256_and_si256(due, _mm256_cmpeq_epi32(state, charging));
+
+        const int cru_bits = _mm256_movemask_ps(_mm256_castsi256_ps(cru));
+        const int chg_bits = _mm256_movemask_ps(_mm256_castsi256_ps(chg));
+        if((cru_bits | chg_bits) == 0)
+            continue;
+
+        state = _mm256_blendv_epi8(state, needs, cru);
+        state = _mm256_blendv_epi8(state, cruising, chg);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&_state[b]), state);
+
+        __m256 energy = _mm256_loadu_ps(&_energy[b]);
+        energy = _mm256_blendv_ps(energy, zero, _mm256_castsi256_ps(cru));
+        energy = _mm256_blendv_ps(energy, _mm256_loadu_ps(&_capacity[b]), _mm256_castsi256_ps(chg));
+        _mm256_storeu_ps(&_energy[b], energy);
+
+        const __m256i cruise_ms = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&_cruise_ms[b]));
+        const __m256i charge_ms = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&_charge_ms[b]));
+
+        __m256i cruise_total = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&_cruise_total[b]));
+        __m256i charge_total = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&_charge_total[b]));
+        cruise_total = _mm256_add_epi32(cruise_total, _mm256_and_si256(cruise_ms, cru));
+        charge_total = _mm256_add_epi32(charge_total, _mm256_and_si256(charge_ms, chg));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&_cruise_total[b]), cruise_total);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&_charge_total[b]), charge_total);
+
+        next = _mm256_add_epi32(next, _mm256_and_si256(cruise_ms, chg));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&_next_ms[b]), next);
+
+        // Lanes that need charged, lowest first
+        for(int bits = cru_bits; bits; bits &= bits - 1)
+            needs_charged.push_back(uint32_t(b + __builtin_ctz(bits)));
+
+        transitions += __builtin_popcount(cru_bits | chg_bits);
+    }
+
+    return transitions;
+}
+
+/**
+ * @brief Checks to see if the AVX2 kernel can run on this CPU.
+ *
+ * @return true  AVX2 kernel is available.
+ * @return false Only the scalar kernel is available.
+ */
+bool VehicleCohort::HasAvx2()
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+#else
+
+/**
+ * @brief Advance() with the AVX2 kernel.  Not built for this CPU, the
+ *        scalar kernel is used.
+ *
+ * @param now_ms Simulation time (ms) of the end of the time bucket.
+ * @param needs_charged Lanes that started needing charged.
+ * @return size_t Number of transitions applied.
+ */
+size_t VehicleCohort::AdvanceAvx2(const int32_t now_ms, std::vector<uint32_t>& needs_charged)
+{
+    return AdvanceScalar(now_ms, needs_charged);
+}
+
+/**
+ * @brief Checks to see if the AVX2 kernel can run on this CPU.
+ *
+ * @return true  AVX2 kernel is available.
+ * @return false Only the scalar kernel is available.
+ */
+bool VehicleCohort::HasAvx2()
+{
+    return false;
+}
+
+#endif
+
+/**
+ * @brief Starts charging a vehicle that needs charged.  The time since
+ *        its flight ended is counted as queueing.
+ *
+ * @param lane Lane of the vehicle.
+ * @param now_ms Simulation time (ms) the charge starts.
+ */
+void VehicleCohort::StartCharging(const uint32_t lane, const int32_t now_ms)
+{
+    _qing_total[lane] += now_ms - _next_ms[lane];
+    _state[lane]       = CHARGING;
+    _next_ms[lane]     = now_ms + _charge_ms[lane];
+}
@@ -1,11 +1,35 @@
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
+#include "EngineValidation.h"
+#include "Profiler.h"
+#include "Replication.h"
 #include "Simulation.h"
 
 // Example usage:
 //   ./eVTOL_Simulation -v 20 -c 3 -s 180
+//   ./eVTOL_Simulation -v 20 -c 3 -s 180 -k sim.snap -i 30
+//   ./eVTOL_Simulation -r sim.snap -s 60
+//   ./eVTOL_Simulation -v 20 -c 5 -w 60 -s 120     (one run per charger count 1..5)
+//   ./eVTOL_Simulation -v 20 -c 3 -s 180 -t fleet.csv -p 5
+//   ./eVTOL_Simulation -v 20 -c 10 -m                (predict 1..10 chargers, no run)
+//   ./eVTOL_Simulation -v 40 -c 8 -n 4 -s 180        (4 sites, 2 chargers each)
+//   ./eVTOL_Simulation -v 40 -c 8 -n 4 -d 5 -s 180   (fly 5 trip requests/min)
+//   ./eVTOL_Simulation -v 20 -c 3 -s 60 -x 30 -e 0.05 (up to 30 replicas, stop at +/-5%)
+//   ./eVTOL_Simulation -v 2000 -c 200 -n 8 -a -s 60  (pin each site's threads to a NUMA node)
+//   ./eVTOL_Simulation -v 40 -c 4 -n 4 -b 2 -o divert (at most 2 waiting per site, divert when full)
+//   ./eVTOL_Simulation -v 40 -c 8 -n 4 -u 60:10 -s 180  (chargers fail every 60 mins on average, 10 mins to repair)
+//   ./eVTOL_Simulation -v 200 -c 20 -s 60 --quiet     (headless, only the results of each vehicle type)
+//   ./eVTOL_Simulation -v 20 -c 3 -s 60 -f trace.json  (profile, built with -DEVTOL_PROFILE=ON)
+//   ./eVTOL_Simulation -v 20000 -c 3000 -s 1440 -g parallel  (fixed steps of vehicle cohorts, one thread per core)
+//   ./eVTOL_Simulation -v 200 -c 20 -s 1440 -g serial --maintenance 4:60  (faulted vehicles wait for 4 technicians, 60 mins per repair)
+//   ./eVTOL_Simulation -v 20 -c 3 -s 60 --validate     (same seed on every engine, compare with the threaded engine)
+//   ./eVTOL_Simulation -v 200 -c 20 -s 180 -l /evtol_results  (publish live results to shared memory every 100 ms)
 
 int main(int argc, char** argv)
 {   
@@ -13,7 +37,30 @@ int main(int argc, char** argv)
     uint16_t num_vehicles     = 20;
     uint16_t num_vehicleTypes = 5;
     uint16_t num_chargers     = 3;
+    uint16_t num_sites        = 1;
     uint64_t secs             = 180;
+    int64_t  checkpoint_secs  = 60;
+    int64_t  warmup_secs      = 0;
+    int64_t  sample_secs      = 1;
+    std::string checkpoint_path;
+    std::string resume_path;
+    std::string series_path;
+    std::string trace_path;
+    std::string results_name;
+    bool        model_only       = false;
+    bool        numa             = false;
+    bool        quiet            = false;
+    bool        validate         = false;
+    SimulationEngine engine      = SimulationEngine::THREADED;
+    double      trips_per_min    = 0.0;
+    size_t      max_replicas     = 0;
+    double      rel_width        = 0.05;
+    size_t      queue_capacity   = 0;
+    QueueFullPolicy full_policy  = BLOCK;
+    double      mtbf_mins        = 0.0;
+    double      mttr_mins        = 0.0;
+    uint16_t    technicians      = 0;
+    double      repair_mins      = 0.0;
 
     // Simple way to parse command line args
     for(int i = 0; i < argc; ++i)
@@ -34,6 +81,13 @@ int main(int argc, char** argv)
             i++;
         }
 
+        // Number of sites
+        else if(s == "-n")
+        {
+            std::istringstream(argv[i+1]) >> num_sites;
+            i++;
+        }
+
         // Simulation time in seconds
         else if (s == "-s")
         {
@@ -41,11 +95,285 @@ int main(int argc, char** argv)
             i++;
         }
 
+        // Checkpoint file
+        else if (s == "-k")
+        {
+            checkpoint_path = argv[i+1];
+            i++;
+        }
+
+        // Checkpoint interval in seconds
+        else if (s == "-i")
+        {
+            std::istringstream(argv[i+1]) >> checkpoint_secs;
+            i++;
+        }
+
+        // Warm up once, then run a variant for each number of chargers
+        else if (s == "-w")
+        {
+            std::istringstream(argv[i+1]) >> warmup_secs;
+            i++;
+        }
+
+        // Time series file
+        else if (s == "-t")
+        {
+            series_path = argv[i+1];
+            i++;
+        }
+
+        // Sampling interval in seconds
+        else if (s == "-p")
+        {
+            std::istringstream(argv[i+1]) >> sample_secs;
+            i++;
+        }
+
+        // Predict charger sizing analytically without running
+        else if (s == "-m")
+        {
+            model_only = true;
+        }
+
+        // Pin threads to NUMA nodes
+        else if (s == "-a")
+        {
+            numa = true;
+        }
+
+        // Headless, print only the final aggregates
+        else if (s == "-q" || s == "--quiet")
+        {
+            quiet = true;
+        }
+
+        // Engine the fleet runs on
+        else if (s == "-g")
+        {
+            std::string name(argv[i+1]);
+            if(name == "threaded")
+                engine = SimulationEngine::THREADED;
+            else if(name == "serial")
+                engine = SimulationEngine::SERIAL;
+            else if(name == "parallel")
+                engine = SimulationEngine::PARALLEL;
+            else
+            {
+                std::cerr << "Usage: -g threaded|serial|parallel (unknown engine \"" << name << "\")" << std::endl;
+                return 1;
+            }
+            i++;
+        }
+
+        // Run the same scenario on every engine and compare the results
+        else if (s == "--validate")
+        {
+            validate = true;
+        }
+
+        // Fly trip requests instead of full battery flights
+        else if (s == "-d")
+        {
+            std::istringstream(argv[i+1]) >> trips_per_min;
+            i++;
+        }
+
+        // Run independent replicas and report confidence intervals
+        else if (s == "-x")
+        {
+            std::istringstream(argv[i+1]) >> max_replicas;
+            i++;
+        }
+
+        // Target confidence interval half width, relative to the mean
+        else if (s == "-e")
+        {
+            std::istringstream(argv[i+1]) >> rel_width;
+            i++;
+        }
+
+        // Charging queue capacity of each site
+        else if (s == "-b")
+        {
+            std::istringstream(argv[i+1]) >> queue_capacity;
+            i++;
+        }
+
+        // What a vehicle does when its charging queue is full
+        else if (s == "-o")
+        {
+            std::string policy(argv[i+1]);
+            if(policy == "block")
+                full_policy = BLOCK;
+            else if(policy == "divert")
+                full_policy = DIVERT;
+            else if(policy == "hold")
+                full_policy = HOLD;
+            else
+            {
+                std::cerr << "Usage: -o block|divert|hold (unknown policy \"" << policy << "\")" << std::endl;
+                return 1;
+            }
+            i++;
+        }
+
+        // Charger outages, mean time between failures and to repair (mins)
+        else if (s == "-u")
+        {
+            char sep;
+            std::istringstream(argv[i+1]) >> mtbf_mins >> sep >> mttr_mins;
+            i++;
+        }
+
+        // Vehicle maintenance, number of technicians and mean time to repair (mins)
+        else if (s == "--maintenance")
+        {
+            char sep;
+            std::istringstream(argv[i+1]) >> technicians >> sep >> repair_mins;
+            i++;
+        }
+
+        // Shared memory segment live results are published to
+        else if (s == "-l")
+        {
+            results_name = argv[i+1];
+            i++;
+        }
+
+        // Profile trace file (Chrome trace-event JSON)
+        else if (s == "-f")
+        {
+            trace_path = argv[i+1];
+            i++;
+        }
+
+        // Resume from checkpoint file
+        else if (s == "-r")
+        {
+            resume_path = argv[i+1];
+            i++;
+        }
+
+    }
+
+    // Full battery flights land empty, there is no energy left to hold with
+    if(full_policy == HOLD && trips_per_min <= 0.0)
+    {
+        std::cerr << "Usage: -o hold needs trips (-d)" << std::endl;
+        return 1;
+    }
+
+    // Trips, outages, bounded queues, checkpoints, sampling, publishing and
+    // resumed runs are threaded only
+    if(engine != SimulationEngine::THREADED
+       && (trips_per_min > 0.0 || (mtbf_mins > 0.0 && mttr_mins > 0.0) || queue_capacity > 0
+           || !checkpoint_path.empty() || !series_path.empty() || !results_name.empty() || !resume_path.empty()))
+    {
+        std::cerr << "Usage: -d, -u, -b, -k, -t, -l and -r need -g threaded" << std::endl;
+        return 1;
+    }
+
+    // Only the serial engine repairs vehicles, a resumed run is threaded
+    if(technicians > 0 && (engine != SimulationEngine::SERIAL || !resume_path.empty()))
+    {
+        std::cerr << "Usage: --maintenance needs -g serial (and no -r)" << std::endl;
+        return 1;
+    }
+
+    if(model_only)
+    {
+        Simulation sim(num_vehicles, num_vehicleTypes, num_chargers, num_sites);
+        sim.Create();
+        sim.PrintChargerSizing(num_chargers);
+        return 0;
     }
 
-    auto sim = std::make_shared<Simulation>(num_vehicles, num_vehicleTypes, num_chargers);
-    sim->Create();
-    sim->Run(secs);
+    if(validate)
+    {
+        EngineValidation validation(num_vehicles, num_vehicleTypes, num_chargers, num_sites);
+        const bool passed = validation.Run(secs, std::random_device()());
+        validation.PrintResults();
+        return passed ? 0 : 1;
+    }
+
+    if(max_replicas > 0)
+    {
+        Replication replication(num_vehicles, num_vehicleTypes, num_chargers, num_sites, trips_per_min);
+        replication.Run(secs, max_replicas, rel_width, std::max(1u, std::thread::hardware_concurrency()), std::random_device()());
+        replication.PrintStats();
+        return 0;
+    }
+
+    if(warmup_secs > 0)
+    {
+        auto warmup = std::make_shared<Simulation>(num_vehicles, num_vehicleTypes, num_chargers, num_sites);
+        warmup->Create();
+
+        auto base = warmup->Warmup(warmup_secs);
+        for(uint16_t chargers = 1; chargers <= num_chargers; ++chargers)
+            Simulation::Fork(base, chargers)->Run(secs);
+
+        return 0;
+    }
+
+    std::shared_ptr<Simulation> sim;
+    if(!resume_path.empty())
+    {
+        sim = Simulation::Resume(resume_path);
+        if(numa)
+            sim->EnableNuma();
+    }
+    else
+    {
+        sim = std::make_shared<Simulation>(num_vehicles, num_vehicleTypes, num_chargers, num_sites);
+        sim->SelectEngine(engine);
+        if(numa)
+            sim->EnableNuma();
+        if(technicians > 0)
+            sim->EnableMaintenance(technicians, repair_mins);
+        sim->Create();
+    }
+
+    if(quiet)
+        sim->EnableQuiet();
+
+    if(!checkpoint_path.empty())
+        sim->EnableCheckpoints(checkpoint_path, checkpoint_secs);
+
+    if(!series_path.empty())
+        sim->EnableSampling(series_path, sample_secs);
+
+    if(trips_per_min > 0.0)
+        sim->EnableTrips(trips_per_min, 30);
+
+    if(!results_name.empty())
+        sim->EnablePublishing(results_name, 100);
+
+    if(queue_capacity > 0)
+        sim->BoundQueues(queue_capacity, full_policy);
+
+    if(mtbf_mins > 0.0 && mttr_mins > 0.0)
+        sim->EnableOutages(mtbf_mins, mttr_mins);
+
+    try
+    {
+        sim->Run(secs);
+    }
+    catch(const std::logic_error& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if(!trace_path.empty())
+    {
+#ifndef EVTOL_PROFILE
+        std::cout << "Profiling is compiled out, rebuild with -DEVTOL_PROFILE=ON to trace" << std::endl;
+#endif
+        Profiler::Instance().PrintStats();
+        Profiler::Instance().WriteTrace(trace_path);
+    }
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "Charger.h"
+#include "Topology.h"
+#include "Vehicle.h"
+
+class CacheLineTest: public ::testing::Test 
+{ 
+    public: 
+        CacheLineTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~CacheLineTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Cache lines spanned by an object.
+         */
+        template<class T>
+        static std::pair<uintptr_t, uintptr_t> Lines(const T& object)
+        {
+            uintptr_t first = reinterpret_cast<uintptr_t>(&object);
+            return { first / CACHE_LINE_SIZE, (first + sizeof(T) - 1) / CACHE_LINE_SIZE };
+        }
+
+        template<class A, class B>
+        static bool Disjoint(const A& a, const B& b)
+        {
+            auto la = Lines(a), lb = Lines(b);
+            return la.second < lb.first || lb.second < la.first;
+        }
+};
+
+TEST_F (CacheLineTest, VehicleLayout) 
+{ 
+    SimulationContext context;
+    Topology topology(1);
+    auto v = Vehicle::Create(VehicleType::A, 0, topology.At(0), context);
+
+    // Objects start a cache line, so neighbouring objects never share one
+    EXPECT_EQ(0u, alignof(Vehicle) % CACHE_LINE_SIZE);
+    EXPECT_EQ(0u, alignof(Charger) % CACHE_LINE_SIZE);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(v.get()) % CACHE_LINE_SIZE);
+
+    // Fields written by the vehicle thread and by the charger thread
+    EXPECT_TRUE(Disjoint(v->CruisingTime, v->ChargingTime));
+    EXPECT_TRUE(Disjoint(v->CruisingTime, v->QingTime));
+    EXPECT_TRUE(Disjoint(v->CruisingLaps, v->ChargingLaps));
+    EXPECT_TRUE(Disjoint(v->CruisingLaps, v->QingTime));
+    EXPECT_TRUE(Disjoint(v->CruisingLaps, v->QingLaps));
+}
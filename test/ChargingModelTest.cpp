@@ -0,0 +1,78 @@
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "ChargingModel.h"
+
+class ChargingModelTest: public ::testing::Test 
+{ 
+    public: 
+        ChargingModelTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~ChargingModelTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+};
+
+TEST_F (ChargingModelTest, SingleVehicle) 
+{ 
+    ChargingModel model(1);
+    model.AddClass("A", 1, 60, 20);
+
+    // A lone vehicle never waits for a charger
+    ChargingEstimate estimate = model.Solve();
+    ASSERT_EQ(1u, estimate.classes.size());
+    EXPECT_NEAR(0.0,  estimate.classes[0].qing_mins, 1e-6);
+    EXPECT_NEAR(80.0, estimate.classes[0].cycle_mins, 1e-6);
+    EXPECT_NEAR(0.25, estimate.utilization, 1e-6);
+}
+
+TEST_F (ChargingModelTest, Saturated) 
+{ 
+    ChargingModel model(2);
+    model.AddClass("A", 50, 10, 30);
+
+    // Chargers are the bottleneck; throughput is limited to c/S and every
+    // vehicle not charging or cruising is queued
+    ChargingEstimate estimate = model.Solve();
+    EXPECT_NEAR(1.0, estimate.utilization, 1e-3);
+    EXPECT_NEAR(2.0 / 30.0, estimate.classes[0].throughput, 1e-3);
+    EXPECT_NEAR(50.0 - 2.0 - 10.0 * 2.0 / 30.0, estimate.queue_length, 0.5);
+}
+
+TEST_F (ChargingModelTest, MoreChargers) 
+{ 
+    ChargingModel model(1);
+    model.AddClass("A", 10, 40, 20);
+    model.AddClass("B", 10, 60, 40);
+
+    // Queueing time falls and utilization per charger falls as chargers are added
+    ChargingEstimate previous = model.Solve();
+    for(uint16_t chargers = 2; chargers <= 8; ++chargers)
+    {
+        ChargingEstimate estimate = model.WithChargers(chargers).Solve();
+        EXPECT_LT(estimate.classes[0].qing_mins, previous.classes[0].qing_mins);
+        EXPECT_LT(estimate.classes[1].qing_mins, previous.classes[1].qing_mins);
+        EXPECT_LT(estimate.utilization, previous.utilization);
+        previous = estimate;
+    }
+
+    // Vehicles wait for the work ahead of them (FCFS), not their own charge
+    EXPECT_NEAR(previous.classes[0].qing_mins, previous.classes[1].qing_mins, 0.2 * previous.classes[0].qing_mins);
+}
+
+TEST_F (ChargingModelTest, NoChargers) 
+{ 
+    EXPECT_THROW(ChargingModel(0), std::invalid_argument);
+}
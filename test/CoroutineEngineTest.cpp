@@ -0,0 +1,218 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Channel.h"
+#include "CoroutineEngine.h"
+#include "Executor.h"
+#include "Simulation.h"
+
+class CoroutineEngineTest: public ::testing::Test
+{
+    public:
+        CoroutineEngineTest( ) {
+            // initialization code here"
+        }
+
+        void SetUp( ) {
+            // code here will execute just before the test ensues
+        }
+
+        void TearDown( ) {
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~CoroutineEngineTest( )  {
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Process that sleeps for a period n times, logging its name
+         *        and the time each time it wakes.
+         */
+        static Process Ticker(Executor& executor, std::string name, int64_t period_ms, int n, std::vector<std::pair<std::string, int64_t>>& log)
+        {
+            for(int i = 0; i < n; ++i)
+            {
+                co_await executor.Delay(period_ms);
+                log.push_back({ name, executor.Now() });
+            }
+        }
+
+        /**
+         * @brief Process that receives n items, logging each with the time.
+         */
+        static Process Consumer(Executor& executor, Channel<int>& channel, int n, std::vector<std::pair<int, int64_t>>& log)
+        {
+            for(int i = 0; i < n; ++i)
+            {
+                int item = co_await channel.Pop();
+                log.push_back({ item, executor.Now() });
+            }
+        }
+
+        /**
+         * @brief Process that pushes an item each period.
+         */
+        static Process Producer(Executor& executor, Channel<int>& channel, int64_t period_ms, int n)
+        {
+            for(int i = 0; i < n; ++i)
+            {
+                co_await executor.Delay(period_ms);
+                channel.Push(i);
+            }
+        }
+};
+
+TEST_F (CoroutineEngineTest, Executor)
+{
+    Executor executor;
+    std::vector<std::pair<std::string, int64_t>> log;
+
+    executor.Spawn(Ticker(executor, "a", 300, 3, log));
+    executor.Spawn(Ticker(executor, "b", 200, 3, log));
+    EXPECT_EQ(2u, executor.Processes());
+
+    // Runs to a time and stops there, the clock jumps between events
+    executor.Run(500);
+    EXPECT_EQ(500, executor.Now());
+    std::vector<std::pair<std::string, int64_t>> expected = { { "b", 200 }, { "a", 300 }, { "b", 400 } };
+    EXPECT_EQ(expected, log);
+
+    // Ties wake in the order they were scheduled
+    executor.Run(10000);
+    expected.insert(expected.end(), { { "a", 600 }, { "b", 600 }, { "a", 900 } });
+    EXPECT_EQ(expected, log);
+    EXPECT_EQ(0u, executor.Pending());
+}
+
+TEST_F (CoroutineEngineTest, Channel)
+{
+    Executor executor;
+    Channel<int> channel(executor);
+    std::vector<std::pair<int, int64_t>> log;
+
+    // Items pushed before anyone waits are kept in order
+    channel.Push(7);
+    executor.Spawn(Consumer(executor, channel, 3, log));
+    executor.Spawn(Producer(executor, channel, 100, 2));
+    executor.Run(0);
+    EXPECT_EQ(1u, channel.Receivers());
+    EXPECT_EQ(0u, channel.Size());
+
+    // A waiting consumer receives each item when it is pushed
+    executor.Run(1000);
+    std::vector<std::pair<int, int64_t>> expected = { { 7, 0 }, { 0, 100 }, { 1, 200 } };
+    EXPECT_EQ(expected, log);
+    EXPECT_EQ(0u, channel.Receivers());
+}
+
+TEST_F (CoroutineEngineTest, SingleVehicle)
+{
+    SimulationContext context;
+    Site site(0);
+    auto type = Vehicle::Create(VehicleType::A, 0, site, context);
+    const int64_t cycle = type->CruiseTime() + type->ChargeTime();
+
+    CoroutineEngine engine(1, 1, 1);
+    EXPECT_EQ(2u, engine.Create());
+
+    // Two full cycles and a part of a flight, the charger is always free
+    const int64_t secs = 2 * cycle + 1;
+    engine.Run(secs);
+    EXPECT_EQ(secs * 1000, engine.Clock());
+
+    auto metrics = engine.MetricsForEachVehicleType(secs);
+    ASSERT_EQ(1u, metrics.size());
+    EXPECT_EQ(type->Name(), metrics[0].name);
+    EXPECT_EQ(1, metrics[0].num_vehicles);
+    EXPECT_DOUBLE_EQ(2.0 * type->CruiseTime() + 1, metrics[0].cruise_mins);
+    EXPECT_DOUBLE_EQ(2.0 * type->ChargeTime(), metrics[0].charge_mins);
+    EXPECT_DOUBLE_EQ(0.0, metrics[0].qing_mins);
+}
+
+TEST_F (CoroutineEngineTest, Saturated)
+{
+    // Far more vehicles than one charger can keep up with
+    CoroutineEngine engine(50, 5, 1);
+    engine.Seed(4);
+    engine.Create();
+
+    const int64_t secs = 600;
+    engine.Run(secs);
+    EXPECT_GT(engine.QueueLength(), 0u);
+
+    double charge = 0.0;
+    for(auto const& m : engine.MetricsForEachVehicleType(secs))
+    {
+        // Every vehicle is always cruising, queueing or charging
+        EXPECT_NEAR(100.0, m.cruise_pct + m.charge_pct + m.qing_pct, 1e-9);
+        EXPECT_GT(m.qing_mins, 0.0);
+        charge += m.charge_mins * m.num_vehicles;
+    }
+
+    // One charger charges one vehicle at a time
+    EXPECT_LE(charge, double(secs));
+    EXPECT_GT(charge, 0.9 * secs);
+}
+
+TEST_F (CoroutineEngineTest, SameFleet)
+{
+    Simulation sim(40, 5, 4, 2);
+    CoroutineEngine engine(40, 5, 4, 2);
+    sim.Seed(11);
+    engine.Seed(11);
+    sim.Create();
+    engine.Create();
+
+    auto a = sim.MetricsForEachVehicleType(1);
+    auto b = engine.MetricsForEachVehicleType(1);
+    ASSERT_EQ(a.size(), b.size());
+    for(size_t i = 0; i < a.size(); ++i)
+    {
+        EXPECT_EQ(a[i].name, b[i].name);
+        EXPECT_EQ(a[i].num_vehicles, b[i].num_vehicles);
+    }
+}
+
+TEST_F (CoroutineEngineTest, Maintenance)
+{
+    // Same fleet and faults, a few technicians or plenty
+    auto run = [](uint16_t technicians) {
+        auto engine = std::make_unique<CoroutineEngine>(200, 5, 20, 2);
+        engine->Seed(3);
+        engine->EnableMaintenance(technicians, 60.0, 10);
+        engine->Create();
+        engine->Run(24 * 60);
+        return engine;
+    };
+    auto few  = run(1);
+    auto many = run(50);
+
+    // Faulted vehicles are grounded until repaired, one at a time per technician
+    EXPECT_GT(few->Faults(), 0u);
+    EXPECT_LE(few->Repairs() + few->Grounded(), few->Faults());
+    EXPECT_GT(few->MaintenanceQueueLength(), 0u);
+    EXPECT_LE(few->Repairs(), 24u * 60 / 1);
+
+    // Sampled every 10 mins from the start
+    ASSERT_GE(few->Availability().size(), 24u * 6);
+    EXPECT_EQ(0, few->Availability()[0].time_ms);
+    EXPECT_DOUBLE_EQ(1.0, few->Availability()[0].fraction);
+    EXPECT_EQ(10000, few->Availability()[1].time_ms);
+
+    auto mean = [](const CoroutineEngine& engine) {
+        double sum = 0.0;
+        for(auto const& sample : engine.Availability())
+            sum += sample.fraction;
+        return sum / engine.Availability().size();
+    };
+    EXPECT_GT(mean(*many), mean(*few));
+    EXPECT_GT(many->Repairs(), few->Repairs());
+    EXPECT_EQ(0u, many->MaintenanceQueueLength());
+
+    few->PrintMaintenance();
+}
@@ -0,0 +1,160 @@
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Dispatcher.h"
+#include "Simulation.h"
+
+class DispatcherTest: public ::testing::Test 
+{ 
+    public: 
+        DispatcherTest( ) : _topology(4) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~DispatcherTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Adds an idle vehicle flying trips at a site.
+         * 
+         */
+        std::shared_ptr<Vehicle> AddIdleVehicle(uint16_t site)
+        {
+            auto v = Vehicle::Create(VehicleType::A, _vehicles.size(), _topology.At(site), _context);
+            v->EnableTrips();
+            v->Restore(IDLE, _topology.At(site), v->BatteryCapacity(), 0);
+            _vehicles.push_back(v);
+            return v;
+        }
+
+        SimulationContext _context;
+        Topology _topology;
+        std::vector<std::shared_ptr<Vehicle>> _vehicles;
+};
+
+/**
+ * @brief Test Demand::Generate
+ * 
+ */
+TEST_F (DispatcherTest, Demand) 
+{ 
+    Demand demand(_topology, 100.0, 42);
+    demand.SetProfile({ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 });
+
+    // Verify the number of requests follows the rate and every trip leaves its origin
+    std::vector<TripRequest> requests;
+    size_t n = 0;
+    for(int64_t ms = 0; ms < 100000; ms += 1000)
+        n += demand.Generate(ms, ms + 1000, requests);
+
+    EXPECT_EQ(n, requests.size());
+    EXPECT_NEAR(10000.0, double(n), 400.0);
+    for(auto const& r : requests)
+    {
+        EXPECT_NE(r.origin, r.destination);
+        EXPECT_LT(r.destination, 4);
+    }
+}
+
+/**
+ * @brief Test Demand::Rate follows the time of day profile
+ * 
+ */
+TEST_F (DispatcherTest, Profile) 
+{ 
+    Demand demand(_topology, 10.0, 42);
+    std::array<double, DEMAND_HOURS> profile {};
+    profile[8] = 1.0;
+    demand.SetProfile(profile);
+
+    EXPECT_DOUBLE_EQ(240.0, demand.Rate(8 * 60000 + 30000));
+    EXPECT_DOUBLE_EQ(0.0, demand.Rate(9 * 60000));
+    EXPECT_DOUBLE_EQ(240.0, demand.Rate((24 + 8) * 60000));
+}
+
+/**
+ * @brief Test Dispatcher::Dispatch assigns the nearest idle vehicle
+ * 
+ */
+TEST_F (DispatcherTest, Nearest) 
+{ 
+    auto far  = AddIdleVehicle(2);
+    auto near = AddIdleVehicle(1);
+
+    Demand demand(_topology, 0.0, 7);
+    Dispatcher dispatcher(demand, _vehicles, _topology, 30, _context);
+    dispatcher.Prepare(0);
+
+    // Site 1 is a neighbour of site 0, site 2 is across the ring
+    dispatcher.Submit({ 0, 0, 3, 0 });
+    EXPECT_EQ(1u, dispatcher.Dispatch(1000));
+    EXPECT_FALSE(near->Available());
+    EXPECT_TRUE(far->Available());
+
+    // Passenger waits a minute for dispatch plus the flight to the origin
+    float pickup_mins = _topology.At(1).Distance(_topology.At(0)) / near->CruiseSpeed() * 60;
+    EXPECT_NEAR(1000 + pickup_mins * 1000, dispatcher.WaitLaps.Max(), 1);
+
+    // A vehicle can only take one trip until it flies it
+    dispatcher.Submit({ 1, 1, 2, 1000 });
+    dispatcher.Submit({ 2, 1, 2, 1000 });
+    EXPECT_EQ(1u, dispatcher.Dispatch(2000));
+    EXPECT_FALSE(far->Available());
+    EXPECT_EQ(1u, dispatcher.Backlog());
+    EXPECT_EQ(2u, dispatcher.Assigned());
+}
+
+/**
+ * @brief Test Dispatcher::Dispatch loses requests nobody can fly
+ * 
+ */
+TEST_F (DispatcherTest, Lost) 
+{ 
+    auto v = AddIdleVehicle(0);
+    v->Restore(IDLE, _topology.At(0), 1.0f, 0);
+
+    Demand demand(_topology, 0.0, 7);
+    Dispatcher dispatcher(demand, _vehicles, _topology, 5, _context);
+    dispatcher.Prepare(0);
+
+    // The only vehicle does not have the energy to fly the trip
+    dispatcher.Submit({ 0, 0, 2, 0 });
+    EXPECT_EQ(0u, dispatcher.Dispatch(1000));
+    EXPECT_EQ(1u, dispatcher.Backlog());
+
+    // Requests expire once they waited longer than 5 minutes
+    dispatcher.Dispatch(5000);
+    EXPECT_EQ(1u, dispatcher.Backlog());
+    dispatcher.Dispatch(6000);
+    EXPECT_EQ(1u, dispatcher.Lost());
+    EXPECT_EQ(0u, dispatcher.Backlog());
+}
+
+/**
+ * @brief Test vehicles flying trips charge only below the reserve
+ * 
+ */
+TEST_F (DispatcherTest, Trips) 
+{ 
+    Simulation simulation(8, 5, 4, 4);
+    simulation.Create();
+    auto dispatcher = simulation.EnableTrips(600.0, 30);
+    simulation.Run(4);
+
+    // Every request is accounted for
+    EXPECT_GT(dispatcher->Requests(), 0u);
+    EXPECT_GT(dispatcher->Assigned(), 0u);
+    EXPECT_EQ(dispatcher->Requests(), dispatcher->Assigned() + dispatcher->Lost() + dispatcher->Backlog());
+}
@@ -0,0 +1,130 @@
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "CohortEngine.h"
+#include "CoroutineEngine.h"
+#include "EngineValidation.h"
+#include "Simulation.h"
+
+class EngineValidationTest: public ::testing::Test
+{
+    public:
+        EngineValidationTest( ) {
+            // initialization code here"
+        }
+
+        void SetUp( ) {
+            // code here will execute just before the test ensues
+        }
+
+        void TearDown( ) {
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~EngineValidationTest( )  {
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+};
+
+TEST_F (EngineValidationTest, CohortEngine)
+{
+    // Charges start when their charger freed, so the fixed steps give the
+    // same totals as the discrete event engine
+    const int64_t secs = 6 * 60;
+    CohortEngine    cohorts(200, 5, 20, 4, 3);
+    CoroutineEngine events(200, 5, 20, 4);
+    cohorts.Seed(9);
+    events.Seed(9);
+    EXPECT_EQ(200u, cohorts.Create());
+    events.Create();
+    EXPECT_EQ(3u, cohorts.Threads());
+
+    EXPECT_GT(cohorts.Run(secs), 0u);
+    events.Run(secs);
+    EXPECT_EQ(secs * 1000, cohorts.Clock());
+
+    // Times are 32 bit, a run past them is refused before it starts
+    EXPECT_THROW(cohorts.Run(COHORT_ENGINE_MAX_MS / 1000), std::invalid_argument);
+    EXPECT_EQ(secs * 1000, cohorts.Clock());
+    EXPECT_EQ(events.QueueLength(), cohorts.QueueLength());
+
+    auto a = cohorts.MetricsForEachVehicleType(secs);
+    auto b = events.MetricsForEachVehicleType(secs);
+    ASSERT_EQ(b.size(), a.size());
+    for(size_t i = 0; i < a.size(); ++i)
+    {
+        EXPECT_EQ(b[i].name, a[i].name);
+        EXPECT_EQ(b[i].num_vehicles, a[i].num_vehicles);
+        EXPECT_NEAR(b[i].cruise_pct, a[i].cruise_pct, 1e-6);
+        EXPECT_NEAR(b[i].charge_pct, a[i].charge_pct, 1e-6);
+        EXPECT_NEAR(b[i].qing_pct,   a[i].qing_pct,   1e-6);
+        EXPECT_NEAR(100.0, a[i].cruise_pct + a[i].charge_pct + a[i].qing_pct, 1e-6);
+    }
+}
+
+TEST_F (EngineValidationTest, SelectEngine)
+{
+    for(auto engine : { SimulationEngine::SERIAL, SimulationEngine::PARALLEL })
+    {
+        Simulation sim(20, 5, 3);
+        sim.SelectEngine(engine);
+        sim.Seed(5);
+        EXPECT_EQ(engine, sim.Engine());
+        sim.Create();
+        sim.Simulate(180);
+        EXPECT_EQ(180 * 1000, sim.Clock());
+
+        int64_t vehicles = 0;
+        for(auto const& m : sim.MetricsForEachVehicleType(180))
+            vehicles += m.num_vehicles;
+        EXPECT_EQ(20, vehicles);
+    }
+
+    // Features only the threaded engine runs
+    Simulation sim(20, 5, 3);
+    sim.SelectEngine(SimulationEngine::SERIAL);
+    sim.Create();
+    sim.BoundQueues(2, DIVERT);
+    EXPECT_THROW(sim.Simulate(10), std::logic_error);
+
+    // Maintenance only the serial engine runs
+    for(auto engine : { SimulationEngine::THREADED, SimulationEngine::SERIAL, SimulationEngine::PARALLEL })
+    {
+        Simulation grounded(20, 5, 3);
+        grounded.SelectEngine(engine);
+        grounded.EnableQuiet();
+        grounded.EnableMaintenance(2, 60.0);
+        grounded.Create();
+        if(engine == SimulationEngine::SERIAL)
+            EXPECT_NO_THROW(grounded.Simulate(180));
+        else
+            EXPECT_THROW(grounded.Simulate(10), std::logic_error);
+    }
+
+    // Holding without trips, full battery flights land empty
+    Simulation holding(20, 5, 3);
+    holding.Create();
+    holding.BoundQueues(2, HOLD);
+    EXPECT_THROW(holding.Simulate(10), std::logic_error);
+}
+
+TEST_F (EngineValidationTest, Validate)
+{
+    // A short run, the threaded engine is short by up to a minute of each
+    // state (20 % of the run)
+    EngineValidation validation(12, 3, 2);
+    const bool passed = validation.Run(5, 17, 25.0);
+    validation.PrintResults();
+
+    ASSERT_EQ(3u, validation.Results().size());
+    EXPECT_EQ(SimulationEngine::THREADED, validation.Results()[0].engine);
+    EXPECT_DOUBLE_EQ(0.0, validation.Results()[0].max_error_pct);
+    EXPECT_DOUBLE_EQ(1.0, validation.Results()[0].speedup);
+    EXPECT_TRUE(passed);
+
+    // Nothing is within a negative tolerance
+    EXPECT_FALSE(validation.Run(2, 17, -1.0));
+}
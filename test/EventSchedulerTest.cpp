@@ -0,0 +1,151 @@
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "EventScheduler.h"
+#include "TimingWheel.h"
+
+class EventSchedulerTest: public ::testing::Test 
+{ 
+    public: 
+        EventSchedulerTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~EventSchedulerTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Flight and charge durations (ms) of the vehicle types.
+         */
+        static constexpr std::array<int64_t, 8> DURATIONS = { 12000, 20000, 36000, 48000, 60000, 75000, 100000, 120000 };
+
+        /**
+         * @brief Fills a scheduler with pending events, then pops each
+         *        event and schedules the event's next one (hold model).
+         *        Returns a checksum of the order events were popped in.
+         */
+        static uint64_t Hold(EventScheduler& scheduler, size_t pending, size_t holds, uint32_t seed)
+        {
+            std::mt19937 gen(seed);
+            std::uniform_int_distribution<size_t> pick(0, DURATIONS.size() - 1);
+
+            for(size_t i = 0; i < pending; ++i)
+                scheduler.Schedule({ int64_t(DURATIONS[pick(gen)]), uint32_t(i), 0 });
+
+            uint64_t checksum = 0;
+            ScheduledEvent e;
+            for(size_t i = 0; i < holds && scheduler.Pop(e); ++i)
+            {
+                checksum = checksum * 31 + uint64_t(e.time_ms) * 7 + e.target;
+                scheduler.Schedule({ e.time_ms + DURATIONS[pick(gen)], e.target, e.kind + 1 });
+            }
+            return checksum;
+        }
+};
+
+TEST_F (EventSchedulerTest, Order) 
+{ 
+    std::vector<std::unique_ptr<EventScheduler>> schedulers;
+    schedulers.push_back(std::make_unique<HeapScheduler>());
+    schedulers.push_back(std::make_unique<TimingWheel>());
+
+    for(auto& scheduler : schedulers)
+    {
+        ScheduledEvent e;
+        EXPECT_FALSE(scheduler->Pop(e));
+
+        // Times span every level of the wheel and the overflow
+        for(int64_t t : { 70000LL, 5LL, 300LL, 5LL, 20000000LL, 70000LL, 0LL, 10000000000LL })
+            scheduler->Schedule({ t, uint32_t(scheduler->Size()), 0 });
+        EXPECT_EQ(8u, scheduler->Size());
+
+        std::vector<std::pair<int64_t, uint32_t>> popped;
+        while(scheduler->Pop(e))
+            popped.push_back({ e.time_ms, e.target });
+
+        // Ties are popped in the order they were scheduled
+        std::vector<std::pair<int64_t, uint32_t>> expected = {
+            { 0, 6 }, { 5, 1 }, { 5, 3 }, { 300, 2 }, { 70000, 0 }, { 70000, 5 }, { 20000000, 4 }, { 10000000000LL, 7 } };
+        EXPECT_EQ(expected, popped);
+        EXPECT_TRUE(scheduler->Empty());
+    }
+}
+
+TEST_F (EventSchedulerTest, LateEvents) 
+{ 
+    TimingWheel wheel(1000);
+    ScheduledEvent e;
+
+    // Events due before the wheel's time are due immediately
+    wheel.Schedule({ 1500, 0, 0 });
+    wheel.Schedule({ 200, 1, 0 });
+    ASSERT_TRUE(wheel.Pop(e));
+    EXPECT_EQ(1u, e.target);
+    EXPECT_EQ(1000, e.time_ms);
+
+    ASSERT_TRUE(wheel.Pop(e));
+    EXPECT_EQ(1500, wheel.Now());
+
+    // Scheduled at the current time while others are ready
+    wheel.Schedule({ 1500, 2, 0 });
+    wheel.Schedule({ 1501, 3, 0 });
+    ASSERT_TRUE(wheel.Pop(e));
+    EXPECT_EQ(2u, e.target);
+    ASSERT_TRUE(wheel.Pop(e));
+    EXPECT_EQ(3u, e.target);
+}
+
+TEST_F (EventSchedulerTest, PopDue) 
+{ 
+    std::vector<std::unique_ptr<EventScheduler>> schedulers;
+    schedulers.push_back(std::make_unique<HeapScheduler>());
+    schedulers.push_back(std::make_unique<TimingWheel>());
+
+    for(auto& scheduler : schedulers)
+    {
+        ScheduledEvent e;
+        for(int64_t t : { 100LL, 70000LL, 20000000LL })
+            scheduler->Schedule({ t, uint32_t(scheduler->Size()), 0 });
+
+        ASSERT_TRUE(scheduler->PopDue(e, 100));
+        EXPECT_EQ(100, e.time_ms);
+        EXPECT_FALSE(scheduler->PopDue(e, 69999));
+
+        // Events due before those still pending can be added
+        scheduler->Schedule({ 300, 3, 0 });
+        EXPECT_FALSE(scheduler->PopDue(e, 299));
+        ASSERT_TRUE(scheduler->PopDue(e, 70000));
+        EXPECT_EQ(3u, e.target);
+        ASSERT_TRUE(scheduler->PopDue(e, 70000));
+        EXPECT_EQ(1u, e.target);
+        EXPECT_FALSE(scheduler->PopDue(e, 19999999));
+
+        scheduler->Schedule({ 80000, 4, 0 });
+        ASSERT_TRUE(scheduler->PopDue(e, INT64_MAX));
+        EXPECT_EQ(4u, e.target);
+        EXPECT_EQ(1u, scheduler->Size());
+    }
+}
+
+TEST_F (EventSchedulerTest, MatchesHeap) 
+{ 
+    HeapScheduler heap;
+    TimingWheel wheel;
+
+    EXPECT_EQ(Hold(heap, 10000, 200000, 9), Hold(wheel, 10000, 200000, 9));
+    EXPECT_EQ(heap.Size(), wheel.Size());
+}
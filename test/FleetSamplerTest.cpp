@@ -0,0 +1,91 @@
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "Simulation.h"
+
+class FleetSamplerTest: public ::testing::Test 
+{ 
+    public: 
+        FleetSamplerTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~FleetSamplerTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+};
+
+/**
+ * @brief Test FleetSampler::Sample
+ * 
+ */
+TEST_F (FleetSamplerTest, Sample) 
+{ 
+    SimulationContext context;
+    Topology topology(1);
+    std::vector<std::shared_ptr<Vehicle>> vehicles;
+    std::vector<std::shared_ptr<Charger>> chargers;
+
+    for(uint16_t i = 0; i < 4; ++i)
+        vehicles.push_back(Vehicle::Create(VehicleType::A, i, topology.At(0), context));
+    chargers.push_back(std::make_shared<Charger>(0, topology.At(0), context));
+    topology.At(0).Queue.enqueue(vehicles[0]);
+
+    FleetSampler sampler(10, vehicles, chargers, topology, context);
+
+    // Verify columns hold one sample at the start and one per interval
+    sampler.Prepare(20, 0);
+    for(int i = 0; i < 5; ++i)
+        sampler.Sample(i * 10000);
+
+    EXPECT_EQ(3u, sampler.Size());
+    EXPECT_EQ(20000, sampler.TimeMs().back());
+    EXPECT_EQ(1u, sampler.QueueLength()[0]);
+    EXPECT_EQ(0u, sampler.BusyChargers()[0]);
+    EXPECT_EQ(4u, sampler.VehiclesInState(INITIAL)[0]);
+}
+
+/**
+ * @brief Test Simulation::EnableSampling
+ * 
+ */
+TEST_F (FleetSamplerTest, Run) 
+{ 
+    const std::string path = ::testing::TempDir() + "fleet.csv";
+
+    Simulation simulation(10, 5, 3);
+    simulation.Create();
+    auto sampler = simulation.EnableSampling(path, 1);
+    simulation.Run(4);
+
+    // Verify a sample is taken each simulated minute and every vehicle is counted
+    ASSERT_GE(sampler->Size(), 4u);
+    ASSERT_LE(sampler->Size(), 5u);
+    for(size_t i = 0; i < sampler->Size(); ++i)
+    {
+        uint32_t vehicles = 0;
+        for(size_t state = 0; state < FLEET_SAMPLER_STATES; ++state)
+            vehicles += sampler->VehiclesInState(static_cast<VehicleStateType>(state))[i];
+        EXPECT_EQ(10u, vehicles);
+        EXPECT_LE(sampler->BusyChargers()[i], 3u);
+    }
+
+    // Verify the CSV holds a header and one line per sample
+    std::ifstream in(path);
+    std::string line;
+    size_t lines = 0;
+    while(std::getline(in, line))
+        ++lines;
+    EXPECT_EQ(sampler->Size() + 1, lines);
+}
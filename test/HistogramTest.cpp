@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "Histogram.h"
+
+class HistogramTest: public ::testing::Test 
+{ 
+    public: 
+        HistogramTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~HistogramTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        Histogram _h;
+};
+
+TEST_F (HistogramTest, Buckets) 
+{ 
+    // Small values are exact
+    for(int64_t v = 0; v < 16; ++v)
+        EXPECT_EQ(v, Histogram::BucketLowest(Histogram::BucketIndex(v)));
+
+    // Larger values keep 4 bits of precision
+    for(int64_t v : { 17, 100, 1000, 123456, 987654321 })
+    {
+        int64_t lowest = Histogram::BucketLowest(Histogram::BucketIndex(v));
+        EXPECT_LE(lowest, v);
+        EXPECT_LT(v - lowest, v / 16 + 1);
+    }
+
+    EXPECT_EQ(Histogram::NUM_BUCKETS - 1, Histogram::BucketIndex(INT64_MAX));
+}
+
+TEST_F (HistogramTest, Percentile) 
+{ 
+    EXPECT_EQ(0, _h.Percentile(99.0));
+
+    for(int64_t v = 1; v <= 1000; ++v)
+        _h.Record(v);
+
+    EXPECT_EQ(1000, _h.Count());
+    EXPECT_EQ(1, _h.Min());
+    EXPECT_EQ(1000, _h.Max());
+    EXPECT_DOUBLE_EQ(500.5, _h.Mean());
+    EXPECT_NEAR(500, _h.Percentile(50.0), 500 / 16);
+    EXPECT_NEAR(990, _h.Percentile(99.0), 990 / 16);
+    EXPECT_EQ(1000, _h.Percentile(100.0));
+}
+
+TEST_F (HistogramTest, Merge) 
+{ 
+    Histogram other;
+    _h.Record(10);
+    other.Record(5000);
+    other.Record(20);
+
+    _h.Merge(other);
+
+    EXPECT_EQ(3, _h.Count());
+    EXPECT_EQ(10, _h.Min());
+    EXPECT_EQ(5000, _h.Max());
+    EXPECT_EQ(20, _h.Percentile(50.0));
+}
+
+TEST_F (HistogramTest, Sparse) 
+{ 
+    EXPECT_EQ(0u, _h.AllocatedBytes());
+
+    // Values within one power of two share a row of buckets
+    for(int64_t v = 4096; v < 8192; v += 7)
+        _h.Record(v);
+    EXPECT_EQ(16 * sizeof(uint32_t), _h.AllocatedBytes());
+    EXPECT_EQ(0u, _h.BucketCount(Histogram::BucketIndex(100)));
+    EXPECT_GT(_h.BucketCount(Histogram::BucketIndex(5000)), 0u);
+
+    _h.Reset();
+    EXPECT_EQ(0u, _h.AllocatedBytes());
+    EXPECT_EQ(0u, _h.Count());
+}
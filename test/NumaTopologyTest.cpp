@@ -0,0 +1,131 @@
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "NumaTopology.h"
+#include "Simulation.h"
+#include "SimulationThread.h"
+#include "Topology.h"
+#include "Vehicle.h"
+
+class NumaTopologyTest: public ::testing::Test 
+{ 
+    public: 
+        NumaTopologyTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+            root = std::filesystem::temp_directory_path() / "evtol_numa_test";
+            std::filesystem::remove_all(root);
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+            std::filesystem::remove_all(root);
+        }
+
+        ~NumaTopologyTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        void AddNode(const std::string& name, const std::string& cpulist)
+        {
+            std::filesystem::create_directories(root / name);
+            std::ofstream(root / name / "cpulist") << cpulist << "\n";
+        }
+
+        std::filesystem::path root;
+};
+
+TEST_F (NumaTopologyTest, CpuList) 
+{ 
+    EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 8, 10, 11 }), NumaTopology::ParseCpuList("0-3,8,10-11"));
+    EXPECT_TRUE(NumaTopology::ParseCpuList("").empty());
+}
+
+TEST_F (NumaTopologyTest, Nodes) 
+{ 
+    // Two sockets and a memory only node, listed out of order
+    AddNode("node1", "4-7");
+    AddNode("node0", "0-3");
+    AddNode("node2", "");
+    AddNode("possible", "0-2");
+
+    NumaTopology numa(root.string());
+    ASSERT_EQ(2u, numa.Nodes());
+    EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3 }), numa.Cpus(0));
+    EXPECT_EQ(std::vector<int>({ 4, 5, 6, 7 }), numa.Cpus(1));
+}
+
+TEST_F (NumaTopologyTest, SingleNode) 
+{ 
+    // No NUMA information, every CPU is on one node
+    NumaTopology numa(root.string());
+    ASSERT_EQ(1u, numa.Nodes());
+    EXPECT_EQ(std::max(1u, std::thread::hardware_concurrency()), numa.Cpus(0).size());
+
+    // Pinning to the host's first node works on any Linux host
+    NumaTopology host;
+    bool pinned = false;
+    host.RunOn(0, [&]() { pinned = sched_getcpu() >= 0; });
+    EXPECT_TRUE(pinned);
+}
+
+TEST_F (NumaTopologyTest, PinnedBeforeRun) 
+{ 
+    // Affinity of the thread as soon as it runs
+    struct Probe : public SimulationThread
+    {
+        virtual void Run() override { pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus); }
+        cpu_set_t cpus;
+    };
+
+    Probe probe;
+    probe.SetAffinity(0, { 0 });
+    probe.Start();
+    probe.Join();
+
+    EXPECT_EQ(1, CPU_COUNT(&probe.cpus));
+    EXPECT_TRUE(CPU_ISSET(0, &probe.cpus));
+}
+
+TEST_F (NumaTopologyTest, CrossNodeArrivals) 
+{ 
+    SimulationContext context;
+    Topology topology(2);
+    topology.At(1).SetNode(1);
+
+    auto local  = Vehicle::Create(VehicleType::A, 0, topology.At(1), context);
+    auto remote = Vehicle::Create(VehicleType::B, 1, topology.At(1), context);
+    local->SetAffinity(1, { 0 });
+
+    local->NeedsChargedAction();
+    remote->NeedsChargedAction();
+    EXPECT_EQ(1u, topology.At(1).LocalArrivals());
+    EXPECT_EQ(1u, topology.At(1).RemoteArrivals());
+}
+
+TEST_F (NumaTopologyTest, Simulation) 
+{ 
+    // Same fleet with and without NUMA
+    Simulation plain(12, 5, 4, 4);
+    Simulation numa(12, 5, 4, 4);
+    plain.Seed(3);
+    numa.Seed(3);
+    numa.EnableNuma();
+    EXPECT_EQ(16u, plain.Create());
+    EXPECT_EQ(16u, numa.Create());
+
+    auto a = plain.MetricsForEachVehicleType(1);
+    auto b = numa.MetricsForEachVehicleType(1);
+    ASSERT_EQ(a.size(), b.size());
+    for(size_t i = 0; i < a.size(); ++i)
+        EXPECT_EQ(a[i].num_vehicles, b[i].num_vehicles);
+
+    numa.Simulate(1);
+}
@@ -0,0 +1,144 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Profiler.h"
+#include "TLockedQueue.h"
+
+class ProfilerTest: public ::testing::Test
+{
+    public:
+        ProfilerTest( ) {
+            // initialization code here"
+        }
+
+        void SetUp( ) {
+            // code here will execute just before the test ensues
+            Profiler::Instance().Reset();
+        }
+
+        void TearDown( ) {
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+            Profiler::Instance().Reset();
+        }
+
+        ~ProfilerTest( )  {
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Totals of a scope summed over the threads.
+         */
+        static ProfileTotals Sum(const char* name)
+        {
+            ProfileTotals sum { name, "", 0, 0, 0, 0 };
+            for(auto const& thread : Profiler::Instance().Totals())
+            {
+                for(auto const& t : thread)
+                {
+                    if(std::string(t.name) == name)
+                    {
+                        sum.count    += t.count;
+                        sum.total_ns += t.total_ns;
+                        sum.cycles   += t.cycles;
+                    }
+                }
+            }
+            return sum;
+        }
+};
+
+TEST_F (ProfilerTest, Scopes)
+{
+    // Each thread records into its own buffer
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([i]() {
+            Profiler::Instance().NameThread("worker " + std::to_string(i));
+            for(int n = 0; n < 100; ++n)
+            {
+                ProfileScope scope("work", "sim");
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+            }
+        });
+    }
+    for(auto& thread : threads)
+        thread.join();
+
+    ProfileTotals work = Sum("work");
+    EXPECT_EQ(400u, work.count);
+    EXPECT_GE(work.total_ns, 400 * 10000);
+    EXPECT_GT(work.cycles, 0u);
+    EXPECT_EQ(400u, Profiler::Instance().Events());
+
+    // Chrome trace: thread names and a complete event per scope
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "evtol_profiler_test.json";
+    Profiler::Instance().WriteTrace(path.string());
+
+    std::ifstream in(path);
+    std::stringstream trace;
+    trace << in.rdbuf();
+    std::filesystem::remove(path);
+
+    const std::string json = trace.str();
+    EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("\"args\":{\"name\":\"worker 3\"}"));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"work\",\"cat\":\"sim\",\"ph\":\"X\""));
+    EXPECT_EQ("]}\n", json.substr(json.size() - 3));
+}
+
+TEST_F (ProfilerTest, Budget)
+{
+    // The threads share one budget of events, the rest are only counted
+    constexpr size_t THREADS = 4, SCOPES = PROFILER_MAX_EVENTS / 2;
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < THREADS; ++i)
+    {
+        threads.emplace_back([]() {
+            for(size_t n = 0; n < SCOPES; ++n)
+                ProfileScope scope("spent", "sim");
+        });
+    }
+    for(auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(THREADS * SCOPES, Sum("spent").count);
+    EXPECT_EQ(PROFILER_MAX_EVENTS, Profiler::Instance().Events());
+    EXPECT_EQ(THREADS * SCOPES - PROFILER_MAX_EVENTS, Profiler::Instance().Dropped());
+
+    // Reset gives the budget back
+    Profiler::Instance().Reset();
+    {
+        ProfileScope scope("again", "sim");
+    }
+    EXPECT_EQ(1u, Profiler::Instance().Events());
+    EXPECT_EQ(0u, Profiler::Instance().Dropped());
+}
+
+TEST_F (ProfilerTest, Macros)
+{
+    {
+        PROFILE_SCOPE("macro");
+    }
+
+    // Queue locks are only timed when compiled in
+    TLockedQueue<int> q;
+    q.enqueue(1);
+    q.dequeue();
+
+#ifdef EVTOL_PROFILE
+    EXPECT_EQ(1u, Sum("macro").count);
+    EXPECT_EQ(2u, Sum("TLockedQueue::lock").count);
+#else
+    EXPECT_EQ(0u, Sum("macro").count);
+    EXPECT_EQ(0u, Sum("TLockedQueue::lock").count);
+    EXPECT_EQ(0u, Profiler::Instance().Events());
+#endif
+}
@@ -0,0 +1,92 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Replication.h"
+#include "RunningStat.h"
+#include "Simulation.h"
+
+class ReplicationTest: public ::testing::Test 
+{ 
+    public: 
+        ReplicationTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~ReplicationTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+};
+
+TEST_F (ReplicationTest, RunningStat) 
+{ 
+    RunningStat stat;
+    EXPECT_EQ(0u, stat.Count());
+    EXPECT_TRUE(std::isinf(stat.HalfWidth()));
+
+    // Large offset would lose the variance when summing squares
+    std::vector<double> values = { 4.0, 7.0, 13.0, 16.0 };
+    for(double v : values)
+        stat.Add(1e9 + v);
+
+    EXPECT_EQ(4u, stat.Count());
+    EXPECT_DOUBLE_EQ(1e9 + 10.0, stat.Mean());
+    EXPECT_NEAR(30.0, stat.Variance(), 1e-6);
+
+    // t(0.975, 3) * s / sqrt(n)
+    EXPECT_NEAR(3.182 * std::sqrt(30.0) / 2.0, stat.HalfWidth(), 1e-6);
+    EXPECT_DOUBLE_EQ(1.960, RunningStat::TCritical(1000));
+}
+
+TEST_F (ReplicationTest, Seed) 
+{ 
+    // The same seed creates the same fleet
+    Simulation a(30, 5, 3);
+    Simulation b(30, 5, 3);
+    a.Seed(42);
+    b.Seed(42);
+    a.Create();
+    b.Create();
+
+    auto ma = a.MetricsForEachVehicleType(1);
+    auto mb = b.MetricsForEachVehicleType(1);
+    ASSERT_EQ(ma.size(), mb.size());
+    for(size_t i = 0; i < ma.size(); ++i)
+    {
+        EXPECT_EQ(ma[i].name, mb[i].name);
+        EXPECT_EQ(ma[i].num_vehicles, mb[i].num_vehicles);
+    }
+}
+
+TEST_F (ReplicationTest, EarlyStop) 
+{ 
+    // Any interval is narrow enough, so only the minimum is run
+    Replication replication(10, 2, 2);
+    EXPECT_EQ(REPLICATION_MIN_REPLICAS, replication.Run(2, 20, 1e9, 1, 7));
+    EXPECT_TRUE(replication.Converged(1e9));
+
+    for(auto const& [name, m] : replication.Metrics())
+    {
+        EXPECT_EQ(REPLICATION_MIN_REPLICAS, m.cruise_pct.Count());
+        EXPECT_GT(m.cruise_pct.Mean(), 0.0);
+    }
+}
+
+TEST_F (ReplicationTest, MaxReplicas) 
+{ 
+    // No interval is ever narrow enough, replicas run in parallel up to the max
+    Replication replication(10, 2, 2);
+    EXPECT_EQ(4u, replication.Run(2, 4, -1.0, 4, 7));
+    EXPECT_FALSE(replication.Converged(-1.0));
+    EXPECT_EQ(4u, replication.Replicas());
+}
@@ -0,0 +1,161 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "ResultsPublisher.h"
+#include "Simulation.h"
+#include "SimulationContext.h"
+#include "Topology.h"
+#include "Vehicle.h"
+
+class ResultsPublisherTest: public ::testing::Test
+{
+    public:
+        ResultsPublisherTest( ) {
+            // initialization code here"
+        }
+
+        void SetUp( ) {
+            // code here will execute just before the test ensues
+        }
+
+        void TearDown( ) {
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~ResultsPublisherTest( )  {
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Segment name unique to the test process.
+         */
+        static std::string SegmentName(const std::string& test)
+        {
+            return "/evtol_results_test_" + test + "_" + std::to_string(getpid());
+        }
+};
+
+TEST_F (ResultsPublisherTest, Publish)
+{
+    SimulationContext context;
+    Topology topology(1);
+
+    std::vector<std::shared_ptr<Vehicle>> fleet;
+    for(uint16_t i = 0; i < 5; ++i)
+        fleet.push_back(Vehicle::Create(static_cast<VehicleType>(i % 2), i, topology.At(0), context));
+
+    const std::string name = SegmentName("Publish");
+    ResultsPublisher publisher(name, 100, context);
+    publisher.Prepare(0);
+
+    // Nothing published yet
+    ResultsReader reader(name);
+    EXPECT_EQ(0u, reader.Sequence());
+    EXPECT_EQ(0u, reader.Read().publications);
+
+    context.Stats.Record(1, CHARGE_STAT, 2, 2500);
+    publisher.Publish(60000, false);
+    context.Stats.Record(1, CHARGE_STAT, 1, 1500);
+    publisher.Publish(120000, true);
+
+    EXPECT_EQ(4u, reader.Sequence());
+    SharedResults results = reader.Read();
+    EXPECT_EQ(2u, results.publications);
+    EXPECT_EQ(120000, results.clock_ms);
+    EXPECT_EQ(1u, results.done);
+    ASSERT_EQ(2u, results.num_types);
+
+    EXPECT_STREQ("A", results.types[0].name);
+    EXPECT_EQ(3, results.types[0].num_vehicles);
+    EXPECT_STREQ("B", results.types[1].name);
+    EXPECT_EQ(2, results.types[1].num_vehicles);
+
+    TypeStatTotals charge = results.types[1].totals[CHARGE_STAT];
+    EXPECT_EQ(2, charge.count);
+    EXPECT_EQ(3, charge.total_secs);
+    EXPECT_EQ(1500, charge.min_ms);
+    EXPECT_EQ(2500, charge.max_ms);
+    EXPECT_EQ(0, results.types[0].totals[CHARGE_STAT].count);
+
+    // Not a results segment
+    EXPECT_THROW(ResultsReader(SegmentName("Missing")), std::runtime_error);
+
+    // A second publisher does not take the segment over
+    EXPECT_THROW(ResultsPublisher(name, 100, context), std::runtime_error);
+    EXPECT_EQ(4u, reader.Sequence());
+    EXPECT_EQ(2u, reader.Read().publications);
+    EXPECT_NO_THROW(ResultsReader again(name));
+}
+
+TEST_F (ResultsPublisherTest, Consistent)
+{
+    SimulationContext context;
+    const std::string name = SegmentName("Consistent");
+    ResultsPublisher publisher(name, 100, context);
+    publisher.Prepare(0);
+    ResultsReader reader(name);
+
+    // Every copy a reader accepts was written by a single publication
+    constexpr uint64_t PUBLICATIONS = 200000;
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for(uint64_t n = 1; n <= PUBLICATIONS; ++n)
+            publisher.Publish(int64_t(n) * 10, n == PUBLICATIONS);
+        done = true;
+    });
+
+    while(!done)
+    {
+        SharedResults results;
+        if(reader.TryRead(results))
+        {
+            EXPECT_EQ(int64_t(results.publications) * 10, results.clock_ms);
+        }
+    }
+    writer.join();
+
+    // Nothing is being published, the first read is consistent
+    SharedResults results;
+    ASSERT_TRUE(reader.TryRead(results));
+    EXPECT_EQ(PUBLICATIONS, results.publications);
+    EXPECT_EQ(1u, results.done);
+}
+
+TEST_F (ResultsPublisherTest, Simulation)
+{
+    const std::string name = SegmentName("Simulation");
+
+    Simulation sim(20, 5, 3);
+    sim.EnableQuiet();
+    sim.Create();
+    auto publisher = sim.EnablePublishing(name, 100);
+    ResultsReader reader(name);
+
+    sim.Simulate(2);
+
+    // Final totals published once the vehicles stopped
+    SharedResults results = reader.Read();
+    EXPECT_EQ(1u, results.done);
+    EXPECT_GE(results.publications, 20u);
+    EXPECT_NEAR(2000, results.clock_ms, 100);
+    EXPECT_EQ(publisher->Publications(), results.publications);
+
+    int64_t vehicles = 0, cruise_secs = 0;
+    for(uint32_t t = 0; t < results.num_types; ++t)
+    {
+        vehicles    += results.types[t].num_vehicles;
+        cruise_secs += results.types[t].totals[CRUISE_STAT].total_secs;
+    }
+    EXPECT_EQ(20, vehicles);
+    EXPECT_GE(cruise_secs, 20);
+}
@@ -1,5 +1,6 @@
 #include <chrono>
 #include <memory>
+#include <string>
 
 #include <gtest/gtest.h>
 #include "Simulation.h"
@@ -59,4 +60,26 @@ TEST_F (SimulationTest, Run)
     EXPECT_NEAR(10, time_span.count(), 1.00);
 
     delete simulation;
-}
\ No newline at end of file
+}
+/**
+ * @brief Test Simulation::EnableQuiet
+ * 
+ */
+TEST_F (SimulationTest, Quiet) 
+{ 
+    Simulation simulation(10, 5, 3);
+    simulation.Create();
+    simulation.EnableQuiet();
+
+    // Only the results of each vehicle type are printed
+    testing::internal::CaptureStdout();
+    simulation.Run(2);
+    std::string output = testing::internal::GetCapturedStdout();
+
+    EXPECT_EQ(std::string::npos, output.find("Running..."));
+    EXPECT_EQ(std::string::npos, output.find("Cruising for"));
+    EXPECT_EQ(std::string::npos, output.find("<Vehicle"));
+    EXPECT_EQ(std::string::npos, output.find("Calculating statistics"));
+    EXPECT_EQ(std::string::npos, output.find("Simulation ran for"));
+    EXPECT_NE(std::string::npos, output.find("Total Simulation Time: 2 mins"));
+}
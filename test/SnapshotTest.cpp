@@ -0,0 +1,259 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "Simulation.h"
+#include "Snapshot.h"
+
+class SnapshotTest: public ::testing::Test 
+{ 
+    public: 
+        SnapshotTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            _path = testing::TempDir() + "eVTOL_SnapshotTest.snap";
+        }
+
+        void TearDown( ) { 
+            std::remove(_path.c_str());
+        }
+
+        ~SnapshotTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        std::string _path;
+};
+
+/**
+ * @brief Test SnapshotWriter only writes changed records.
+ * 
+ */
+TEST_F (SnapshotTest, IncrementalWrite) 
+{ 
+    Snapshot snapshot(100, 3);
+    SnapshotWriter writer(_path);
+
+    // First write to each slot is the full image
+    EXPECT_EQ(snapshot.Size(), writer.Write(snapshot));
+    EXPECT_EQ(snapshot.Size(), writer.Write(snapshot));
+
+    // Unchanged image only rewrites the header
+    EXPECT_EQ(sizeof(SnapshotHeader), writer.Write(snapshot));
+
+    // One changed vehicle record
+    snapshot.VehicleAt(50).cruising.total_secs = 42;
+    size_t written = writer.Write(snapshot);
+    EXPECT_GT(written, sizeof(SnapshotHeader));
+    EXPECT_LT(written, sizeof(SnapshotHeader) + 2 * sizeof(VehicleRecord) + 64);
+
+    auto loaded = Snapshot::Load(_path);
+    EXPECT_EQ(100, loaded->Header().num_vehicles);
+    EXPECT_EQ(3, loaded->Header().num_chargers);
+    EXPECT_EQ(42, loaded->VehicleAt(50).cruising.total_secs);
+}
+
+/**
+ * @brief Test a write torn by a crash leaves the previous snapshot loadable.
+ * 
+ */
+TEST_F (SnapshotTest, TornWrite) 
+{ 
+    Snapshot snapshot(100, 3);
+    {
+        SnapshotWriter writer(_path);
+        snapshot.VehicleAt(50).cruising.total_secs = 1;
+        writer.Write(snapshot);
+        snapshot.VehicleAt(50).cruising.total_secs = 2;
+        writer.Write(snapshot);
+    }
+    EXPECT_EQ(2, Snapshot::Load(_path)->VehicleAt(50).cruising.total_secs);
+
+    // A new writer keeps the latest snapshot and writes the other slot
+    {
+        SnapshotWriter writer(_path);
+        snapshot.VehicleAt(50).cruising.total_secs = 3;
+        writer.Write(snapshot);
+    }
+    EXPECT_EQ(3, Snapshot::Load(_path)->VehicleAt(50).cruising.total_secs);
+
+    const size_t slot_size = Snapshot::SlotSize(snapshot.Size());
+    const size_t offset    = sizeof(SnapshotHeader) + 50 * sizeof(VehicleRecord);
+    FILE* f = std::fopen(_path.c_str(), "r+b");
+    std::fseek(f, long(slot_size + offset), SEEK_SET);
+    std::fputc(0x7f, f);
+    std::fclose(f);
+
+    // Latest slot torn by a crash, the previous snapshot is loaded
+    EXPECT_EQ(2, Snapshot::Load(_path)->VehicleAt(50).cruising.total_secs);
+
+    // Both slots torn
+    f = std::fopen(_path.c_str(), "r+b");
+    std::fseek(f, long(offset), SEEK_SET);
+    std::fputc(0x7f, f);
+    std::fclose(f);
+    EXPECT_THROW(Snapshot::Load(_path), std::runtime_error);
+}
+
+/**
+ * @brief Test Simulation::Resume rejects counts the simulation can not hold.
+ * 
+ */
+TEST_F (SnapshotTest, ResumeOutOfRange) 
+{ 
+    Snapshot snapshot(70000, 1);
+    snapshot.Header().num_vehicle_types = 5;
+    SnapshotWriter(_path).Write(snapshot);
+
+    EXPECT_EQ(70000u, Snapshot::Load(_path)->Header().num_vehicles);
+    EXPECT_THROW(Simulation::Resume(_path), std::runtime_error);
+}
+
+/**
+ * @brief Test Snapshot::Load rejects files that are not snapshots.
+ * 
+ */
+TEST_F (SnapshotTest, LoadInvalid) 
+{ 
+    FILE* f = std::fopen(_path.c_str(), "w");
+    std::fputs("not a snapshot", f);
+    std::fclose(f);
+
+    EXPECT_THROW(Snapshot::Load(_path), std::runtime_error);
+}
+
+/**
+ * @brief Test Simulation::Resume restores a checkpointed simulation.
+ * 
+ */
+TEST_F (SnapshotTest, Resume) 
+{ 
+    Simulation simulation(6, 5, 2);
+    simulation.Create();
+    simulation.EnableCheckpoints(_path, 1);
+    simulation.Run(2);
+
+    auto saved = Snapshot::Load(_path);
+    EXPECT_GE(saved->Header().clock_ms, 2000);
+
+    auto resumed = Simulation::Resume(_path);
+    auto restored = resumed->Capture();
+
+    EXPECT_EQ(saved->Header().clock_ms, restored->Header().clock_ms);
+    EXPECT_EQ(saved->Header().queue_length, restored->Header().queue_length);
+
+    for(size_t i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(saved->VehicleAt(i).type, restored->VehicleAt(i).type);
+        EXPECT_EQ(saved->VehicleAt(i).state, restored->VehicleAt(i).state);
+        EXPECT_EQ(saved->VehicleAt(i).cruising.total_secs, restored->VehicleAt(i).cruising.total_secs);
+        EXPECT_NEAR(saved->VehicleAt(i).cruising.elapsed_ms, restored->VehicleAt(i).cruising.elapsed_ms, 50);
+    }
+}
+
+/**
+ * @brief Test Simulation::Resume restores vehicles to their sites.
+ * 
+ */
+TEST_F (SnapshotTest, ResumeSites) 
+{ 
+    Simulation simulation(8, 5, 4, 4);
+    simulation.Create();
+    simulation.EnableCheckpoints(_path, 1);
+    simulation.Run(2);
+
+    auto saved = Snapshot::Load(_path);
+    EXPECT_EQ(4u, saved->Header().num_sites);
+
+    auto resumed = Simulation::Resume(_path);
+    auto restored = resumed->Capture();
+
+    EXPECT_EQ(4u, restored->Header().num_sites);
+    for(size_t i = 0; i < 8; ++i)
+        EXPECT_EQ(saved->VehicleAt(i).site, restored->VehicleAt(i).site);
+    for(size_t i = 0; i < 4; ++i)
+        EXPECT_EQ(i, restored->ChargerAt(i).site);
+}
+
+/**
+ * @brief Test Snapshot::Fork shares records until they change.
+ * 
+ */
+TEST_F (SnapshotTest, ForkCopyOnWrite) 
+{ 
+    auto base = std::make_shared<Snapshot>(200, 3);
+    base->VehicleAt(10).cruising.total_secs = 5;
+
+    std::shared_ptr<Snapshot> fork = base->Fork(5);
+    const Snapshot& view = *fork;
+
+    EXPECT_EQ(5, view.Header().num_chargers);
+    EXPECT_EQ(5, view.VehicleAt(10).cruising.total_secs);
+    EXPECT_EQ(-1, view.ChargerAt(4).vehicle_id);
+    EXPECT_EQ(200 * (sizeof(VehicleRecord) + sizeof(uint32_t)), fork->SharedBytes());
+
+    // Unchanged record keeps segment shared
+    VehicleRecord rec = view.VehicleAt(11);
+    EXPECT_FALSE(fork->Set(11, rec));
+    EXPECT_EQ(200 * (sizeof(VehicleRecord) + sizeof(uint32_t)), fork->SharedBytes());
+
+    // Changed record copies only its segment
+    rec.cruising.total_secs = 7;
+    EXPECT_TRUE(fork->Set(11, rec));
+    EXPECT_EQ(136 * sizeof(VehicleRecord) + 200 * sizeof(uint32_t), fork->SharedBytes());
+    EXPECT_EQ(0, static_cast<const Snapshot&>(*base).VehicleAt(11).cruising.total_secs);
+}
+
+/**
+ * @brief Test Simulation::Fork returns vehicles on removed chargers to the queue.
+ * 
+ */
+TEST_F (SnapshotTest, ForkFewerChargers) 
+{ 
+    auto base = std::make_shared<Snapshot>(2, 2);
+    for(uint32_t i = 0; i < 2; ++i)
+    {
+        VehicleRecord& v = base->VehicleAt(i);
+        v.id       = i;
+        v.type     = VehicleType::A;
+        v.state    = VehicleStateType::CHARGING;
+        v.cruising = { 60, -1 };
+        v.charging = { 0, 5000 };
+        v.qing     = { 0, -1 };
+        base->ChargerAt(i) = { uint16_t(i), 0, int32_t(i) };
+    }
+
+    auto variant = Simulation::Fork(base, 1);
+    auto image = variant->Capture();
+
+    EXPECT_EQ(1, image->Header().num_chargers);
+    EXPECT_EQ(0, image->ChargerAt(0).vehicle_id);
+    EXPECT_EQ(1, image->Header().queue_length);
+    EXPECT_EQ(1, image->QueueAt(0));
+    EXPECT_EQ(5, image->VehicleAt(1).charging.total_secs);
+    EXPECT_EQ(-1, image->VehicleAt(1).charging.elapsed_ms);
+}
+
+/**
+ * @brief Test Simulation::Warmup and Simulation::Fork.
+ * 
+ */
+TEST_F (SnapshotTest, WarmupFork) 
+{ 
+    Simulation simulation(6, 5, 2);
+    simulation.Create();
+    auto base = simulation.Warmup(1);
+
+    EXPECT_GE(base->Header().clock_ms, 1000);
+
+    for(unsigned short chargers = 1; chargers <= 3; ++chargers)
+    {
+        auto variant = Simulation::Fork(base, chargers);
+        EXPECT_EQ(6, variant->Capture()->Header().num_vehicles);
+        EXPECT_EQ(chargers, variant->Capture()->Header().num_chargers);
+        EXPECT_EQ(base->Header().clock_ms, variant->Clock());
+    }
+}
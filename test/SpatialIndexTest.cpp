@@ -0,0 +1,144 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SpatialIndex.h"
+
+class SpatialIndexTest: public ::testing::Test 
+{ 
+    public: 
+        SpatialIndexTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~SpatialIndexTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Nearest point found by a linear scan, the reference the
+         *        index is checked against.
+         */
+        static int64_t LinearNearest(const std::vector<std::pair<float, float>>& points,
+                                     const std::vector<bool>&                    present,
+                                     float x, float y)
+        {
+            int64_t best = -1;
+            float best_d2 = std::numeric_limits<float>::max();
+            for(size_t i = 0; i < points.size(); ++i)
+            {
+                if(!present[i])
+                    continue;
+                float d2 = (points[i].first - x) * (points[i].first - x) + (points[i].second - y) * (points[i].second - y);
+                if(d2 < best_d2)
+                {
+                    best_d2 = d2;
+                    best = i;
+                }
+            }
+            return best;
+        }
+};
+
+TEST_F (SpatialIndexTest, Nearest) 
+{ 
+    SpatialIndex index(10.0f);
+    EXPECT_EQ(-1, index.Nearest(0.0f, 0.0f));
+
+    index.Insert(0, 0.0f, 0.0f);
+    index.Insert(1, 25.0f, 0.0f);
+    index.Insert(2, -100.0f, -100.0f);
+    EXPECT_EQ(3u, index.Size());
+
+    EXPECT_EQ(0, index.Nearest(1.0f, 1.0f));
+    EXPECT_EQ(1, index.Nearest(14.0f, 0.0f));
+    EXPECT_EQ(2, index.Nearest(-60.0f, -70.0f));
+
+    // Far outside the occupied cells the search still ends
+    EXPECT_EQ(1, index.Nearest(1000.0f, 0.0f));
+
+    // Predicate skips points
+    EXPECT_EQ(1, index.Nearest(1.0f, 1.0f, [](uint32_t id) { return id != 0; }));
+    EXPECT_EQ(-1, index.Nearest(1.0f, 1.0f, [](uint32_t) { return false; }));
+}
+
+TEST_F (SpatialIndexTest, MoveRemove) 
+{ 
+    SpatialIndex index(10.0f);
+    index.Insert(0, 0.0f, 0.0f);
+    index.Insert(1, 50.0f, 50.0f);
+    index.Insert(2, 55.0f, 50.0f);
+
+    // Moving within a cell and across cells
+    index.Move(0, 2.0f, 2.0f);
+    EXPECT_EQ(0, index.Nearest(3.0f, 3.0f));
+    index.Move(0, 90.0f, 90.0f);
+    EXPECT_EQ(3u, index.Size());
+    EXPECT_EQ(1, index.Nearest(3.0f, 3.0f));
+    EXPECT_EQ(0, index.Nearest(85.0f, 85.0f));
+
+    // Removing a point keeps the rest of its cell
+    index.Remove(1);
+    index.Remove(1);
+    EXPECT_FALSE(index.Contains(1));
+    EXPECT_EQ(2u, index.Size());
+    EXPECT_EQ(2, index.Nearest(50.0f, 50.0f));
+
+    index.Clear();
+    EXPECT_EQ(0u, index.Size());
+    EXPECT_EQ(-1, index.Nearest(50.0f, 50.0f));
+}
+
+TEST_F (SpatialIndexTest, MatchesLinearScan) 
+{ 
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+    std::uniform_int_distribution<size_t> pick(0, 999);
+
+    std::vector<std::pair<float, float>> points(1000);
+    std::vector<bool> present(points.size(), true);
+    SpatialIndex index(5.0f);
+    for(size_t i = 0; i < points.size(); ++i)
+    {
+        points[i] = { pos(gen), pos(gen) };
+        index.Insert(i, points[i].first, points[i].second);
+    }
+
+    for(int n = 0; n < 2000; ++n)
+    {
+        // Points move and come and go as the queries are made
+        size_t i = pick(gen);
+        if(n % 3 == 0)
+        {
+            present[i] = false;
+            index.Remove(i);
+        }
+        else
+        {
+            points[i] = { pos(gen), pos(gen) };
+            present[i] = true;
+            index.Move(i, points[i].first, points[i].second);
+        }
+
+        float x = pos(gen), y = pos(gen);
+        int64_t expected = LinearNearest(points, present, x, y);
+        int64_t found = index.Nearest(x, y);
+        ASSERT_GE(found, 0);
+
+        // Ties may be broken differently, distances must agree
+        auto d = [&](int64_t id) { return std::hypot(points[id].first - x, points[id].second - y); };
+        ASSERT_FLOAT_EQ(d(expected), d(found));
+    }
+}
@@ -0,0 +1,118 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "SimulationThread.h"
+#include "StopToken.h"
+
+class StopTokenTest: public ::testing::Test 
+{ 
+    public: 
+        StopTokenTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~StopTokenTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+};
+
+/**
+ * @brief Thread that blocks until it is stopped.
+ * 
+ */
+class BlockedThread : public SimulationThread
+{
+public:
+    virtual void Run() override
+    {
+        while(!StopRequested())
+            WaitFor(std::chrono::hours(1));
+    }
+};
+
+/**
+ * @brief Test StopSource broadcasts to tokens and callbacks once.
+ * 
+ */
+TEST_F (StopTokenTest, RequestStop) 
+{ 
+    StopSource source;
+    StopToken token = source.Token();
+    int calls = 0;
+
+    StopCallback callback(token, [&calls]() { ++calls; });
+
+    EXPECT_TRUE(token.StopPossible());
+    EXPECT_FALSE(token.StopRequested());
+
+    EXPECT_TRUE(source.RequestStop());
+    EXPECT_FALSE(source.RequestStop());
+
+    EXPECT_TRUE(token.StopRequested());
+    EXPECT_EQ(1, calls);
+
+    // Registered after the stop, invoked immediately
+    StopCallback late(token, [&calls]() { ++calls; });
+    EXPECT_EQ(2, calls);
+
+    EXPECT_FALSE(StopToken().StopPossible());
+}
+
+/**
+ * @brief Test a stop requested on a shared token stops every thread promptly.
+ * 
+ */
+TEST_F (StopTokenTest, BroadcastStop) 
+{ 
+    StopSource shutdown;
+    std::vector<std::unique_ptr<BlockedThread>> threads;
+
+    for(int i = 0; i < 500; ++i)
+    {
+        threads.push_back(std::make_unique<BlockedThread>());
+        threads.back()->Start(shutdown.Token());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    shutdown.RequestStop();
+    for(auto& t : threads)
+        t->Join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed.count(), 0.5);
+
+    for(auto& t : threads)
+        EXPECT_TRUE(t->StopRequested());
+}
+
+/**
+ * @brief Test a thread can still be stopped on its own.
+ * 
+ */
+TEST_F (StopTokenTest, StopOne) 
+{ 
+    StopSource shutdown;
+    BlockedThread a, b;
+
+    a.Start(shutdown.Token());
+    b.Start(shutdown.Token());
+
+    a.Stop();
+    EXPECT_TRUE(a.StopRequested());
+    EXPECT_FALSE(b.StopRequested());
+
+    b.Stop();
+}
@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
 #include "TLockedQueue.h"
 
 class TLockedQTest: public ::testing::Test 
@@ -23,6 +29,16 @@ class TLockedQTest: public ::testing::Test
         }
 
         TLockedQueue<int> _q;
+
+        /**
+         * @brief Item that takes a while to move into the queue.
+         */
+        struct Slow
+        {
+            Slow() = default;
+            Slow(const Slow &) { std::this_thread::sleep_for(std::chrono::milliseconds(50)); }
+            Slow &operator=(const Slow &) = default;
+        };
 };
 
 TEST_F (TLockedQTest, enqueue) 
@@ -44,4 +60,183 @@ TEST_F (TLockedQTest, dequeue)
         _q.dequeue();
 
     EXPECT_EQ(0, _q.Size());
-}
\ No newline at end of file
+}
+TEST_F (TLockedQTest, enqueue_bulk) 
+{ 
+    std::vector<int> items = { 1, 2, 3, 4, 5 };
+
+    EXPECT_EQ(5, _q.enqueue_bulk(items.begin(), items.end()));
+    EXPECT_EQ(0, _q.enqueue_bulk(items.end(), items.end()));
+    EXPECT_EQ(5, _q.Size());
+
+    for(int i : items)
+        EXPECT_EQ(i, _q.dequeue());
+}
+
+TEST_F (TLockedQTest, enqueue_bulk_if) 
+{ 
+    std::vector<int> items = { 1, 2, 3, 4, 5 };
+    auto room = [](size_t size) { return size < 3 ? 3 - size : 0; };
+
+    // Only as many as fit, from the first
+    _q.enqueue(0);
+    EXPECT_EQ(2, _q.enqueue_bulk_if(items.begin(), items.end(), room));
+    EXPECT_EQ(0, _q.enqueue_bulk_if(items.begin() + 2, items.end(), room));
+    EXPECT_EQ(3, _q.Size());
+
+    for(int i = 0; i < 3; ++i)
+        EXPECT_EQ(i, _q.dequeue());
+}
+
+TEST_F (TLockedQTest, try_dequeue_bulk) 
+{ 
+    for(int i = 0; i < 10; ++i)
+        _q.enqueue(i);
+
+    std::vector<int> items;
+    EXPECT_EQ(4, _q.try_dequeue_bulk(std::back_inserter(items), 4));
+    EXPECT_EQ(6, _q.Size());
+    EXPECT_EQ(6, _q.try_dequeue_bulk(std::back_inserter(items), 100));
+    EXPECT_EQ(0, _q.try_dequeue_bulk(std::back_inserter(items), 100));
+
+    ASSERT_EQ(10, items.size());
+    for(int i = 0; i < 10; ++i)
+        EXPECT_EQ(i, items[i]);
+}
+
+TEST_F (TLockedQTest, dequeue_moves) 
+{ 
+    TLockedQueue<std::shared_ptr<int>> q;
+
+    auto item = std::make_shared<int>(7);
+    q.enqueue(item);
+    EXPECT_EQ(2, item.use_count());
+
+    // Moving out leaves no copy behind in the queue
+    auto out = q.dequeue();
+    EXPECT_EQ(2, item.use_count());
+    out.reset();
+    EXPECT_EQ(1, item.use_count());
+
+    std::vector<std::shared_ptr<int>> items = { item, item };
+    q.enqueue_bulk(std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()));
+    EXPECT_EQ(3, item.use_count());
+
+    std::shared_ptr<int> one;
+    EXPECT_TRUE(q.try_dequeue(one));
+    std::vector<std::shared_ptr<int>> rest;
+    EXPECT_EQ(1, q.try_dequeue_bulk(std::back_inserter(rest), 10));
+    EXPECT_EQ(3, item.use_count());
+}
+
+TEST_F (TLockedQTest, try_enqueue) 
+{ 
+    EXPECT_TRUE(_q.try_enqueue(1, 2));
+    EXPECT_TRUE(_q.try_enqueue(2, 2));
+    EXPECT_FALSE(_q.try_enqueue(3, 2));
+    EXPECT_EQ(2, _q.Size());
+
+    // Room again once an item is popped
+    EXPECT_EQ(1, _q.dequeue());
+    EXPECT_TRUE(_q.try_enqueue(3, 2));
+    EXPECT_EQ(2, _q.dequeue());
+    EXPECT_EQ(3, _q.dequeue());
+}
+
+TEST_F (TLockedQTest, enqueue_front) 
+{ 
+    _q.enqueue(1);
+    _q.enqueue(2);
+
+    // A requeued item is next in line
+    _q.enqueue_front(0);
+    EXPECT_EQ(3, _q.Size());
+    EXPECT_EQ(0, _q.dequeue());
+    EXPECT_EQ(1, _q.dequeue());
+    EXPECT_EQ(2, _q.dequeue());
+}
+
+TEST_F (TLockedQTest, lock_stats) 
+{ 
+    // Counting is off by default and takes no space
+    static_assert(std::is_empty_v<NoLockStats>);
+    _q.enqueue(1);
+    EXPECT_EQ(0u, _q.LockTotals().acquisitions);
+
+    TLockedQueue<int, LockContentionStats> q;
+    q.enqueue(1);
+    EXPECT_EQ(1, q.dequeue());
+    EXPECT_EQ(2u, q.LockTotals().acquisitions);
+    EXPECT_EQ(0u, q.LockTotals().wakeups);
+
+    // A waiting consumer is woken by the condition variable
+    std::thread consumer([&q]() { q.dequeue(); });
+    while(q.LockTotals().acquisitions < 3)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    q.enqueue(2);
+    consumer.join();
+    EXPECT_GE(q.LockTotals().wakeups, 1u);
+    EXPECT_LE(q.LockTotals().spurious_wakeups, q.LockTotals().wakeups - 1);
+
+    // A thread finding the lock held by a slow push waits for it
+    TLockedQueue<Slow, LockContentionStats> slow;
+    std::thread producer([&slow]() { slow.enqueue(Slow()); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(1u, slow.Size());
+    producer.join();
+
+    LockStatsTotals t = slow.LockTotals();
+    EXPECT_EQ(2u, t.acquisitions);
+    EXPECT_EQ(1u, t.contended);
+    EXPECT_EQ(t.total_wait_ns, t.max_wait_ns);
+    EXPECT_GT(t.max_wait_ns, 10000000);
+}
+
+TEST_F (TLockedQTest, enqueue_bulk_wakes) 
+{ 
+    TLockedQueue<int, LockContentionStats> q;
+
+    // Two items wake two of the four waiting consumers, none finds nothing
+    std::vector<std::thread> consumers;
+    for(int i = 0; i < 4; ++i)
+        consumers.emplace_back([&q]() { q.dequeue(); });
+    while(q.LockTotals().acquisitions < 4)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    std::vector<int> items = { 1, 2 };
+    q.enqueue_bulk(items.begin(), items.end());
+    while(q.LockTotals().wakeups < 2)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(2u, q.LockTotals().wakeups);
+    EXPECT_EQ(0u, q.LockTotals().spurious_wakeups);
+
+    q.enqueue_bulk(items.begin(), items.end());
+    for(auto& consumer : consumers)
+        consumer.join();
+    EXPECT_TRUE(q.Empty());
+}
+
+TEST_F (TLockedQTest, ApproxSize) 
+{ 
+    TLockedQueue<int, LockContentionStats> q;
+    q.enqueue(1);
+    q.enqueue_front(0);
+    std::vector<int> items = { 2, 3 };
+    q.enqueue_bulk(items.begin(), items.end());
+    EXPECT_EQ(4u, q.ApproxSize());
+
+    int item;
+    EXPECT_TRUE(q.try_dequeue(item));
+    EXPECT_EQ(3u, q.ApproxSize());
+    std::vector<int> out;
+    EXPECT_EQ(2u, q.try_dequeue_bulk(std::back_inserter(out), 2));
+    EXPECT_EQ(1u, q.ApproxSize());
+
+    // Reading the size does not take the lock
+    const uint64_t acquisitions = q.LockTotals().acquisitions;
+    EXPECT_EQ(1u, q.ApproxSize());
+    EXPECT_EQ(acquisitions, q.LockTotals().acquisitions);
+}
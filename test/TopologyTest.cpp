@@ -0,0 +1,342 @@
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Charger.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "Topology.h"
+#include "Vehicle.h"
+
+class TopologyTest: public ::testing::Test 
+{ 
+    public: 
+        TopologyTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~TopologyTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+};
+
+TEST_F (TopologyTest, Ring) 
+{ 
+    Topology topology(4, 10.0f);
+    ASSERT_EQ(4u, topology.Size());
+
+    // Sites are evenly spaced on the circle
+    EXPECT_NEAR(10.0f * std::sqrt(2.0f), topology.At(0).Distance(topology.At(1)), 1e-4);
+    EXPECT_NEAR(20.0f, topology.At(0).Distance(topology.At(2)), 1e-4);
+
+    // Vehicles fly to a neighbouring site, always the same one from a site
+    EXPECT_EQ(1, topology.At(0).Route(0).ID());
+    EXPECT_EQ(3, topology.At(0).Route(1).ID());
+    EXPECT_EQ(1, topology.At(0).Route(2).ID());
+    EXPECT_EQ(0, topology.At(3).Route(0).ID());
+
+    // Chargers and vehicles are spread over the sites
+    EXPECT_EQ(1, topology.SiteOfCharger(5).ID());
+    EXPECT_EQ(2, topology.SiteOfVehicle(6).ID());
+}
+
+TEST_F (TopologyTest, SingleSite) 
+{ 
+    Topology topology(1);
+
+    // Vehicles land where they took off
+    EXPECT_EQ(&topology.At(0), &topology.At(0).Route(7));
+    EXPECT_EQ(&topology.At(0), &topology.SiteOfCharger(3));
+}
+
+TEST_F (TopologyTest, SiteQueues) 
+{ 
+    SimulationContext context;
+    Topology topology(2);
+
+    auto v0 = Vehicle::Create(VehicleType::A, 0, topology.SiteOfVehicle(0), context);
+    auto v1 = Vehicle::Create(VehicleType::B, 1, topology.SiteOfVehicle(1), context);
+
+    // Each vehicle queues at the site it is at
+    v0->NeedsChargedAction();
+    v1->NeedsChargedAction();
+    EXPECT_EQ(1u, topology.At(0).Queue.Size());
+    EXPECT_EQ(1u, topology.At(1).Queue.Size());
+    EXPECT_EQ(2u, topology.QueueLength());
+
+    // A charger only takes vehicles from its own site
+    std::shared_ptr<Vehicle> v;
+    Charger charger(1, topology.SiteOfCharger(1), context);
+    ASSERT_TRUE(charger.Location().Queue.try_dequeue(v));
+    EXPECT_EQ(1, v->ID());
+    EXPECT_EQ(1u, topology.At(0).Queue.Size());
+}
+
+TEST_F (TopologyTest, ChargingSites) 
+{ 
+    SimulationContext context;
+    Topology topology(6, 10.0f);
+
+    // Before chargers are assigned every site charges its own vehicles
+    EXPECT_EQ(&topology.At(4), &topology.At(4).ChargingSite());
+
+    // Two chargers are installed at sites 0 and 1 only
+    topology.AssignChargingSites(2);
+    EXPECT_EQ(&topology.At(0), &topology.At(0).ChargingSite());
+    EXPECT_EQ(&topology.At(1), &topology.At(1).ChargingSite());
+    EXPECT_EQ(&topology.At(1), &topology.At(2).ChargingSite());
+    EXPECT_EQ(&topology.At(0), &topology.At(5).ChargingSite());
+
+    // A vehicle landing at a site without chargers queues at the nearest one
+    auto v = Vehicle::Create(VehicleType::A, 2, topology.SiteOfVehicle(2), context);
+    v->NeedsChargedAction();
+    EXPECT_EQ(0u, topology.At(2).Queue.Size());
+    EXPECT_EQ(1u, topology.At(1).Queue.Size());
+    EXPECT_EQ(&topology.At(1), &v->Location());
+}
+
+TEST_F (TopologyTest, BoundedQueues) 
+{ 
+    SimulationContext context;
+    Topology topology(4, 10.0f);
+    topology.AssignChargingSites(4);
+
+    // Site 0 diverts to its neighbours before the site across the ring
+    ASSERT_EQ(3u, topology.At(0).DivertSites().size());
+    EXPECT_EQ(2, topology.At(0).DivertSites()[2]->ID());
+
+    for(size_t s = 0; s < topology.Size(); ++s)
+        topology.At(s).SetQueueCapacity(1, s == 0 ? DIVERT : BLOCK);
+
+    std::vector<std::shared_ptr<Vehicle>> v;
+    for(uint16_t i = 0; i < 6; ++i)
+        v.push_back(Vehicle::Create(VehicleType::A, i, topology.At(0), context));
+
+    // One waits at site 0, the next three divert to the others in turn
+    for(size_t i = 0; i < 4; ++i)
+        EXPECT_TRUE(v[i]->NeedsChargedAction());
+    EXPECT_EQ(3u, topology.At(0).Diverted());
+    EXPECT_EQ(&topology.At(2), &v[3]->Location());
+    EXPECT_EQ(4u, topology.QueueLength());
+
+    // Every queue is full, the vehicle waits and is counted once
+    EXPECT_FALSE(v[4]->NeedsChargedAction());
+    EXPECT_FALSE(v[4]->NeedsChargedAction());
+    EXPECT_EQ(1u, topology.At(0).Blocked());
+    EXPECT_EQ(&topology.At(0), &v[4]->Location());
+
+    std::shared_ptr<Vehicle> out;
+    ASSERT_TRUE(topology.At(0).Queue.try_dequeue(out));
+    EXPECT_TRUE(v[4]->NeedsChargedAction());
+
+    // A holding vehicle burns energy while it circles
+    topology.At(1).SetQueueCapacity(1, HOLD);
+    auto held = Vehicle::Create(VehicleType::A, 6, topology.At(1), context);
+    const float full = held->Energy();
+    EXPECT_FALSE(held->NeedsChargedAction());
+    EXPECT_EQ(1u, topology.At(1).Held());
+    EXPECT_EQ(full, held->Energy());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    ASSERT_TRUE(topology.At(1).Queue.try_dequeue(out));
+    EXPECT_TRUE(held->NeedsChargedAction());
+    EXPECT_NEAR(full - held->FlightEnergy(1), held->Energy(), 1e-3);
+}
+
+TEST_F (TopologyTest, BlockedNeverCharging) 
+{ 
+    SimulationContext context;
+    Topology topology(1);
+    topology.AssignChargingSites(1);
+    topology.At(0).SetQueueCapacity(1, BLOCK);
+
+    auto waiting = Vehicle::Create(VehicleType::A, 0, topology.At(0), context);
+    EXPECT_TRUE(waiting->NeedsChargedAction());
+
+    // The queue is full, the vehicle retries every iteration without ever
+    // being CHARGING
+    auto blocked = Vehicle::Create(VehicleType::A, 1, topology.At(0), context);
+    blocked->Restore(NEEDS_CHARGED, topology.At(0), 0.0f, 0);
+    blocked->Start();
+
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while(std::chrono::steady_clock::now() < end)
+        ASSERT_EQ(NEEDS_CHARGED, blocked->State());
+
+    // Room in the queue, the vehicle is queued and CHARGING
+    std::shared_ptr<Vehicle> out;
+    ASSERT_TRUE(topology.At(0).Queue.try_dequeue(out));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    blocked->Stop();
+    EXPECT_EQ(CHARGING, blocked->State());
+    EXPECT_EQ(1u, topology.At(0).Queue.Size());
+}
+
+TEST_F (TopologyTest, BlockedQueueingRecorded) 
+{ 
+    // Three vehicles need charged at a site with one charger and room for
+    // one to wait, the third waits outside the queue
+    auto base = std::make_shared<Snapshot>(3, 1);
+    for(uint32_t i = 0; i < 3; ++i)
+    {
+        VehicleRecord& v = base->VehicleAt(i);
+        v.id       = i;
+        v.type     = VehicleType::A;
+        v.state    = VehicleStateType::NEEDS_CHARGED;
+        v.cruising = { 60, -1 };
+        v.charging = { 0, -1 };
+        v.qing     = { 0, -1 };
+    }
+    base->ChargerAt(0) = { 0, 0, -1 };
+
+    auto sim = Simulation::Fork(base, 1);
+    sim->EnableQuiet();
+    sim->BoundQueues(1, BLOCK);
+    sim->Simulate(2);
+
+    // Every wait is recorded when the run stops, queued or not
+    auto image = sim->Capture();
+    int64_t qing_secs = 0;
+    for(uint32_t i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(-1, image->VehicleAt(i).qing.elapsed_ms);
+        qing_secs += image->VehicleAt(i).qing.total_secs;
+    }
+    EXPECT_GE(qing_secs, 2);
+}
+
+TEST_F (TopologyTest, ChargerOutage) 
+{ 
+    SimulationContext context;
+    Topology topology(2, 10.0f);
+    topology.AssignChargingSites(2);
+
+    Charger c0(0, topology.SiteOfCharger(0), context);
+    Charger c1(1, topology.SiteOfCharger(1), context);
+    EXPECT_EQ(1, topology.At(0).ChargersUp());
+    EXPECT_FALSE(topology.At(0).Down());
+
+    // Two empty vehicles wait at site 0, its only charger fails after a minute
+    std::vector<std::shared_ptr<Vehicle>> v;
+    for(uint16_t i = 0; i < 3; ++i)
+    {
+        v.push_back(Vehicle::Create(VehicleType::A, i, topology.At(0), context));
+        v[i]->Restore(CHARGING, topology.At(0), 0.0f, 0);
+    }
+    EXPECT_TRUE(v[0]->NeedsChargedAction());
+    EXPECT_TRUE(v[1]->NeedsChargedAction());
+
+    c0.ScheduleOutage(1, 5);
+    c0.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+
+    // The vehicle in charge keeps its partial charge and needs charged 
+    // again, the waiting vehicle moves to site 1
+    EXPECT_TRUE(c0.Down());
+    EXPECT_TRUE(topology.At(0).Down());
+    EXPECT_EQ(1u, c0.Interrupted());
+    EXPECT_EQ(1u, topology.At(0).Redistributed());
+    EXPECT_EQ(0u, topology.At(0).Queue.Size());
+    EXPECT_EQ(NEEDS_CHARGED, v[0]->State());
+    EXPECT_GT(v[0]->Energy(), 0.0f);
+    EXPECT_TRUE(v[0]->QingTime.Running());
+
+    // It rejoins at site 1 first in line, full or not
+    topology.At(1).SetQueueCapacity(1, BLOCK);
+    EXPECT_TRUE(v[0]->NeedsChargedAction());
+    EXPECT_EQ(&topology.At(1), &v[0]->Location());
+    EXPECT_EQ(2u, topology.At(1).Queue.Size());
+    topology.At(1).SetQueueCapacity(0, BLOCK);
+
+    // Arrivals go to the site in service while it is down
+    EXPECT_TRUE(v[2]->NeedsChargedAction());
+    EXPECT_EQ(&topology.At(1), &v[2]->Location());
+
+    std::shared_ptr<Vehicle> out;
+    ASSERT_TRUE(topology.At(1).Queue.try_dequeue(out));
+    EXPECT_EQ(0, out->ID());
+    ASSERT_TRUE(topology.At(1).Queue.try_dequeue(out));
+    EXPECT_EQ(1, out->ID());
+    ASSERT_TRUE(topology.At(1).Queue.try_dequeue(out));
+    EXPECT_EQ(2, out->ID());
+
+    // Back in service when stopped, the cut short outage is not recorded
+    c0.Stop();
+    EXPECT_EQ(1, topology.At(0).ChargersUp());
+    EXPECT_EQ(0u, c0.OutageLaps.Count());
+}
+
+TEST_F (TopologyTest, RedistributeFull) 
+{ 
+    SimulationContext context;
+    Topology topology(2, 10.0f);
+    topology.AssignChargingSites(2);
+
+    Charger c0(0, topology.SiteOfCharger(0), context);
+    Charger c1(1, topology.SiteOfCharger(1), context);
+    topology.At(1).SetQueueCapacity(1, BLOCK);
+
+    // Three empty vehicles wait at site 0, site 1 has room for one
+    std::vector<std::shared_ptr<Vehicle>> v;
+    for(uint16_t i = 0; i < 4; ++i)
+    {
+        v.push_back(Vehicle::Create(VehicleType::A, i, topology.At(0), context));
+        v[i]->Restore(CHARGING, topology.At(0), 0.0f, 0);
+        EXPECT_TRUE(v[i]->NeedsChargedAction());
+    }
+
+    c0.ScheduleOutage(1, 5);
+    c0.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+
+    // One moves, the others stay in line at site 0 for the repair
+    EXPECT_TRUE(topology.At(0).Down());
+    EXPECT_EQ(1u, topology.At(0).Redistributed());
+    EXPECT_EQ(1u, topology.At(1).Queue.Size());
+    EXPECT_EQ(2u, topology.At(0).Queue.Size());
+    EXPECT_EQ(&topology.At(1), &v[1]->Location());
+    EXPECT_EQ(&topology.At(0), &v[2]->Location());
+    EXPECT_EQ(&topology.At(0), &v[3]->Location());
+
+    std::shared_ptr<Vehicle> out;
+    ASSERT_TRUE(topology.At(0).Queue.try_dequeue(out));
+    EXPECT_EQ(2, out->ID());
+    ASSERT_TRUE(topology.At(0).Queue.try_dequeue(out));
+    EXPECT_EQ(3, out->ID());
+
+    c0.Stop();
+}
+
+TEST_F (TopologyTest, JoinDownSite) 
+{ 
+    SimulationContext context;
+    Topology topology(2, 10.0f);
+    topology.AssignChargingSites(2);
+    topology.At(0).AddCharger();
+    topology.At(1).AddCharger();
+
+    // The last charger of site 0 goes down after the vehicle found it in
+    // service, the queue turns the vehicle away
+    auto v = Vehicle::Create(VehicleType::A, 0, topology.At(0), context);
+    EXPECT_TRUE(topology.At(0).ChargerDown());
+    EXPECT_FALSE(topology.At(0).Join(v));
+    EXPECT_EQ(0u, topology.At(0).Queue.Size());
+
+    // Without a site in service the vehicle waits for the repair
+    EXPECT_TRUE(topology.At(1).ChargerDown());
+    EXPECT_TRUE(topology.At(0).Join(v));
+    EXPECT_EQ(1u, topology.At(0).Queue.Size());
+}
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SimulationContext.h"
+#include "StopWatch.h"
+#include "Topology.h"
+#include "TypeStats.h"
+#include "Vehicle.h"
+
+class TypeStatsTest: public ::testing::Test
+{
+    public:
+        TypeStatsTest( ) {
+            // initialization code here"
+        }
+
+        void SetUp( ) {
+            // code here will execute just before the test ensues
+        }
+
+        void TearDown( ) {
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~TypeStatsTest( )  {
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Stops a StopWatch as if it had run for ms.
+         */
+        static void Lap(StopWatch& watch, int64_t ms)
+        {
+            watch.Restore(watch.Total(), true, std::chrono::milliseconds(ms));
+            watch.Tok();
+        }
+};
+
+TEST_F (TypeStatsTest, Record)
+{
+    TypeStats stats(3);
+    EXPECT_EQ(4u, stats.Shards());
+
+    TypeStatTotals none = stats.Totals(1, CHARGE_STAT);
+    EXPECT_EQ(0, none.count);
+    EXPECT_EQ(0, none.min_ms);
+
+    stats.Record(1, CHARGE_STAT, 2, 2500);
+    stats.Record(1, CHARGE_STAT, 0, 400);
+    stats.Record(1, QING_STAT, 9, 9000);
+    stats.AddTotal(1, CHARGE_STAT, 5);
+
+    TypeStatTotals t = stats.Totals(1, CHARGE_STAT);
+    EXPECT_EQ(2, t.count);
+    EXPECT_EQ(7, t.total_secs);
+    EXPECT_EQ(400, t.min_ms);
+    EXPECT_EQ(2500, t.max_ms);
+    EXPECT_EQ(1, stats.Totals(1, QING_STAT).count);
+}
+
+TEST_F (TypeStatsTest, Threads)
+{
+    TypeStats stats(4);
+    constexpr int THREADS = 8, RECORDS = 100000;
+
+    // Threads share the shards of their CPUs, the sums are exact
+    std::vector<std::thread> threads;
+    for(int i = 0; i < THREADS; ++i)
+    {
+        threads.emplace_back([&stats, i]() {
+            for(int r = 0; r < RECORDS; ++r)
+                stats.Record(0, CRUISE_STAT, 1, 1000 + i);
+        });
+    }
+    for(auto& thread : threads)
+        thread.join();
+
+    TypeStatTotals t = stats.Totals(0, CRUISE_STAT);
+    EXPECT_EQ(THREADS * RECORDS, t.count);
+    EXPECT_EQ(THREADS * RECORDS, t.total_secs);
+    EXPECT_EQ(1000, t.min_ms);
+    EXPECT_EQ(1000 + THREADS - 1, t.max_ms);
+}
+
+TEST_F (TypeStatsTest, MatchesFleet)
+{
+    SimulationContext context;
+    Topology topology(1);
+
+    std::vector<std::shared_ptr<Vehicle>> fleet;
+    for(uint16_t i = 0; i < 6; ++i)
+        fleet.push_back(Vehicle::Create(static_cast<VehicleType>(i % 2), i, topology.At(0), context));
+
+    auto types = context.Stats.Types();
+    ASSERT_EQ(2u, types.size());
+    EXPECT_EQ("A", types[0].second.name);
+    EXPECT_EQ(3, types[0].second.num_vehicles);
+    EXPECT_DOUBLE_EQ(4.0 * 120 / 60, types[0].second.passenger_miles_per_min);
+
+    // Each StopWatch stop is recorded for the vehicle's type
+    for(size_t i = 0; i < fleet.size(); ++i)
+    {
+        Lap(fleet[i]->CruisingTime, 1000 * i + 500);
+        Lap(fleet[i]->QingTime, 2000);
+        Lap(fleet[i]->CruisingTime, 3000);
+    }
+
+    for(auto const& [type, info] : types)
+    {
+        int64_t cruise = 0, qing = 0;
+        for(auto const& v : fleet)
+        {
+            if(v->Type() == VehicleType(type))
+            {
+                cruise += v->CruisingTime.Total();
+                qing   += v->QingTime.Total();
+            }
+        }
+
+        EXPECT_EQ(cruise, context.Stats.Totals(type, CRUISE_STAT).total_secs);
+        EXPECT_EQ(qing, context.Stats.Totals(type, QING_STAT).total_secs);
+        EXPECT_EQ(6, context.Stats.Totals(type, CRUISE_STAT).count);
+        EXPECT_EQ(0, context.Stats.Totals(type, CHARGE_STAT).count);
+    }
+}
@@ -0,0 +1,125 @@
+#include <deque>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "VehicleCohort.h"
+
+class VehicleCohortTest: public ::testing::Test 
+{ 
+    public: 
+        VehicleCohortTest( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~VehicleCohortTest( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Runs a cohort through time buckets with a pool of chargers
+         *        taking the vehicles that need charged in order.
+         */
+        template<class Kernel>
+        static void Drive(VehicleCohort& cohort, size_t num_chargers, int32_t bucket_ms, int32_t end_ms, Kernel advance)
+        {
+            std::deque<uint32_t> queue;
+            std::vector<uint32_t> needs;
+            size_t charging = 0;
+
+            for(int32_t now = bucket_ms; now <= end_ms; now += bucket_ms)
+            {
+                needs.clear();
+                size_t before = 0;
+                for(uint32_t i = 0; i < cohort.Size(); ++i)
+                    before += cohort.State(i) == CHARGING;
+
+                advance(cohort, now, needs);
+
+                size_t after = 0;
+                for(uint32_t i = 0; i < cohort.Size(); ++i)
+                    after += cohort.State(i) == CHARGING;
+                charging -= before - after;
+
+                queue.insert(queue.end(), needs.begin(), needs.end());
+                while(charging < num_chargers && !queue.empty())
+                {
+                    cohort.StartCharging(queue.front(), now);
+                    queue.pop_front();
+                    ++charging;
+                }
+            }
+        }
+};
+
+TEST_F (VehicleCohortTest, Transitions) 
+{ 
+    VehicleCohort cohort;
+    uint32_t lane = cohort.Add(1000, 500, 100.0f);
+    std::vector<uint32_t> needs;
+
+    // Flight not over yet
+    EXPECT_EQ(0u, cohort.Advance(999, needs));
+    EXPECT_EQ(CRUISING, cohort.State(lane));
+
+    // Flight ends, vehicle needs charged with an empty battery
+    EXPECT_EQ(1u, cohort.Advance(1000, needs));
+    ASSERT_EQ(1u, needs.size());
+    EXPECT_EQ(lane, needs[0]);
+    EXPECT_EQ(NEEDS_CHARGED, cohort.State(lane));
+    EXPECT_FLOAT_EQ(0.0f, cohort.Energy(lane));
+    EXPECT_EQ(1000, cohort.CruisingTotal(lane));
+
+    // Waiting for a charger is not a transition of the kernel
+    EXPECT_EQ(0u, cohort.Advance(1100, needs));
+
+    cohort.StartCharging(lane, 1200);
+    EXPECT_EQ(200, cohort.QingTotal(lane));
+    EXPECT_EQ(1700, cohort.NextEvent(lane));
+
+    // Charge ends, next flight starts when the charge ended
+    EXPECT_EQ(1u, cohort.Advance(1750, needs));
+    EXPECT_EQ(CRUISING, cohort.State(lane));
+    EXPECT_FLOAT_EQ(100.0f, cohort.Energy(lane));
+    EXPECT_EQ(500, cohort.ChargingTotal(lane));
+    EXPECT_EQ(2700, cohort.NextEvent(lane));
+}
+
+TEST_F (VehicleCohortTest, ScalarMatchesAvx2) 
+{ 
+    if(!VehicleCohort::HasAvx2())
+        GTEST_SKIP() << "AVX2 not available";
+
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int32_t> cruise(500, 5000);
+    std::uniform_int_distribution<int32_t> charge(200, 3000);
+
+    // Not a whole number of blocks, so padding lanes are exercised
+    VehicleCohort scalar;
+    for(int i = 0; i < 1003; ++i)
+        scalar.Add(cruise(gen), charge(gen), float(50 + i % 7));
+    VehicleCohort vector = scalar;
+
+    Drive(scalar, 200, 100, 60000, [](VehicleCohort& c, int32_t now, std::vector<uint32_t>& needs) { c.AdvanceScalar(now, needs); });
+    Drive(vector, 200, 100, 60000, [](VehicleCohort& c, int32_t now, std::vector<uint32_t>& needs) { c.AdvanceAvx2(now, needs); });
+
+    for(uint32_t i = 0; i < scalar.Size(); ++i)
+    {
+        ASSERT_EQ(scalar.State(i), vector.State(i));
+        ASSERT_EQ(scalar.NextEvent(i), vector.NextEvent(i));
+        ASSERT_FLOAT_EQ(scalar.Energy(i), vector.Energy(i));
+        ASSERT_EQ(scalar.CruisingTotal(i), vector.CruisingTotal(i));
+        ASSERT_EQ(scalar.ChargingTotal(i), vector.ChargingTotal(i));
+        ASSERT_EQ(scalar.QingTotal(i), vector.QingTotal(i));
+    }
+}
@@ -0,0 +1,137 @@
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "CacheLine.h"
+#include "StopWatch.h"
+
+class CacheLineBenchmark: public ::testing::Test 
+{ 
+    public: 
+        CacheLineBenchmark( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~CacheLineBenchmark( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Hardware cache miss counter of this thread and the threads
+         *        it starts (-1 when perf events are not permitted).
+         */
+        struct CacheMisses
+        {
+            CacheMisses()
+            {
+                perf_event_attr attr {};
+                attr.size           = sizeof(attr);
+                attr.type           = PERF_TYPE_HARDWARE;
+                attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+                attr.disabled       = 1;
+                attr.inherit        = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv     = 1;
+                fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+                if(fd >= 0)
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+
+            ~CacheMisses() { if(fd >= 0) close(fd); }
+
+            int64_t Read()
+            {
+                int64_t count = -1;
+                if(fd < 0)
+                    return -1;
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                if(read(fd, &count, sizeof(count)) != sizeof(count))
+                    return -1;
+                return count;
+            }
+
+            int fd;
+        };
+
+        /**
+         * @brief Vehicle thread timing flights while the charger thread
+         *        times the wait in the queue and the charge.  Every Tok()
+         *        is paired with a Tik() of the same thread.
+         */
+        static std::pair<double, int64_t> HandOff(StopWatch& cruising, StopWatch& charging, StopWatch& qing)
+        {
+            constexpr int ITERATIONS = 500000;
+
+            CacheMisses misses;
+            auto start = std::chrono::steady_clock::now();
+
+            std::thread vehicle([&]() {
+                for(int i = 0; i < ITERATIONS; ++i)
+                {
+                    cruising.Tik();
+                    cruising.Tok();
+                }
+            });
+            std::thread charger([&]() {
+                for(int i = 0; i < ITERATIONS; ++i)
+                {
+                    qing.Tik();
+                    qing.Tok();
+                    charging.Tik();
+                    charging.Tok();
+                }
+            });
+            vehicle.join();
+            charger.join();
+
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            return { elapsed.count() * 1000.0, misses.Read() };
+        }
+};
+
+TEST_F (CacheLineBenchmark, HandOff) 
+{ 
+    // Layout before the hot fields were grouped: stop watches side by side
+    struct Packed
+    {
+        StopWatch CruisingTime;
+        StopWatch ChargingTime;
+        StopWatch QingTime;
+    };
+    auto packed = std::make_unique<Packed>();
+
+    // Layout of the hot fields of a Vehicle, detached from the running
+    // statistics like the packed watches so only the layout differs
+    struct Aligned
+    {
+        alignas(CACHE_LINE_SIZE) StopWatch CruisingTime;
+        alignas(CACHE_LINE_SIZE) StopWatch ChargingTime;
+        StopWatch QingTime;
+    };
+    auto aligned = std::make_unique<Aligned>();
+
+    auto [packed_ms, packed_misses] = HandOff(packed->CruisingTime, packed->ChargingTime, packed->QingTime);
+    auto [aligned_ms, aligned_misses] = HandOff(aligned->CruisingTime, aligned->ChargingTime, aligned->QingTime);
+
+    std::cout << "Charger hand-off: packed " << packed_ms << " ms, " << packed_misses << " cache misses; "
+              << "aligned " << aligned_ms << " ms, " << aligned_misses << " cache misses"
+              << (packed_misses < 0 ? " (perf events not permitted)" : "") << std::endl;
+}
@@ -0,0 +1,44 @@
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include "CoroutineEngine.h"
+
+class CoroutineEngineBenchmark: public ::testing::Test 
+{ 
+    public: 
+        CoroutineEngineBenchmark( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~CoroutineEngineBenchmark( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+};
+
+TEST_F (CoroutineEngineBenchmark, Run)
+{
+    // A fleet far beyond a thread per vehicle, for a simulated day
+    CoroutineEngine engine(1000000, 5, 20000, 100);
+    engine.Seed(1);
+
+    auto t1 = std::chrono::steady_clock::now();
+    EXPECT_EQ(1020000u, engine.Create());
+    size_t resumes = engine.Run(24 * 60);
+    auto t2 = std::chrono::steady_clock::now();
+
+    double secs = std::chrono::duration<double>(t2 - t1).count();
+    std::cout << "1M vehicles, 1 simulated day: " << resumes << " resumes in " << secs << " s ("
+              << resumes / secs / 1e6 << " M resumes/s)" << std::endl;
+    EXPECT_GT(resumes, 1000000u);
+}
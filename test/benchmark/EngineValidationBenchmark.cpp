@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include "EngineValidation.h"
+
+class EngineValidationBenchmark: public ::testing::Test 
+{ 
+    public: 
+        EngineValidationBenchmark( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~EngineValidationBenchmark( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+};
+
+TEST_F (EngineValidationBenchmark, Validate)
+{
+    // Types B and C land and charge within the run, the speedup of each
+    // engine over the threaded engine is printed
+    EngineValidation validation(12, 3, 2);
+    const bool passed = validation.Run(45, 17);
+    validation.PrintResults();
+
+    EXPECT_TRUE(passed);
+}
@@ -0,0 +1,80 @@
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "EventScheduler.h"
+#include "TimingWheel.h"
+
+class EventSchedulerBenchmark: public ::testing::Test 
+{ 
+    public: 
+        EventSchedulerBenchmark( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~EventSchedulerBenchmark( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Flight and charge durations (ms) of the vehicle types.
+         */
+        static constexpr std::array<int64_t, 8> DURATIONS = { 12000, 20000, 36000, 48000, 60000, 75000, 100000, 120000 };
+
+        /**
+         * @brief Fills a scheduler with pending events, then pops each
+         *        event and schedules the event's next one (hold model).
+         *        Returns a checksum of the order events were popped in.
+         */
+        static uint64_t Hold(EventScheduler& scheduler, size_t pending, size_t holds, uint32_t seed)
+        {
+            std::mt19937 gen(seed);
+            std::uniform_int_distribution<size_t> pick(0, DURATIONS.size() - 1);
+
+            for(size_t i = 0; i < pending; ++i)
+                scheduler.Schedule({ int64_t(DURATIONS[pick(gen)]), uint32_t(i), 0 });
+
+            uint64_t checksum = 0;
+            ScheduledEvent e;
+            for(size_t i = 0; i < holds && scheduler.Pop(e); ++i)
+            {
+                checksum = checksum * 31 + uint64_t(e.time_ms) * 7 + e.target;
+                scheduler.Schedule({ e.time_ms + DURATIONS[pick(gen)], e.target, e.kind + 1 });
+            }
+            return checksum;
+        }
+};
+
+TEST_F (EventSchedulerBenchmark, Hold) 
+{ 
+    // 1M pending events, each popped event schedules its next one
+    constexpr size_t PENDING = 1000000;
+    constexpr size_t HOLDS   = 2000000;
+
+    HeapScheduler heap;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t heap_sum = Hold(heap, PENDING, HOLDS, 13);
+    std::chrono::duration<double> heap_time = std::chrono::steady_clock::now() - start;
+
+    TimingWheel wheel;
+    start = std::chrono::steady_clock::now();
+    uint64_t wheel_sum = Hold(wheel, PENDING, HOLDS, 13);
+    std::chrono::duration<double> wheel_time = std::chrono::steady_clock::now() - start;
+
+    std::cout << HOLDS << " holds with " << PENDING << " pending events: priority_queue "
+              << heap_time.count() * 1000.0 << " ms, timing wheel " << wheel_time.count() * 1000.0 << " ms" << std::endl;
+
+    EXPECT_EQ(heap_sum, wheel_sum);
+}
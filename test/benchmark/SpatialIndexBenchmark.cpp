@@ -0,0 +1,94 @@
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SpatialIndex.h"
+
+class SpatialIndexBenchmark: public ::testing::Test 
+{ 
+    public: 
+        SpatialIndexBenchmark( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~SpatialIndexBenchmark( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+
+        /**
+         * @brief Nearest point found by a linear scan, the reference the
+         *        index is checked against.
+         */
+        static int64_t LinearNearest(const std::vector<std::pair<float, float>>& points,
+                                     const std::vector<bool>&                    present,
+                                     float x, float y)
+        {
+            int64_t best = -1;
+            float best_d2 = std::numeric_limits<float>::max();
+            for(size_t i = 0; i < points.size(); ++i)
+            {
+                if(!present[i])
+                    continue;
+                float d2 = (points[i].first - x) * (points[i].first - x) + (points[i].second - y) * (points[i].second - y);
+                if(d2 < best_d2)
+                {
+                    best_d2 = d2;
+                    best = i;
+                }
+            }
+            return best;
+        }
+};
+
+TEST_F (SpatialIndexBenchmark, Nearest) 
+{ 
+    // 100k vehicles spread over a 200 x 200 mile region
+    constexpr size_t NUM_POINTS  = 100000;
+    constexpr size_t NUM_QUERIES = 2000;
+
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+
+    std::vector<std::pair<float, float>> points(NUM_POINTS);
+    std::vector<bool> present(NUM_POINTS, true);
+    SpatialIndex index(1.0f);
+    for(size_t i = 0; i < NUM_POINTS; ++i)
+    {
+        points[i] = { pos(gen), pos(gen) };
+        index.Insert(i, points[i].first, points[i].second);
+    }
+
+    std::vector<std::pair<float, float>> queries(NUM_QUERIES);
+    for(auto& q : queries)
+        q = { pos(gen), pos(gen) };
+
+    auto start = std::chrono::steady_clock::now();
+    int64_t linear_sum = 0;
+    for(auto const& q : queries)
+        linear_sum += LinearNearest(points, present, q.first, q.second);
+    std::chrono::duration<double> linear = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    int64_t index_sum = 0;
+    for(auto const& q : queries)
+        index_sum += index.Nearest(q.first, q.second);
+    std::chrono::duration<double> indexed = std::chrono::steady_clock::now() - start;
+
+    std::cout << NUM_QUERIES << " nearest queries over " << NUM_POINTS << " points: linear scan "
+              << linear.count() * 1000.0 << " ms, grid index " << indexed.count() * 1000.0 << " ms" << std::endl;
+
+    EXPECT_EQ(linear_sum, index_sum);
+}
@@ -0,0 +1,65 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "VehicleCohort.h"
+
+class VehicleCohortBenchmark: public ::testing::Test 
+{ 
+    public: 
+        VehicleCohortBenchmark( ) { 
+            // initialization code here"
+        } 
+
+        void SetUp( ) { 
+            // code here will execute just before the test ensues 
+        }
+
+        void TearDown( ) { 
+            // code here will be called just after the test completes
+            // ok to through exceptions from here if need be
+        }
+
+        ~VehicleCohortBenchmark( )  { 
+            // cleanup any pending stuff, but no exceptions allowed
+        }
+};
+
+TEST_F (VehicleCohortBenchmark, Advance) 
+{ 
+    // 1M vehicles, each bucket advances the few whose events fall due
+    constexpr int NUM_VEHICLES = 1000000;
+    constexpr int NUM_BUCKETS  = 50;
+
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int32_t> cruise(500, 50000);
+
+    VehicleCohort scalar;
+    for(int i = 0; i < NUM_VEHICLES; ++i)
+        scalar.Add(cruise(gen), 1000, 100.0f);
+    VehicleCohort vector = scalar;
+
+    std::vector<uint32_t> needs;
+    auto start = std::chrono::steady_clock::now();
+    size_t scalar_transitions = 0;
+    for(int b = 1; b <= NUM_BUCKETS; ++b)
+        scalar_transitions += scalar.AdvanceScalar(b * 100, needs);
+    std::chrono::duration<double> scalar_time = std::chrono::steady_clock::now() - start;
+
+    needs.clear();
+    start = std::chrono::steady_clock::now();
+    size_t vector_transitions = 0;
+    for(int b = 1; b <= NUM_BUCKETS; ++b)
+        vector_transitions += vector.Advance(b * 100, needs);
+    std::chrono::duration<double> vector_time = std::chrono::steady_clock::now() - start;
+
+    std::cout << NUM_BUCKETS << " buckets of " << NUM_VEHICLES << " vehicles: scalar "
+              << scalar_time.count() * 1000.0 << " ms, " << (VehicleCohort::HasAvx2() ? "AVX2 " : "dispatched ")
+              << vector_time.count() * 1000.0 << " ms" << std::endl;
+
+    EXPECT_EQ(scalar_transitions, vector_transitions);
+    EXPECT_GT(scalar_transitions, 0u);
+}